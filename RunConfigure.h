@@ -2,12 +2,16 @@
 #define USER_REAL_CONFIGURE
 #define USE_MPFR 0
 #define USE_DD 1
+#ifndef PORT_TYPE
 #define PORT_TYPE USE_MPFR
+#endif
 #define ORACLE 0
 #define DEBUGING 1
 #define RANGE_ACTIVE 2
 #define FULL_ACTIVE 3
+#ifndef TRANCKING_MODE
 #define TRANCKING_MODE FULL_ACTIVE
+#endif
 #define PC_COUNT 8
 #define STRINGLIZE(str) #str
 static const char *PATH_STRINGS[] = {
@@ -0,0 +1,348 @@
+/*
+Micro benchmarks of the shadow runtime: the operators of real::Real for each lvalue/rvalue combination,
+SVAR/ARR_SVAR with cache hits and misses, the shadow call stack, the value pool and the ERROR_STATE updates.
+One binary measures one configuration, PORT_TYPE and TRANCKING_MODE are given on the command line, see
+`make bench` in the makefile.
+
+    realbench [-o results.csv] [-b baseline.csv] [-t tolerance] [-f floor_ns]
+
+Every measurement is one CSV row "port,mode,benchmark,ns_per_op,noise,native_ns" appended to results.csv
+(stdout by default). ns_per_op is the median of BENCH_REPEATS runs divided by the number of runtime
+operations in the measured statement, e.g., c = (a + b) + d counts the temporary a + b and the rvalue
+overload, and noise is the median absolute deviation of the runs relative to their median. Before every
+run, a loop of plain double arithmetic is timed, native_ns is its median per iteration: the speed of the
+machine while the benchmark ran, which drifts with frequency scaling and other load.
+
+Rows of the same configuration in baseline.csv are compared with the results, after scaling the baseline
+by the ratio of the native_ns of both. A benchmark regresses if it is slower than that by more than the
+largest of
+    - the tolerance (0.25 by default) times the baseline,
+    - the floor (0.5 ns by default), below which timer resolution and code alignment dominate,
+    - BENCH_NOISE_SIGMAS times the noise of the baseline or of the results, whichever is larger,
+and if it does so again when the benchmarks are run again in a new process, up to BENCH_ATTEMPTS times in
+all. The exit status is 1 if any benchmark regresses, and results.csv only gets the rows of the last run.
+The exit status is also 1 if the baseline has no rows of the configuration, a benchmark without a baseline
+checks nothing. The baseline of the repository, bench/baseline.csv, is compared in units of the native loop,
+which carries it over between machines of similar microarchitecture; `make bench-baseline` records it again
+after an intended change of speed, or on a machine where the runtime and the native loop scale differently.
+*/
+#define PC_COUNT 4
+static const char *PATH_STRINGS[] = {"bench:1", "bench:2", "bench:3", "bench:4"};
+#include <real/EAST.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <unistd.h>
+
+#ifndef BENCH_ITERATIONS
+#define BENCH_ITERATIONS 100000
+#endif
+#ifndef BENCH_REPEATS
+#define BENCH_REPEATS 9
+#endif
+#ifndef BENCH_NOISE_SIGMAS
+#define BENCH_NOISE_SIGMAS 4
+#endif
+#ifndef BENCH_ATTEMPTS
+#define BENCH_ATTEMPTS 3
+#endif
+
+struct BenchResult
+{
+    std::string name;
+    double nsPerOp;
+    double noise;
+    double nativeNs;
+};
+
+static std::vector<BenchResult> results;
+static volatile double sink;
+
+static double median(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+template <typename F>
+double elapsed(F body)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    body(BENCH_ITERATIONS);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+// a dependency chain of plain double arithmetic, the same on every configuration
+static void native(int n)
+{
+    volatile double half = 0.5;
+    double x = half, c = 1.0;
+    for (int i = 0; i < n; i++)
+        c = c * x + x;
+    sink = c;
+}
+
+template <typename F>
+void measure(const char *name, int ops, F body)
+{
+    std::vector<double> times, natives, deviations;
+    body(BENCH_ITERATIONS / 10); // warm up the pools and the caches
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        natives.push_back(elapsed(native));
+        times.push_back(elapsed(body));
+    }
+    double m = median(times);
+    for (double t : times)
+        deviations.push_back(std::abs(t - m));
+    results.push_back({name, m / BENCH_ITERATIONS / ops, m > 0 ? median(deviations) / m : 0, median(natives) / BENCH_ITERATIONS});
+}
+
+// every statement starts with a PC as in instrumented code, which also bounds the symbolic variables of a statement
+#define BENCH(name, ops, stmt)                 \
+    measure(name, ops, [&](int n) {            \
+        for (int i = 0; i < n; i++)            \
+        {                                      \
+            PC(1 + (i & 1));                   \
+            stmt;                              \
+        }                                      \
+    })
+
+// keeps the accumulator of c op= a away from overflows and subnormals
+#define BENCH_RESET(c) if ((i & 1023) == 0) c = 1.0
+
+#define BENCH_OPERATOR(op, tag)                                  \
+    BENCH(tag "_lv_lv", 1, c = a op b);                          \
+    BENCH(tag "_rv_lv", 2, c = (a op b) op d);                   \
+    BENCH(tag "_lv_rv", 2, c = a op (b op d));                   \
+    BENCH(tag "_rv_rv", 3, c = (a op b) op (d op a));            \
+    BENCH(tag "_lv_d", 1, c = a op 1.5);                         \
+    BENCH(tag "_d_lv", 1, c = 1.5 op a);                         \
+    BENCH(tag "_rv_d", 2, c = (a op b) op 1.5);                  \
+    BENCH(tag "_d_rv", 2, c = 1.5 op (a op b));                  \
+    BENCH(tag "_assign_lv", 1, BENCH_RESET(c); c op##= a);       \
+    BENCH(tag "_assign_rv", 2, BENCH_RESET(c); c op##= (a op b)); \
+    BENCH(tag "_assign_d", 1, BENCH_RESET(c); c op##= 1.5)
+
+static void runOperators()
+{
+    SVal a = 1.25, b = 0.75, c = 0.0, d = 3.0;
+    BENCH_OPERATOR(+, "add");
+    BENCH_OPERATOR(-, "sub");
+    BENCH_OPERATOR(*, "mul");
+    BENCH_OPERATOR(/, "div");
+    BENCH("neg_lv", 1, c = -a);
+    BENCH("assign_lv", 1, c = a);
+    BENCH("assign_d", 1, c = (double)(i & 7); sink = TO_DOUBLE(c.shadow->shadowValue));
+    BENCH("less_lv_lv", 1, sink = a < b);
+    BENCH("less_rv_lv", 2, sink = (a + b) < d);
+    BENCH("equal_lv_lv", 1, sink = a == b);
+    BENCH("sqrt", 1, c = real::RealSqrt(a));
+    BENCH("exp", 1, c = real::RealExp(b));
+    BENCH("log", 1, c = real::RealLog(d));
+    BENCH("sin", 1, c = real::RealSin(a));
+    BENCH("pow", 1, c = real::RealPow(a, b));
+    sink = TO_DOUBLE(c.shadow->shadowValue);
+}
+
+static void runVariables()
+{
+    // two addresses that share a cache entry, every access to them misses the cache
+    std::vector<double> memory(2 * CACHE_SIZE, 1.0);
+    double *x = &memory[0], *y = &memory[CACHE_SIZE];
+    SVAR(*x) = 1.0;
+    SVAR(*y) = 2.0;
+    BENCH("svar_hit", 1, sink = TO_DOUBLE(SVAR(*x).shadow->shadowValue));
+    BENCH("svar_miss", 2, sink = TO_DOUBLE(SVAR(i & 1 ? *x : *y).shadow->shadowValue);
+          sink = TO_DOUBLE(SVAR(i & 1 ? *y : *x).shadow->shadowValue));
+
+    const uint length = 16;
+    double *u = &memory[1], *v = &memory[CACHE_SIZE + 1];
+    ARRDEF(u, length);
+    ARRDEF(v, length);
+    BENCH("arr_svar_hit", 1, sink = TO_DOUBLE(ARR_SVAR(u, i % length).shadow->shadowValue));
+    BENCH("arr_svar_miss", 2, sink = TO_DOUBLE(ARR_SVAR(u, i % length).shadow->shadowValue);
+          sink = TO_DOUBLE(ARR_SVAR(v, i % length).shadow->shadowValue));
+    ARRUNDEF(u, length);
+    ARRUNDEF(v, length);
+}
+
+static void runCalls()
+{
+    SVal arg = 1.0, ret = 0.0;
+    BENCH("call_push_pop", 1, PUSHCALL(1); POPCALL());
+    BENCH("call_arg_ret", 1, PUSHCALL(1); PUSHARG(0, arg); LOADPARM(0, ret, 1.0); PUSHRET(0, ret); POPRET(0, arg, 1.0));
+    BENCH("pool_get_put", 1, SVal *p = real::util::RealPool<SVal>::INSTANCE.get(); real::util::RealPool<SVal>::INSTANCE.put(p));
+}
+
+static void runErrorState()
+{
+#if TRACK_ERROR || TRACK_CONDITION
+    BENCH("pc", 1, sink = ERROR_STATE.programCounter);
+#else
+    BENCH("pc", 1, (void)0);
+#endif
+#if TRACK_ERROR
+    SVal a = 1.0;
+    BENCH("error_update", 1, ERROR_STATE.updateError(a.shadow->error, 1e-16 * (i & 7)));
+    BENCH("error_update_symbolic", 1, ERROR_STATE.updateSymbolicVarError(a.shadow->error));
+#endif
+#if TRACK_CONDITION
+    BENCH("condition_update", 1, ERROR_STATE.updateCondition(1.0 + (i & 7)));
+#endif
+}
+
+static std::string configuration()
+{
+    std::ostringstream os;
+    os << PORT_TYPE << "," << TRANCKING_MODE;
+    return os.str();
+}
+
+static void run()
+{
+    results.clear();
+    runOperators();
+    runVariables();
+    runCalls();
+    runErrorState();
+}
+
+// the rows of this configuration in the baseline, older baselines have no noise and native_ns
+static bool load(const std::string &file, std::map<std::string, BenchResult> &baseline)
+{
+    std::ifstream in(file);
+    if (!in)
+    {
+        std::cerr << "[BENCH]\tno baseline " << file << ", make bench-baseline records one\n";
+        return false;
+    }
+    std::string line, prefix = configuration() + ",";
+    while (std::getline(in, line))
+    {
+        if (line.compare(0, prefix.size(), prefix) != 0)
+            continue;
+        size_t comma = line.find(',', prefix.size());
+        if (comma == std::string::npos)
+            continue;
+        BenchResult b = {line.substr(prefix.size(), comma - prefix.size()), 0, 0, 0};
+        char *end;
+        b.nsPerOp = strtod(line.c_str() + comma + 1, &end);
+        if (*end == ',')
+            b.noise = strtod(end + 1, &end);
+        if (*end == ',')
+            b.nativeNs = atof(end + 1);
+        baseline[b.name] = b;
+    }
+    if (baseline.empty())
+    {
+        std::cerr << "[BENCH]\tno baseline of " << configuration() << " in " << file << ", make bench-baseline records one\n";
+        return false;
+    }
+    return true;
+}
+
+// the benchmarks slower than their baseline, only those among the candidates of an earlier attempt if any
+static std::set<std::string> compare(const std::map<std::string, BenchResult> &baseline, double tolerance, double floorNs,
+                                     const std::set<std::string> *candidates, bool report)
+{
+    std::set<std::string> regressions;
+    for (auto &r : results)
+    {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second.nsPerOp <= 0 || (candidates != nullptr && candidates->count(r.name) == 0))
+            continue;
+        const BenchResult &b = it->second;
+        double speed = b.nativeNs > 0 && r.nativeNs > 0 ? r.nativeNs / b.nativeNs : 1;
+        double expected = b.nsPerOp * speed;
+        double allowed = std::max({tolerance * expected, floorNs, BENCH_NOISE_SIGMAS * std::max(b.noise, r.noise) * expected});
+        if (r.nsPerOp - expected <= allowed)
+            continue;
+        regressions.insert(r.name);
+        if (report)
+            std::cerr << "[BENCH]\tREGRESSION " << configuration() << "," << r.name << ": " << r.nsPerOp << " ns/op, baseline "
+                      << b.nsPerOp << " ns/op scaled to " << expected << " (+" << (r.nsPerOp / expected - 1) * 100
+                      << "%, allowed +" << allowed << " ns/op)\n";
+    }
+    return regressions;
+}
+
+int main(int argc, char **argv)
+{
+    std::string output, baseline;
+    double tolerance = 0.25, floorNs = 0.5;
+    int attempt = 1;
+    std::set<std::string> candidates;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string opt = argv[i];
+        if (opt == "-o")
+            output = argv[i + 1];
+        else if (opt == "-b")
+            baseline = argv[i + 1];
+        else if (opt == "-t")
+            tolerance = atof(argv[i + 1]);
+        else if (opt == "-f")
+            floorNs = atof(argv[i + 1]);
+        else if (opt == "-a") // internal: the attempt and the regressions of the previous one
+            attempt = atoi(argv[i + 1]);
+        else if (opt == "-c")
+        {
+            std::istringstream names(argv[i + 1]);
+            std::string name;
+            while (std::getline(names, name, ','))
+                candidates.insert(name);
+        }
+    }
+
+    run();
+    std::map<std::string, BenchResult> reference;
+    std::set<std::string> regressions;
+    bool loaded = !baseline.empty() && load(baseline, reference);
+    if (loaded)
+    {
+        regressions = compare(reference, tolerance, floorNs, attempt == 1 ? nullptr : &candidates, attempt == BENCH_ATTEMPTS);
+        // a regression has to show up in every attempt, each in a new process: besides bursts of load, the layout
+        // of a process in memory (ASLR) alone can slow down some benchmarks by half for its whole run
+        if (!regressions.empty() && attempt < BENCH_ATTEMPTS)
+        {
+            std::vector<std::string> args = {argv[0]};
+            for (int i = 1; i + 1 < argc; i += 2)
+            {
+                if (std::string(argv[i]) != "-a" && std::string(argv[i]) != "-c")
+                    args.insert(args.end(), {argv[i], argv[i + 1]});
+            }
+            std::string names;
+            for (auto &name : regressions)
+                names += (names.empty() ? "" : ",") + name;
+            args.insert(args.end(), {"-a", std::to_string(attempt + 1), "-c", names});
+            std::vector<char *> next;
+            for (auto &arg : args)
+                next.push_back(&arg[0]);
+            next.push_back(nullptr);
+            execv("/proc/self/exe", next.data());
+            execv(argv[0], next.data());
+            std::cerr << "[BENCH]\tcannot run " << argv[0] << " again\n";
+        }
+    }
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output, std::ios::app);
+        file.seekp(0, std::ios::end);
+    }
+    std::ostream &os = output.empty() ? std::cout : file;
+    if (os.tellp() <= 0)
+        os << "port,mode,benchmark,ns_per_op,noise,native_ns\n";
+    for (auto &r : results)
+        os << configuration() << "," << r.name << "," << r.nsPerOp << "," << r.noise << "," << r.nativeNs << "\n";
+    return regressions.empty() && (baseline.empty() || loaded) ? 0 : 1;
+}
@@ -75,15 +75,20 @@ int main(int argc, const char **argv)
     outfile << "#ifndef USER_REAL_CONFIGURE\n";
     outfile << "#define USER_REAL_CONFIGURE\n";
 
+    // PORT_TYPE and TRANCKING_MODE can be given on the command line, e.g. by test/corpus/corpus.py
     outfile << "#define USE_MPFR 0\n"
             << "#define USE_DD 1\n"
-            << "#define PORT_TYPE USE_MPFR\n";
+            << "#ifndef PORT_TYPE\n"
+            << "#define PORT_TYPE USE_MPFR\n"
+            << "#endif\n";
     
     outfile <<"#define ORACLE 0\n"
             <<"#define DEBUGING 1\n"
             <<"#define RANGE_ACTIVE 2\n"
             <<"#define FULL_ACTIVE 3\n"
-            <<"#define TRANCKING_MODE FULL_ACTIVE\n";
+            <<"#ifndef TRANCKING_MODE\n"
+            <<"#define TRANCKING_MODE FULL_ACTIVE\n"
+            <<"#endif\n";
 
 
 
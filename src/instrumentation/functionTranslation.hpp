@@ -19,9 +19,26 @@ struct FunctionTranslationStrategy
     void buildFunctionAbstraction()
     {
         abstractedFunctions.clear();
-        abstractedFunctions["pow"] = "real::RealPow";
-        abstractedFunctions["exp"] = "real::RealExp";
-        abstractedFunctions["sqrt"] = "real::RealSqrt";
+        static const char *mathFunctions[][2] = {
+            {"pow", "real::RealPow"}, {"exp", "real::RealExp"}, {"sqrt", "real::RealSqrt"},
+            {"log", "real::RealLog"}, {"log10", "real::RealLog10"}, {"log2", "real::RealLog2"},
+            {"log1p", "real::RealLog1p"}, {"expm1", "real::RealExpm1"},
+            {"sin", "real::RealSin"}, {"cos", "real::RealCos"}, {"tan", "real::RealTan"},
+            {"asin", "real::RealAsin"}, {"acos", "real::RealAcos"}, {"atan", "real::RealAtan"},
+            {"atan2", "real::RealAtan2"},
+            {"sinh", "real::RealSinh"}, {"cosh", "real::RealCosh"}, {"tanh", "real::RealTanh"},
+            {"asinh", "real::RealAsinh"}, {"acosh", "real::RealAcosh"}, {"atanh", "real::RealAtanh"},
+            {"fabs", "real::RealFabs"}, {"floor", "real::RealFloor"}, {"ceil", "real::RealCeil"},
+            {"trunc", "real::RealTrunc"}, {"round", "real::RealRound"},
+            {"fmod", "real::RealFmod"}, {"fmin", "real::RealFmin"}, {"fmax", "real::RealFmax"},
+            {"hypot", "real::RealHypot"}, {"cbrt", "real::RealCbrt"},
+            {"erf", "real::RealErf"}, {"erfc", "real::RealErfc"},
+        };
+        for(auto &f : mathFunctions)
+        {
+            abstractedFunctions[f[0]] = f[1];
+            abstractedFunctions[std::string(f[0]) + "f"] = f[1]; // float variants, e.g. expf
+        }
     }
 
     bool isTranslated(const clang::FunctionDecl* Func, const clang::SourceManager *Manager)
@@ -0,0 +1,141 @@
+#ifndef SELECTION_POLICY
+#define SELECTION_POLICY
+
+#include <map>
+#include <string>
+#include <fstream>
+#include <clang/Lex/Lexer.h>
+#include "../transformer/transformer.hpp"
+
+// profile-guided selection of the statements to shadow, from profiles of real/PcProfile.hpp
+struct SelectionPolicy
+{
+    struct PcRecord
+    {
+        uint64_t count;
+        double maxRelativeError; // < 0 if no shadow value was assigned at this PC
+    };
+
+    std::map<int64_t, PcRecord> records;
+    uint64_t hotCount;
+    double errorBound;
+    bool enabled;
+
+    SelectionPolicy() : hotCount(0), errorBound(0), enabled(false) {}
+
+    // counts from a counting run, errors from an instrumented run; either file may be empty
+    bool load(const std::string &countFile, const std::string &errorFile, uint64_t hot, double bound)
+    {
+        hotCount = hot;
+        errorBound = bound;
+        if (!errorFile.empty() && !read(errorFile, true))
+            return false;
+        if (!countFile.empty() && !read(countFile, false))
+            return false;
+        enabled = true;
+        return true;
+    }
+
+    bool read(const std::string &filename, bool withErrors)
+    {
+        std::ifstream in(filename);
+        if (!in)
+        {
+            llvm::errs() << "cannot read profile " << filename << "\n";
+            return false;
+        }
+        int64_t pc;
+        uint64_t count;
+        double error;
+        while (in >> pc >> count >> error)
+        {
+            auto it = records.find(pc);
+            if (it == records.end())
+            {
+                records[pc] = {count, withErrors ? error : -1};
+                continue;
+            }
+            it->second.count = count; // the counting run has the final say on counts
+            if (withErrors)
+                it->second.maxRelativeError = error;
+        }
+        return true;
+    }
+
+    bool isCold(int64_t pc) const
+    {
+        auto it = records.find(pc);
+        return it == records.end() || it->second.count < hotCount;
+    }
+
+    bool isErrorFree(int64_t pc) const
+    {
+        auto it = records.find(pc);
+        return it != records.end() && it->second.maxRelativeError >= 0 && it->second.maxRelativeError <= errorBound;
+    }
+
+    // hot and error-free: shadowing it costs the most and reveals nothing
+    bool isNative(int64_t pc) const
+    {
+        return enabled && pc >= 0 && !isCold(pc) && isErrorFree(pc);
+    }
+
+    void report(llvm::raw_ostream &os) const
+    {
+        os << "hot error-free PCs (native):";
+        for (auto &r : records)
+        {
+            if (isNative(r.first))
+                os << " " << r.first;
+        }
+        os << "\ncold PCs (shadowed):";
+        for (auto &r : records)
+        {
+            if (isCold(r.first))
+                os << " " << r.first;
+        }
+        os << "\n";
+    }
+
+    // id of the last PC(id) annotation before stmt among the statements of block, -1 if none
+    static int64_t annotatedPC(const clang::CompoundStmt *block, const clang::Stmt *stmt, const clang::ASTContext &context)
+    {
+        int64_t pc = -1;
+        for (const clang::Stmt *child : block->body())
+        {
+            if (child == stmt)
+                break;
+            int64_t id = annotationOf(child, context);
+            if (id >= 0)
+                pc = id;
+        }
+        return pc;
+    }
+
+    // id of a statement that is exactly PC(id) in the source, the macro of real/ShadowExecution.hpp or a call,
+    // read from its tokens: comments, strings and identifiers that end in PC never match
+    static int64_t annotationOf(const clang::Stmt *stmt, const clang::ASTContext &context)
+    {
+        const clang::SourceManager &manager = context.getSourceManager();
+        clang::CharSourceRange range = manager.getExpansionRange(stmt->getSourceRange());
+        if (range.isInvalid())
+            return -1;
+        llvm::StringRef text = clang::Lexer::getSourceText(range, manager, context.getLangOpts());
+        clang::Lexer lexer(range.getBegin(), context.getLangOpts(), text.begin(), text.begin(), text.end());
+        clang::Token tokens[5];
+        int n = 0;
+        for (bool last = false; !last && n < 5; n++)
+            last = lexer.LexFromRawLexer(tokens[n]);
+        if (n > 0 && tokens[n - 1].is(clang::tok::eof))
+            n--;
+        int64_t id;
+        if (n != 4 || !tokens[0].is(clang::tok::raw_identifier) || tokens[0].getRawIdentifier() != "PC" ||
+            !tokens[1].is(clang::tok::l_paren) || !tokens[2].is(clang::tok::numeric_constant) ||
+            !tokens[3].is(clang::tok::r_paren) ||
+            llvm::StringRef(tokens[2].getLiteralData(), tokens[2].getLength()).getAsInteger(10, id))
+            return -1;
+        return id;
+    }
+};
+
+#endif
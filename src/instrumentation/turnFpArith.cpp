@@ -1,9 +1,11 @@
 #include <string>
 #include <set>
+#include <algorithm>
 #include "../util/random.h"
 #include "../transformer/transformer.hpp"
 #include "../transformer/analysis.hpp"
 #include "functionTranslation.hpp"
+#include "selectionPolicy.hpp"
 
 #define __LITTLE_ENDIAN
 
@@ -13,6 +15,15 @@ using namespace clang::driver;
 using namespace clang::tooling;
 
 static llvm::cl::OptionCategory ScDebugTool("ScDebug Tool");
+static llvm::cl::opt<bool> EmbeddedShadow("embedded-shadow", llvm::cl::desc("Access shadows of record fields through slots embedded by turnFpStruct -embedded-shadow"), llvm::cl::cat(ScDebugTool));
+static llvm::cl::opt<bool> LazyEval("lazy", llvm::cl::desc("Shadow arithmetic assignments with one real::lazy expression tree each"), llvm::cl::cat(ScDebugTool));
+static llvm::cl::opt<bool> JitSites("jit", llvm::cl::desc("Shadow arithmetic assignments with EAST_JIT sites, which are compiled when hot (SHADOW_JIT)"), llvm::cl::cat(ScDebugTool));
+static llvm::cl::opt<std::string> ProfileFile("profile", llvm::cl::desc("PC profile of a counting run (PC_PROFILE); hot statements that are error-free in -error-profile are left native"), llvm::cl::value_desc("file"), llvm::cl::cat(ScDebugTool));
+static llvm::cl::opt<std::string> ErrorProfileFile("error-profile", llvm::cl::desc("PC profile of an instrumented run (PC_PROFILE) with the maximal relative error of each PC"), llvm::cl::value_desc("file"), llvm::cl::cat(ScDebugTool));
+static llvm::cl::opt<unsigned> HotCount("hot-count", llvm::cl::desc("Executions from which a profiled PC is hot"), llvm::cl::init(1000), llvm::cl::cat(ScDebugTool));
+static llvm::cl::opt<double> ErrorBound("error-bound", llvm::cl::desc("Maximal relative error of a profiled PC that is error-free"), llvm::cl::init(1e-15), llvm::cl::cat(ScDebugTool));
+static llvm::cl::opt<bool> SliceToSinks("slice-to-sinks", llvm::cl::desc("Leave native the arithmetic that cannot reach EAST_* checks, fp calls, fp branch conditions or returned values"), llvm::cl::cat(ScDebugTool));
+static llvm::cl::opt<bool> FuseFma("fuse-fma", llvm::cl::desc("Shadow a*b+c, a*b-c and c-a*b with one fused real operation"), llvm::cl::init(true), llvm::cl::cat(ScDebugTool));
 
 #define PREFIX_LOCAL "__LOCAL_"
 #define PREFIX_SHARED "__SHARED_"
@@ -81,11 +92,12 @@ auto fpArg = expr(anyOf(
 auto fpCallArg = callExpr(isExpansionInMainFile(), callee(fpFunc.bind("callee")), forEachArgumentWithParam(fpArg.bind("arg"), parmVarDecl(hasType(fpType)).bind("parm"))).bind("call");
 
 // four types:  assignment of arith expr, assignment of fpcall, fpcall, fpinc
-auto stmtToBeConverted = compoundStmt(isExpansionInMainFile(), forEach(stmt(anyOf(fpInc, fpAssignFpCall, fpAssignFpExpr, callFpFunc)).bind("stmt")));
+auto stmtToBeConverted = compoundStmt(isExpansionInMainFile(), forEach(stmt(anyOf(fpInc, fpAssignFpCall, fpAssignFpExpr, callFpFunc)).bind("stmt"))).bind("block");
 // auto fpVarDefWithCallInitializer = declStmt(forEach(varDecl(hasType(fpType), hasInitializer(callFpFunc.bind("init"))).bind("var"))).bind("declStmt");
 
 auto fpDynArrVarDef_new = cxxNewExpr(isExpansionInMainFile(), hasType(pointerType(pointee(fpType))), hasArraySize(expr().bind("size"))).bind("alloc");
 auto fpDynArrVarDef_malloc = explicitCastExpr(isExpansionInMainFile(), hasDestinationType(pointerType(pointee(fpType))), hasSourceExpression(callExpr(callee(functionDecl(hasName("malloc"))), hasArgument(0, expr().bind("size"))))).bind("alloc");
+auto fpDynArrVarRedef_realloc = explicitCastExpr(isExpansionInMainFile(), hasDestinationType(pointerType(pointee(fpType))), hasSourceExpression(callExpr(callee(functionDecl(hasName("realloc"))), hasArgument(0, expr().bind("pointer")), hasArgument(1, expr().bind("size"))))).bind("alloc");
 auto fpDynArrVarUndef_delete = cxxDeleteExpr(isExpansionInMainFile(), hasDescendant(declRefExpr(to(varDecl(hasType(pointerType(pointee(fpType)))))).bind("pointer"))).bind("free");
 auto fpDynArrVarUndef_free = callExpr(isExpansionInMainFile(), callee(functionDecl(hasName("free"))), hasArgument(0, expr(hasType(pointerType(pointee(fpType)))).bind("pointer"))).bind("free");;
 
@@ -123,11 +135,17 @@ struct AllocSite
 {
     const Expr* size;
     const Expr* alloc;
+    const Expr* pointer; // the reallocated pointer, null for fresh allocations
     SourceRange rangeInFile;
     bool isNew;
+    std::string elemType;
+    int64_t elemSize;
 
-    AllocSite(const Expr* a, const Expr* s, SourceManager& manager) : alloc(a), size(s), rangeInFile(manager.getFileLoc(a->getBeginLoc()), manager.getFileLoc(a->getEndLoc())) {
+    AllocSite(const Expr* a, const Expr* s, const Expr* p, SourceManager& manager, ASTContext& context) : alloc(a), size(s), pointer(p), rangeInFile(manager.getFileLoc(a->getBeginLoc()), manager.getFileLoc(a->getEndLoc())) {
         isNew = isa<CXXNewExpr>(a);
+        QualType pointee = a->getType()->getPointeeType().getUnqualifiedType();
+        elemType = pointee.getAsString();
+        elemSize = context.getTypeSizeInChars(pointee).getQuantity();
     }
 };
 
@@ -144,9 +162,9 @@ struct DynArrRecord
     std::vector<AllocSite> allocSites;
     std::vector<FreeSite> freeSites;
 
-    void logAlloc(const Expr* a, const Expr *s, SourceManager& manager)
+    void logAlloc(const Expr* a, const Expr *s, const Expr *p, SourceManager& manager, ASTContext& context)
     {
-        allocSites.push_back(AllocSite(a, s, manager));
+        allocSites.push_back(AllocSite(a, s, p, manager, context));
     }
 
     void logFree(const Expr* a, const Expr *s, SourceManager& manager)
@@ -864,13 +882,15 @@ public:
     };
 
 private:
-    FpStmt(Type t, const Stmt *s, const Stmt *r = nullptr, const VarDecl *v = nullptr) : type(t), fpStmt(s), rhs(r), var(v) {}
+    FpStmt(Type t, const Stmt *s, const Stmt *r = nullptr, const VarDecl *v = nullptr) : type(t), fpStmt(s), rhs(r), var(v), block(nullptr), pc(-1) {}
 
 public:
     Type type;
     const Stmt *fpStmt;
     const Stmt *rhs;    // for assignment;
     const VarDecl *var; // for decl now
+    const CompoundStmt *block;
+    int64_t pc; // annotated PC, -1 if unknown
 
     static FpStmt createFpCall(const Stmt *callExp) { return FpStmt(Type::FP_CALL, callExp); }
     static FpStmt createFpAssignExpr(const Stmt *assign, const Stmt *expr) { return FpStmt(Type::FP_ASSIGNMENT, assign, expr); }
@@ -879,6 +899,113 @@ public:
     // static FpStmt createFpVarDecl(const Stmt *decl, const Stmt *call, const VarDecl *var) { return FpStmt(Type::FP_DECL_WITH_CALL, decl, call, var); }
 };
 
+// flow-insensitive backward slice of the fp statements that can affect a sink, with one variable per
+// local non-shared fp var and a single memory variable for arrays, pointers, fields and shared vars
+struct DependenceSlice
+{
+    struct Definition
+    {
+        const Stmt *stmt;   // nullptr for sinks and initializers
+        const VarDecl *var; // defined local var
+        bool defMemory;
+        std::set<const VarDecl *> uses;
+        bool usesMemory;
+        bool relevant;
+        bool propagated;
+
+        Definition(const Stmt *s, bool sink) : stmt(s), var(nullptr), defMemory(false), usesMemory(false), relevant(sink), propagated(false) {}
+    };
+
+    VarUseAnalysis &varUse;
+    std::set<const Expr *> &lFpVals;
+    std::vector<Definition> defs;
+    std::set<const VarDecl *> relevantVars;
+    bool relevantMemory;
+
+    DependenceSlice(VarUseAnalysis &v, std::set<const Expr *> &lv) : varUse(v), lFpVals(lv), relevantMemory(false) {}
+
+    void collectUses(const Stmt *S, Definition &d)
+    {
+        if (S == nullptr)
+            return;
+        if (isa<Expr>(S) && lFpVals.count((const Expr *)S) != 0)
+        {
+            d.usesMemory = true;
+            return;
+        }
+        if (isa<DeclRefExpr>(S) && isa<VarDecl>(((const DeclRefExpr *)S)->getDecl()))
+        {
+            const VarDecl *var = (const VarDecl *)((const DeclRefExpr *)S)->getDecl();
+            if (varUse.isLocalInteresting(var))
+                d.uses.insert(var);
+            else if (varUse.isSharedInteresting(var))
+                d.usesMemory = true;
+            return;
+        }
+        for (auto child : S->children())
+            collectUses(child, d);
+    }
+
+    void addSink(const Stmt *uses, bool memory = false)
+    {
+        Definition d(nullptr, true);
+        collectUses(uses, d);
+        d.usesMemory |= memory;
+        defs.push_back(d);
+    }
+
+    void addDefinition(const Stmt *stmt, const Expr *target)
+    {
+        Definition d(stmt, false);
+        target = target->IgnoreParenImpCasts();
+        const VarDecl *var = nullptr;
+        if (isa<DeclRefExpr>(target) && isa<VarDecl>(((const DeclRefExpr *)target)->getDecl()))
+            var = (const VarDecl *)((const DeclRefExpr *)target)->getDecl();
+        if (lFpVals.count(target) == 0 && var != nullptr && varUse.isLocalInteresting(var))
+            d.var = var;
+        else
+            d.defMemory = true; // also targets the analysis does not know, they are kept with memory
+        collectUses(stmt, d);
+        defs.push_back(d);
+    }
+
+    // the initializer of a var that is not fp, e.g., int k = x, takes fp values out of the slice and is a sink
+    void addInitializer(const VarDecl *var)
+    {
+        if (!var->hasInit())
+            return;
+        Definition d(nullptr, false);
+        if (varUse.isLocalInteresting(var))
+            d.var = var;
+        else if (varUse.isSharedInteresting(var))
+            d.defMemory = true;
+        else
+            d.relevant = true;
+        collectUses(var->getInit(), d);
+        defs.push_back(d);
+    }
+
+    void compute()
+    {
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (auto &d : defs)
+            {
+                if (!d.relevant)
+                    d.relevant = (d.var != nullptr && relevantVars.count(d.var) != 0) || (d.defMemory && relevantMemory);
+                if (!d.relevant || d.propagated)
+                    continue;
+                d.propagated = true;
+                changed = true;
+                relevantVars.insert(d.uses.begin(), d.uses.end());
+                relevantMemory |= d.usesMemory;
+            }
+        }
+    }
+};
+
 struct BitwiseAssignment
 {
     enum Mode
@@ -904,6 +1031,7 @@ protected:
     CallSites callSites;
     DynArrRecord dynArrRecord;
     FunctionTranslationStrategy* funcStrategy;
+    const SelectionPolicy *selection;
 
 
     const SourceManager *manager;
@@ -918,12 +1046,263 @@ protected:
         VarUseAnalysis &varUse;
         std::set<const Expr *> &lFpVals;
 
-        RealVarPrinterHelper(VarUseAnalysis &v, std::set<const Expr *> &lv) : varUse(v), lFpVals(lv) {}
+        const SourceManager *manager;
+
+        bool lazy; // print shadowed leaves as real::lazy views
+
+        RealVarPrinterHelper(VarUseAnalysis &v, std::set<const Expr *> &lv, const SourceManager *m = nullptr) : varUse(v), lFpVals(lv), manager(m), lazy(false) {}
+
+        bool isShadowed(const Expr *E)
+        {
+            if (lFpVals.count(E) != 0)
+                return true;
+            if (isa<DeclRefExpr>(E) && isa<VarDecl>(((const DeclRefExpr *)E)->getDecl()))
+            {
+                VarDecl *varDecl = (VarDecl *)((const DeclRefExpr *)E)->getDecl();
+                return varUse.isLocalInteresting(varDecl) || varUse.isSharedInteresting(varDecl);
+            }
+            return false;
+        }
+
+        static bool containsFp(const Stmt *S)
+        {
+            if (isa<Expr>(S) && ((const Expr *)S)->getType()->isRealFloatingType())
+                return true;
+            for (auto child : S->children())
+            {
+                if (child != nullptr && containsFp(child))
+                    return true;
+            }
+            return false;
+        }
+
+        // +,-,*,/ trees over shadowed leaves, fp literals and subexpressions without fp values
+        bool isLazyTree(const Expr *E, int &leaves, int &ops)
+        {
+            E = E->IgnoreParens();
+            if (isShadowed(E))
+            {
+                leaves++;
+                return true;
+            }
+            if (!E->getType()->isRealFloatingType())
+                return !containsFp(E);
+            if (isa<FloatingLiteral>(E))
+                return true;
+            if (isa<ImplicitCastExpr>(E))
+                return isLazyTree(((const ImplicitCastExpr *)E)->getSubExpr(), leaves, ops);
+            if (isa<BinaryOperator>(E))
+            {
+                const BinaryOperator *op = (const BinaryOperator *)E;
+                switch (op->getOpcode())
+                {
+                case BO_Add:
+                case BO_Sub:
+                case BO_Mul:
+                case BO_Div:
+                    ops++;
+                    return isLazyTree(op->getLHS(), leaves, ops) && isLazyTree(op->getRHS(), leaves, ops);
+                default:
+                    return false;
+                }
+            }
+            if (isa<UnaryOperator>(E))
+            {
+                const UnaryOperator *op = (const UnaryOperator *)E;
+                if (op->getOpcode() != UO_Minus && op->getOpcode() != UO_Plus)
+                    return false;
+                ops++;
+                return isLazyTree(op->getSubExpr(), leaves, ops);
+            }
+            return false;
+        }
+
+        // lhs op= rhs with a shadowed lhs and a tree rhs; op is 0 for plain assignments
+        bool isTreeAssignment(const BinaryOperator *assign, char &op)
+        {
+            int leaves = 0, ops = 0;
+            if (!isShadowed(assign->getLHS()->IgnoreParens()) || !isLazyTree(assign->getRHS(), leaves, ops) || leaves == 0 || ops == 0)
+                return false;
+            switch (assign->getOpcode())
+            {
+            case BO_Assign:
+                op = 0;
+                return true;
+            case BO_AddAssign:
+                op = '+';
+                return true;
+            case BO_SubAssign:
+                op = '-';
+                return true;
+            case BO_MulAssign:
+                op = '*';
+                return true;
+            case BO_DivAssign:
+                op = '/';
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // lhs op= rhs => real::lazy::assign(lhs, tree), or an empty string if eager code is needed
+        std::string printLazyAssignment(const BinaryOperator *assign)
+        {
+            char op;
+            if (!isTreeAssignment(assign, op))
+                return "";
+            std::string target = print(assign->getLHS()->IgnoreParens(), this);
+            lazy = true;
+            std::string tree = print(assign->getRHS(), this);
+            lazy = false;
+            if (op != 0)
+                tree = "real::lazy::view(" + target + ") " + op + " (" + tree + ")";
+            return "real::lazy::assign(" + target + ", " + tree + ")";
+        }
+
+        static int operandIndex(std::vector<std::string> &operands, const std::string &code)
+        {
+            for (size_t i = 0; i < operands.size(); i++)
+            {
+                if (operands[i] == code)
+                    return (int)i;
+            }
+            operands.push_back(code);
+            return (int)operands.size() - 1;
+        }
+
+        // postfix program of a tree accepted by isLazyTree, see real/ShadowJit.hpp
+        void buildJitProgram(const Expr *E, std::string &program, std::vector<std::string> &leaves, std::vector<std::string> &doubles)
+        {
+            E = E->IgnoreParens();
+            if (isShadowed(E))
+            {
+                program += " l" + std::to_string(operandIndex(leaves, print(E, this)));
+            }
+            else if (!E->getType()->isRealFloatingType() || isa<FloatingLiteral>(E))
+            {
+                program += " d" + std::to_string(operandIndex(doubles, print(E)));
+            }
+            else if (isa<ImplicitCastExpr>(E))
+            {
+                buildJitProgram(((const ImplicitCastExpr *)E)->getSubExpr(), program, leaves, doubles);
+            }
+            else if (isa<BinaryOperator>(E))
+            {
+                const BinaryOperator *op = (const BinaryOperator *)E;
+                buildJitProgram(op->getLHS(), program, leaves, doubles);
+                buildJitProgram(op->getRHS(), program, leaves, doubles);
+                program += " " + op->getOpcodeStr().str();
+            }
+            else if (isa<UnaryOperator>(E))
+            {
+                const UnaryOperator *op = (const UnaryOperator *)E;
+                buildJitProgram(op->getSubExpr(), program, leaves, doubles);
+                if (op->getOpcode() == UO_Minus)
+                    program += " n";
+            }
+        }
+
+        static std::string join(const std::vector<std::string> &operands)
+        {
+            std::string s;
+            for (size_t i = 0; i < operands.size(); i++)
+                s += (i == 0 ? "" : ", ") + operands[i];
+            return s;
+        }
+
+        // lhs op= rhs => EAST_JIT(lhs, "program", JIT_LEAVES(...), JIT_DOUBLES(...)), or an empty string if eager code is needed
+        std::string printJitAssignment(const BinaryOperator *assign)
+        {
+            char op;
+            if (!isTreeAssignment(assign, op))
+                return "";
+            std::string program;
+            std::vector<std::string> leaves, doubles;
+            std::string target = print(assign->getLHS()->IgnoreParens(), this);
+            if (op != 0)
+                program += " l" + std::to_string(operandIndex(leaves, target));
+            buildJitProgram(assign->getRHS(), program, leaves, doubles);
+            if (op != 0)
+                program += std::string(" ") + op;
+            return "EAST_JIT(" + target + ", \"" + program.substr(1) + "\", JIT_LEAVES(" + join(leaves) + "), JIT_DOUBLES(" + join(doubles) + "))";
+        }
+
+        // fields of records instrumented by turnFpStruct -embedded-shadow carry their own shadow slots
+        const MemberExpr *embeddedField(const Expr *E)
+        {
+            if (!EmbeddedShadow || manager == nullptr || !isa<MemberExpr>(E))
+                return nullptr;
+            const MemberExpr *member = (const MemberExpr *)E;
+            if (!isa<FieldDecl>(member->getMemberDecl()))
+                return nullptr;
+            const RecordDecl *record = ((const FieldDecl *)member->getMemberDecl())->getParent();
+            if (record->isUnion() || !manager->isInMainFile(manager->getFileLoc(record->getBeginLoc())))
+                return nullptr;
+            return member;
+        }
+
+        std::string printFieldBase(const MemberExpr *member)
+        {
+            if (member->isArrow())
+                return "(*" + print(member->getBase()) + ")";
+            return print(member->getBase());
+        }
+
+        static const BinaryOperator *fpMul(const Expr *E)
+        {
+            E = E->IgnoreParens();
+            if (!isa<BinaryOperator>(E))
+                return nullptr;
+            const BinaryOperator *op = (const BinaryOperator *)E;
+            if (op->getOpcode() != BO_Mul || !op->getType()->isRealFloatingType())
+                return nullptr;
+            return op;
+        }
+
+        // a*b+c => RealFma(a,b,c), c+a*b => RealFma(a,b,c), a*b-c => RealFms(a,b,c), c-a*b => RealFnma(a,b,c)
+        bool printFused(const BinaryOperator *op, raw_ostream &OS)
+        {
+            if (!FuseFma || lazy || !op->getType()->isRealFloatingType())
+                return false;
+            if (op->getOpcode() != BO_Add && op->getOpcode() != BO_Sub)
+                return false;
+            const char *fn;
+            const BinaryOperator *mul;
+            const Expr *other;
+            if ((mul = fpMul(op->getLHS())) != nullptr)
+            {
+                fn = op->getOpcode() == BO_Add ? "real::RealFma" : "real::RealFms";
+                other = op->getRHS();
+            }
+            else if ((mul = fpMul(op->getRHS())) != nullptr)
+            {
+                fn = op->getOpcode() == BO_Add ? "real::RealFma" : "real::RealFnma";
+                other = op->getLHS();
+            }
+            else
+            {
+                return false;
+            }
+            OS << fn << "(" << print(mul->getLHS(), this) << "," << print(mul->getRHS(), this) << "," << print(other, this) << ")";
+            return true;
+        }
 
         virtual bool handledStmt(Stmt *E, raw_ostream &OS)
         {
+            if (isa<BinaryOperator>(E) && printFused((const BinaryOperator *)E, OS))
+            {
+                return true;
+            }
             if (isa<Expr>(E))
             {
+                if (lazy && isShadowed((const Expr *)E))
+                {
+                    lazy = false;
+                    OS << "real::lazy::view(" << print(E, this) << ")";
+                    lazy = true;
+                    return true;
+                }
                 if (lFpVals.count((const Expr *)E) != 0)
                 {
                     if(isa<ArraySubscriptExpr>(E))
@@ -931,7 +1310,18 @@ protected:
                         const ArraySubscriptExpr *arr = (const ArraySubscriptExpr*)E;
                         auto base = arr->getBase();
                         auto subscript = arr->getIdx();
-                        OS << "ARR_SVAR(" << print(base) << "," << print(subscript) << ")";
+                        if (auto field = embeddedField(base->IgnoreImpCasts()))
+                        {
+                            OS << "FIELD_ARR_SVAR(" << printFieldBase(field) << "," << field->getMemberDecl()->getNameAsString() << "," << print(subscript) << ")";
+                        }
+                        else
+                        {
+                            OS << "ARR_SVAR(" << print(base) << "," << print(subscript) << ")";
+                        }
+                    }
+                    else if (auto field = embeddedField((const Expr *)E))
+                    {
+                        OS << "FIELD_SVAR(" << printFieldBase(field) << "," << field->getMemberDecl()->getNameAsString() << ")";
                     }
                     else
                     {
@@ -967,6 +1357,7 @@ public:
     {
         manager = nullptr;
         scopeTree = nullptr;
+        selection = nullptr;
     }
     virtual void run(const MatchFinder::MatchResult &Result)
     {
@@ -1068,6 +1459,12 @@ public:
                         fpStatements.push_back(FpStmt::createFpAssignExpr(stmt, rhs));
                     }
                 }
+                const CompoundStmt *block = Result.Nodes.getNodeAs<CompoundStmt>("block");
+                if (block != nullptr && !fpStatements.empty() && fpStatements.back().fpStmt == stmt)
+                {
+                    fpStatements.back().block = block;
+                    fpStatements.back().pc = SelectionPolicy::annotatedPC(block, stmt, *Result.Context);
+                }
                 fillReplace(stmt, Result);
                 return;
             }
@@ -1080,7 +1477,8 @@ public:
             if(alloc!=nullptr)
             {
                 const Expr* size = Result.Nodes.getNodeAs<Expr>("size");
-                dynArrRecord.logAlloc(alloc, size, *Result.SourceManager);
+                const Expr* pt = Result.Nodes.getNodeAs<Expr>("pointer");
+                dynArrRecord.logAlloc(alloc, size, pt, *Result.SourceManager, *Result.Context);
                 fillReplace(alloc, Result);
                 return;
             } 
@@ -1102,6 +1500,8 @@ public:
                 BitwiseAssignment::Mode mode;
                 if(bitA->getType().getDesugaredType(*Result.Context).getAsString().compare("long")==0)
                     mode = BitwiseAssignment::Mode::FULL;
+                else if(fp->getType()->isSpecificBuiltinType(BuiltinType::Float))
+                    mode = BitwiseAssignment::Mode::FULL; // a float has no hi/lo words
                 else if(off!=nullptr)
                 {
 #ifdef __LITTLE_ENDIAN
@@ -1223,12 +1623,17 @@ public:
         this->funcStrategy = funcStrategy;
     }
 
+    void setSelectionPolicy(const SelectionPolicy *selection)
+    {
+        this->selection = selection;
+    }
+
     virtual void onEndOfTranslationUnit()
     {
         // std::set<const VarDecl*> staticReal;
         if (manager != nullptr)
         {
-            RealVarPrinterHelper helper(varUse, lFpVals);
+            RealVarPrinterHelper helper(varUse, lFpVals, manager);
             // std::string header;
             // llvm::raw_string_ostream header_stream(header);
 
@@ -1272,10 +1677,13 @@ public:
     {
         for(auto s : dynArrRecord.allocSites)
         {
-            int factor = s.isNew ? 1 : 8;
+            int64_t factor = s.isNew ? 1 : s.elemSize; // malloc/realloc sizes are in bytes
             std::string code;
             llvm::raw_string_ostream stream(code);
-            stream << "DYNDEF(" << print(s.size) << "/" << factor <<")";
+            if(s.pointer != nullptr)
+                stream << "DYNREDEF<" << s.elemType << ">(" << print(s.pointer) << ", " << print(s.size) << "/" << factor <<")";
+            else
+                stream << "DYNDEF<" << s.elemType << ">(" << print(s.size) << "/" << factor <<")";
             stream.flush();
             Replacement App = ReplacementBuilder::create(*manager, s.alloc , code);
             addReplacement(App);
@@ -1692,17 +2100,176 @@ protected:
         doTranslateCall(site, call, retName, oRetName, helper);
     }
 
+    static const Expr *assignedValue(const FpStmt &stmt)
+    {
+        if (stmt.type == FpStmt::Type::FP_ASSIGNMENT && isa<BinaryOperator>(stmt.fpStmt))
+            return ((const BinaryOperator *)stmt.fpStmt)->getLHS()->IgnoreParens();
+        if (stmt.type == FpStmt::Type::FP_INC && isa<UnaryOperator>(stmt.fpStmt))
+            return ((const UnaryOperator *)stmt.fpStmt)->getSubExpr()->IgnoreParens();
+        return nullptr;
+    }
+
+    bool isNative(const FpStmt &stmt)
+    {
+        return selection != nullptr && stmt.block != nullptr && assignedValue(stmt) != nullptr && selection->isNative(stmt.pc);
+    }
+
+    // whether control may leave the enclosing block from within S other than by falling through,
+    // breaks and continues of loops and switches inside S stay inside it
+    static bool mayExitBlock(const Stmt *S, bool inLoop = false, bool inSwitch = false)
+    {
+        if (isa<ReturnStmt>(S) || isa<GotoStmt>(S) || isa<IndirectGotoStmt>(S) || isa<CXXThrowExpr>(S))
+            return true;
+        if (isa<BreakStmt>(S))
+            return !inLoop && !inSwitch;
+        if (isa<ContinueStmt>(S))
+            return !inLoop;
+        if (isa<LambdaExpr>(S))
+            return false;
+        bool loop = isa<ForStmt>(S) || isa<WhileStmt>(S) || isa<DoStmt>(S) || isa<CXXForRangeStmt>(S);
+        for (auto child : S->children())
+        {
+            if (child != nullptr && mayExitBlock(child, inLoop || loop, inSwitch || isa<SwitchStmt>(S)))
+                return true;
+        }
+        return false;
+    }
+
+    // a region is a run of native statements in one block, interleaved only with statements without fp values
+    // that do not leave the block; shadows assigned in a region are reseeded from the originals with EAST_SYNC at
+    // its end, i.e., also before a break, continue, return, goto or throw after it, or right after the statement
+    // for lvalues such as a[i] whose address may change within the region
+    void doSyncNativeRegions(const std::set<const CompoundStmt *> &blocks, const std::map<const Stmt *, const Expr *> &native, RealVarPrinterHelper &helper)
+    {
+        std::map<const Stmt *, std::vector<std::string>> syncs;
+        for (auto block : blocks)
+        {
+            std::vector<const Stmt *> region;
+            auto flush = [&]() {
+                std::vector<std::string> deferred;
+                for (auto s : region)
+                {
+                    const Expr *value = native.at(s);
+                    if (!helper.isShadowed(value))
+                        continue;
+                    std::string sync = "EAST_SYNC(" + print(value, &helper) + ", " + print(value) + ")";
+                    if (!isa<DeclRefExpr>(value))
+                        syncs[s].push_back(sync);
+                    else if (std::find(deferred.begin(), deferred.end(), sync) == deferred.end())
+                        deferred.push_back(sync);
+                }
+                if (!region.empty())
+                    syncs[region.back()].insert(syncs[region.back()].end(), deferred.begin(), deferred.end());
+                region.clear();
+            };
+            for (auto child : block->body())
+            {
+                if (native.count(child) != 0)
+                    region.push_back(child);
+                else if (RealVarPrinterHelper::containsFp(child) || mayExitBlock(child))
+                    flush();
+            }
+            flush();
+        }
+
+        for (auto &s : syncs)
+        {
+            std::string code = print(s.first);
+            for (auto &sync : s.second)
+                code += ";\n" + sync;
+            Replacement App = ReplacementBuilder::create(*manager, s.first, code + "\n");
+            addReplacement(App);
+        }
+    }
+
+    // arithmetic statements outside the backward slice of the sinks, whose shadows are never read by a sink
+    void doSliceToSinks(std::set<const Stmt *> &sliced)
+    {
+        DependenceSlice slice(varUse, lFpVals);
+        for (auto stmt : fpStatements)
+        {
+            if (stmt.type == FpStmt::Type::FP_ASSIGNMENT || stmt.type == FpStmt::Type::FP_INC)
+            {
+                const Expr *target = assignedValue(stmt);
+                if (target != nullptr)
+                    slice.addDefinition(stmt.fpStmt, target);
+                else
+                    slice.addSink(stmt.fpStmt, true); // an overloaded operator or so, kept with all it reads
+                continue;
+            }
+            // calls keep their shadows: the arguments reach the callee, which may read any memory
+            const CallExpr *call = (const CallExpr *)(stmt.type == FpStmt::Type::FP_CALL ? stmt.fpStmt : stmt.rhs);
+            auto callee = call->getDirectCallee();
+            bool pseudo = callee != nullptr && callee->getNameAsString().rfind("EAST_", 0) == 0;
+            slice.addSink(call, !pseudo);
+        }
+        for (auto &item : scopeTree->stmtMap)
+        {
+            const Stmt *S = item.first;
+            if (isa<IfStmt>(S))
+                slice.addSink(((const IfStmt *)S)->getCond());
+            else if (isa<WhileStmt>(S))
+                slice.addSink(((const WhileStmt *)S)->getCond());
+            else if (isa<DoStmt>(S))
+                slice.addSink(((const DoStmt *)S)->getCond());
+            else if (isa<ForStmt>(S))
+                slice.addSink(((const ForStmt *)S)->getCond());
+            else if (isa<SwitchStmt>(S))
+                slice.addSink(((const SwitchStmt *)S)->getCond());
+            else if (isa<ReturnStmt>(S))
+                slice.addSink(((const ReturnStmt *)S)->getRetValue()); // callers may check it
+        }
+        for (auto &v : scopeTree->varDeclMap)
+            slice.addInitializer(v.first);
+        slice.compute();
+
+        int total = 0;
+        for (auto &d : slice.defs)
+        {
+            if (d.stmt == nullptr)
+                continue;
+            total++;
+            if (!d.relevant)
+                sliced.insert(d.stmt);
+        }
+        llvm::outs() << "slice to sinks: " << (total - (int)sliced.size()) << " of " << total << " arithmetic statements shadowed\n";
+    }
+
     void doTranslateRealStatements(RealVarPrinterHelper &helper)
     {
+        std::set<const Stmt *> sliced;
+        if (SliceToSinks)
+            doSliceToSinks(sliced);
+
+        std::set<const CompoundStmt *> nativeBlocks;
+        std::map<const Stmt *, const Expr *> native;
+        for (auto stmt : fpStatements)
+        {
+            if (isNative(stmt))
+            {
+                nativeBlocks.insert(stmt.block);
+                native[stmt.fpStmt] = assignedValue(stmt);
+            }
+        }
+        doSyncNativeRegions(nativeBlocks, native, helper);
+
         for (auto stmt : fpStatements)
         {
+            if (native.count(stmt.fpStmt) != 0 || sliced.count(stmt.fpStmt) != 0)
+                continue;
             switch (stmt.type)
             {
             case FpStmt::Type::FP_INC:
             case FpStmt::Type::FP_ASSIGNMENT:
             {
                 std::string originalCode = print(stmt.fpStmt);
-                std::string code = print(stmt.fpStmt, &helper);
+                std::string code;
+                if (JitSites && isa<BinaryOperator>(stmt.fpStmt))
+                    code = helper.printJitAssignment((const BinaryOperator *)stmt.fpStmt);
+                else if (LazyEval && isa<BinaryOperator>(stmt.fpStmt))
+                    code = helper.printLazyAssignment((const BinaryOperator *)stmt.fpStmt);
+                if (code.empty())
+                    code = print(stmt.fpStmt, &helper);
                 Replacement App = ReplacementBuilder::create(*manager, stmt.fpStmt, originalCode + ";\n" + code + "\n");
                 addReplacement(App);
             }
@@ -1775,6 +2342,15 @@ int main(int argc, const char **argv)
 
     handler.setFunctionStrategy(&funcStrategy);
 
+    SelectionPolicy selection;
+    if (!ProfileFile.empty() || !ErrorProfileFile.empty())
+    {
+        if (!selection.load(ProfileFile, ErrorProfileFile, HotCount, ErrorBound))
+            return 1;
+        selection.report(llvm::outs());
+        handler.setSelectionPolicy(&selection);
+    }
+
     // var use
     tool.add(fpVarDeclInFunc, handler);
     tool.add(sharedAddressVar, handler);
@@ -1801,6 +2377,7 @@ int main(int argc, const char **argv)
     // dyn arr
     tool.add(fpDynArrVarDef_new, handler);
     tool.add(fpDynArrVarDef_malloc, handler);
+    tool.add(fpDynArrVarRedef_realloc, handler);
     tool.add(fpDynArrVarUndef_delete, handler);
     tool.add(fpDynArrVarUndef_free, handler);
 
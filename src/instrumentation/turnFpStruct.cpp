@@ -11,6 +11,7 @@ using namespace clang::driver;
 using namespace clang::tooling;
 
 static llvm::cl::OptionCategory ScDebugTool("ScDebug Tool");
+static llvm::cl::opt<bool> EmbeddedShadow("embedded-shadow", llvm::cl::desc("Embed a shadow slot for each fp field into the record instead of mapping fields through VARMAP"), llvm::cl::cat(ScDebugTool));
 
 
 auto record = recordDecl(
@@ -146,7 +147,7 @@ public:
         {
             auto body = Result.Nodes.getNodeAs<CompoundStmt>("body");
             auto &consInfo = (*recordMap)[record];
-            consInfo.destructorRange = SourceRange(Result.SourceManager->getFileLoc(des->getBeginLoc()), Result.SourceManager->getFileLoc(des->getEndLoc()));
+            consInfo.destructorRange = SourceRange(Result.SourceManager->getFileLoc(body->getBeginLoc()), Result.SourceManager->getFileLoc(body->getEndLoc()));
         }
     } 
 };
@@ -156,6 +157,55 @@ class FpStructInstrumentation : public MatchHandler
 protected:
     RecordMap* recordMap;
     const std::set<std::string> *targets;
+    // embedded shadows are bound lazily on first access, so constructors are left untouched;
+    // the slots are appended to the record and released in its destructor
+    void doEmbedShadows(RecordInfo &rec, const RecordDecl *record, const MatchFinder::MatchResult &Result)
+    {
+        std::string releaseCode;
+        llvm::raw_string_ostream releaseStream(releaseCode);
+        for(auto field : rec.fields)
+        {
+            if(field.isArray)
+            {
+                releaseStream << "FIELD_ARRUNDEF(" << field.fieldName << ", " << field.size <<");\n";
+            }
+            else
+            {
+                releaseStream << "FIELD_UNDEF(" << field.fieldName << ");\n";
+            }
+        }
+        releaseStream.flush();
+
+        std::string code;
+        llvm::raw_string_ostream stream(code);
+        for(auto field : rec.fields)
+        {
+            if(field.isArray)
+            {
+                stream << "EMBEDDED_ARR_SVAL(" << field.fieldName << ", " << field.size <<");\n";
+            }
+            else
+            {
+                stream << "EMBEDDED_SVAL(" << field.fieldName << ");\n";
+            }
+        }
+
+        if(rec.destructorRange.isValid())
+        {
+            auto Rep = ReplacementBuilder::create(*Result.SourceManager, rec.destructorRange.getBegin(), 1, "{\n" + releaseCode);
+            addReplacement(Rep);
+        }
+        else if(!record->getNameAsString().empty())
+        {
+            // not virtual: a vtable would make C-style aggregates non-aggregate
+            stream << "~" << record->getNameAsString() << "() { // generated\n" << releaseCode << "}\n";
+        }
+        stream << "}";
+        stream.flush();
+        auto Rep = ReplacementBuilder::create(*Result.SourceManager, rec.endLoc, 1, code);
+        addReplacement(Rep);
+    }
+
 public:
     FpStructInstrumentation(std::map<std::string, Replacements> &r, RecordMap* m) : MatchHandler(r), recordMap(m)
     {}
@@ -171,6 +221,12 @@ public:
             bool hasCopy = false;
             bool hasMove = false;
 
+            if(EmbeddedShadow)
+            {
+                doEmbedShadows(rec, record, Result);
+                return;
+            }
+
             for(auto cInfo : consMap)
             {
                 hasCopy = cInfo.second.isCopy;
@@ -0,0 +1,439 @@
+#ifndef AFFINE_PORT_HPP
+#define AFFINE_PORT_HPP
+/*
+Affine arithmetic port. A shadow value is an affine form
+    center + sum(coeff[k] * e[id[k]]),    with all noise symbols e in [-1, 1],
+that encloses the exact result of the computation. Unlike intervals, forms keep the correlations
+between values, e.g., x - x is exactly 0 and (1 + x) - x is 1.
+  - Storage is bounded: a form has AFFINE_SYMBOLS slots, and the symbol with id i lives in slot
+    i % AFFINE_SYMBOLS. Each operation adds at most one new symbol, which bounds its rounding errors
+    (error-free transformations) and the errors of its linearization. The new symbol takes the slot of
+    the smallest term of the form and absorbs that term, so that old symbols are merged and every error
+    term keeps its correlations from then on. When two operands hold different symbols in a slot, the
+    smaller term is absorbed likewise.
+  - Slots are combined position by position without branches, so that the loops vectorize.
+  - *, /, sqrt, exp and log use min-range linearizations. The other functions fall back to the interval
+    enclosures of IntervalMath.hpp.
+All bounds are rounded up, so that the enclosures stay rigorous.
+*/
+#include <iomanip>
+#include "IntervalMath.hpp"
+
+#ifndef AFFINE_SYMBOLS
+#define AFFINE_SYMBOLS 8
+#endif
+
+namespace real
+{
+    namespace affine
+    {
+        using interval::Interval;
+
+        static const int SLOTS = AFFINE_SYMBOLS;
+
+        struct AffineForm
+        {
+            double center;
+            double coeff[SLOTS];
+            uint64_t id[SLOTS]; // 0 for an empty slot
+        };
+
+        struct Symbols
+        {
+            uint64_t next;
+            static Symbols INSTANCE;
+        };
+        Symbols Symbols::INSTANCE = {0};
+
+        // a sum of at most ~2 * SLOTS + 8 non-negative terms, each rounded to nearest, rounded up
+        inline double up(double x)
+        {
+            return x == x ? x * (1 + 0x1p-46) + 0x1p-1074 : INFINITY; // inf - inf in the error terms
+        }
+
+        inline void assign(AffineForm &t, double d)
+        {
+            t.center = d;
+            for (int k = 0; k < SLOTS; k++)
+            {
+                t.coeff[k] = 0;
+                t.id[k] = 0;
+            }
+        }
+
+        // sum of the magnitudes of all terms, rounded up
+        inline double rad(const AffineForm &x)
+        {
+            double s = 0;
+            for (int k = 0; k < SLOTS; k++)
+                s += std::fabs(x.coeff[k]);
+            return up(s);
+        }
+
+        inline Interval enclosure(const AffineForm &x)
+        {
+            double r = rad(x);
+            return {interval::addDown(x.center, -r), interval::addUp(x.center, r)};
+        }
+
+        // a new symbol with magnitude delta. It takes the slot of the smallest term and absorbs it, and its id is
+        // the next one that maps to that slot.
+        inline void fresh(AffineForm &t, double delta)
+        {
+            if (delta == 0)
+                return;
+            int k = 0;
+            for (int i = 1; i < SLOTS; i++)
+                k = std::fabs(t.coeff[i]) < std::fabs(t.coeff[k]) ? i : k;
+            uint64_t id = Symbols::INSTANCE.next + 1;
+            id += (uint64_t)(k + SLOTS - (int)(id % SLOTS)) % SLOTS;
+            Symbols::INSTANCE.next = id;
+            t.coeff[k] = up(delta + std::fabs(t.coeff[k]));
+            t.id[k] = id;
+        }
+
+        // the slots of a * x + b * y into t, returns the bound of the rounding errors and absorbed terms
+        inline double combineSlots(AffineForm &t, double a, const AffineForm &x, double b, const AffineForm &y)
+        {
+            double err = 0;
+            for (int k = 0; k < SLOTS; k++)
+            {
+                double cx = a * x.coeff[k], cy = b * y.coeff[k];
+                double ex = std::fma(a, x.coeff[k], -cx), ey = std::fma(b, y.coeff[k], -cy);
+                double s = cx + cy;
+                double es = interval::twoSumError(cx, cy, s);
+                bool same = x.id[k] == y.id[k];
+                bool keepX = std::fabs(cx) >= std::fabs(cy);
+                t.id[k] = same || keepX ? x.id[k] : y.id[k];
+                t.coeff[k] = same ? s : (keepX ? cx : cy);
+                err += std::fabs(ex) + std::fabs(ey) + (same ? std::fabs(es) : std::fabs(keepX ? cy : cx));
+            }
+            return err;
+        }
+
+        // t = a * x + b * y + c +- delta
+        inline void combine(AffineForm &t, double a, const AffineForm &x, double b, const AffineForm &y, double c, double delta = 0)
+        {
+            AffineForm r;
+            double err = combineSlots(r, a, x, b, y);
+            double px = a * x.center, py = b * y.center;
+            double s = px + py, u = s + c;
+            err += std::fabs(std::fma(a, x.center, -px)) + std::fabs(std::fma(b, y.center, -py));
+            err += std::fabs(interval::twoSumError(px, py, s)) + std::fabs(interval::twoSumError(s, c, u));
+            r.center = u;
+            fresh(r, up(err + delta));
+            t = r;
+        }
+
+        inline void add(AffineForm &t, const AffineForm &x, const AffineForm &y) { combine(t, 1, x, 1, y, 0); }
+        inline void sub(AffineForm &t, const AffineForm &x, const AffineForm &y) { combine(t, 1, x, -1, y, 0); }
+        inline void addD(AffineForm &t, const AffineForm &x, double d) { combine(t, 1, x, 0, x, d); }
+        inline void subFromD(AffineForm &t, double d, const AffineForm &x) { combine(t, -1, x, 0, x, d); }
+        inline void mulD(AffineForm &t, const AffineForm &x, double d) { combine(t, d, x, 0, x, 0); }
+
+        // a form with the enclosure i, where correlations are lost
+        inline void fromInterval(AffineForm &t, const Interval &i)
+        {
+            if (i.lo != i.lo || i.hi != i.hi)
+            {
+                assign(t, NAN);
+                return;
+            }
+            double c = std::isinf(i.lo) ? (std::isinf(i.hi) ? 0 : i.hi) : (std::isinf(i.hi) ? i.lo : interval::mid(i));
+            assign(t, c);
+            fresh(t, std::max(interval::addUp(c, -i.lo), interval::addUp(i.hi, -c)));
+        }
+
+        inline void mul(AffineForm &t, const AffineForm &x, const AffineForm &y)
+        {
+            AffineForm r;
+            double err = combineSlots(r, y.center, x, x.center, y);
+            double p = x.center * y.center;
+            err += std::fabs(std::fma(x.center, y.center, -p));
+            r.center = p;
+            fresh(r, up(err + rad(x) * rad(y))); // with the quadratic terms
+            t = r;
+        }
+
+        // x / d, the quotients with their exact remainders
+        inline void divD(AffineForm &t, const AffineForm &x, double d)
+        {
+            if (d == 0 || std::isinf(d))
+            {
+                fromInterval(t, interval::div(enclosure(x), interval::point(d)));
+                return;
+            }
+            AffineForm r;
+            double err = 0;
+            for (int k = 0; k < SLOTS; k++)
+            {
+                double q = x.coeff[k] / d;
+                err += std::fabs(std::fma(-q, d, x.coeff[k]));
+                r.coeff[k] = q;
+                r.id[k] = x.id[k];
+            }
+            double q = x.center / d;
+            err += std::fabs(std::fma(-q, d, x.center));
+            r.center = q;
+            fresh(r, up(up(err) / std::fabs(d)));
+            t = r;
+        }
+
+        /*
+        f(x) ~ alpha * x + zeta +- delta for f convex or concave on the enclosure [a, b] of x, where alpha is the
+        slope of f at the bound where |f'| is the smallest. Then f - alpha * x is monotone on [a, b], and
+        its range is the hull of its values at a and b, which fa and fb enclose.
+        */
+        inline void minRange(AffineForm &t, const AffineForm &x, double alpha, double a, const Interval &fa, double b, const Interval &fb)
+        {
+            Interval ga = interval::sub(fa, interval::mul(interval::point(alpha), interval::point(a)));
+            Interval gb = interval::sub(fb, interval::mul(interval::point(alpha), interval::point(b)));
+            Interval g = {std::min(ga.lo, gb.lo), std::max(ga.hi, gb.hi)};
+            double zeta = interval::mid(g);
+            double delta = std::max(interval::addUp(zeta, -g.lo), interval::addUp(g.hi, -zeta));
+            delta = up(delta + 0x1p-50 * (std::fabs(zeta) + std::fabs(alpha) * std::max(std::fabs(a), std::fabs(b)))); // slope rounding
+            combine(t, alpha, x, 0, x, zeta, delta);
+        }
+
+        inline bool finite(const Interval &i)
+        {
+            return std::isfinite(i.lo) && std::isfinite(i.hi);
+        }
+
+        inline void recip(AffineForm &t, const AffineForm &x)
+        {
+            Interval i = enclosure(x);
+            if (!finite(i) || interval::contains(i, 0))
+            {
+                fromInterval(t, interval::div(interval::point(1), i));
+                return;
+            }
+            double m = std::max(std::fabs(i.lo), std::fabs(i.hi));
+            Interval one = interval::point(1);
+            minRange(t, x, -1 / (m * m), i.lo, interval::div(one, interval::point(i.lo)), i.hi, interval::div(one, interval::point(i.hi)));
+        }
+
+        inline void div(AffineForm &t, const AffineForm &x, const AffineForm &y)
+        {
+            AffineForm r;
+            recip(r, y);
+            mul(t, x, r);
+        }
+
+        inline void divFromD(AffineForm &t, double d, const AffineForm &x)
+        {
+            AffineForm r;
+            recip(r, x);
+            mulD(t, r, d);
+        }
+
+        inline void sqrt(AffineForm &t, const AffineForm &x)
+        {
+            Interval i = enclosure(x);
+            if (!finite(i) || i.hi <= 0)
+            {
+                fromInterval(t, interval::sqrt(i));
+                return;
+            }
+            double a = std::max(i.lo, 0.0), b = i.hi;
+            minRange(t, x, 0.5 / std::sqrt(b), a, interval::sqrt(interval::point(a)), b, interval::sqrt(interval::point(b)));
+        }
+
+        inline void exp(AffineForm &t, const AffineForm &x)
+        {
+            Interval i = enclosure(x);
+            Interval e = INTERVAL_EXP(i);
+            if (!finite(i) || !finite(e))
+            {
+                fromInterval(t, e);
+                return;
+            }
+            minRange(t, x, std::exp(i.lo), i.lo, INTERVAL_EXP(interval::point(i.lo)), i.hi, INTERVAL_EXP(interval::point(i.hi)));
+        }
+
+        inline void log(AffineForm &t, const AffineForm &x)
+        {
+            Interval i = enclosure(x);
+            if (!finite(i) || i.lo <= 0)
+            {
+                fromInterval(t, INTERVAL_LOG(i));
+                return;
+            }
+            minRange(t, x, 1 / i.hi, i.lo, INTERVAL_LOG(interval::point(i.lo)), i.hi, INTERVAL_LOG(interval::point(i.hi)));
+        }
+
+        inline void pow(AffineForm &t, const AffineForm &x, const AffineForm &y)
+        {
+            if (enclosure(x).lo > 0)
+            {
+                AffineForm l;
+                log(l, x);
+                mul(l, y, l);
+                exp(t, l);
+                return;
+            }
+            fromInterval(t, interval::pow(enclosure(x), enclosure(y)));
+        }
+
+        inline void fabs(AffineForm &t, const AffineForm &x)
+        {
+            Interval i = enclosure(x);
+            if (i.lo >= 0)
+                t = x;
+            else if (i.hi <= 0)
+                mulD(t, x, -1);
+            else
+                fromInterval(t, interval::fabs(i));
+        }
+
+        inline void fma(AffineForm &t, const AffineForm &l, const AffineForm &m, const AffineForm &r)
+        {
+            AffineForm p;
+            mul(p, l, m);
+            add(t, p, r);
+        }
+
+        inline AffineForm negated(const AffineForm &x)
+        {
+            AffineForm r;
+            mulD(r, x, -1);
+            return r;
+        }
+
+        // bitwise edits of the original, see Real::reloadHigh/reloadLow, reload the form from the edited center
+        inline void copyExp(AffineForm &x, double d)
+        {
+            double c = x.center;
+            __HI(c) = __HI(d);
+            assign(x, c);
+        }
+
+        inline void clearLows(AffineForm &x)
+        {
+            double c = x.center;
+            __LO(c) = 0;
+            assign(x, c);
+        }
+
+        inline int symbols(const AffineForm &x)
+        {
+            int n = 0;
+            for (int k = 0; k < SLOTS; k++)
+                n += x.id[k] != 0;
+            return n;
+        }
+
+        template <typename F>
+        inline void viaInterval(AffineForm &t, const AffineForm &x, F f)
+        {
+            fromInterval(t, f(enclosure(x)));
+        }
+
+        template <typename F>
+        inline void viaInterval(AffineForm &t, const AffineForm &x, const AffineForm &y, F f)
+        {
+            fromInterval(t, f(enclosure(x), enclosure(y)));
+        }
+    }; // namespace affine
+};     // namespace real
+
+#define HP_TYPE real::affine::AffineForm
+
+#define ADD_RR(t, l, r) real::affine::add(t, l, r)
+#define SUB_RR(t, l, r) real::affine::sub(t, l, r)
+#define MUL_RR(t, l, r) real::affine::mul(t, l, r)
+#define DIV_RR(t, l, r) real::affine::div(t, l, r)
+
+#define ADD_RD(t, l, r) real::affine::addD(t, l, r)
+#define SUB_RD(t, l, r) real::affine::addD(t, l, -(r))
+#define SUB_DR(t, l, r) real::affine::subFromD(t, l, r)
+#define MUL_RD(t, l, r) real::affine::mulD(t, l, r)
+#define DIV_RD(t, l, r) real::affine::divD(t, l, r)
+#define DIV_DR(t, l, r) real::affine::divFromD(t, l, r)
+
+#define ASSIGN(l,r) l = r
+#define ASSIGN_D(l,r) real::affine::assign(l, r)
+#define SWAP(l,r) l = r
+
+#define INIT(r, p) real::affine::assign(r, 0)
+#define CLEAR(r) /*DO NOTHING*/
+
+#define TO_DOUBLE(r) (r).center
+
+#define SHADOW_ENCLOSURE(s) real::affine::enclosure(s)
+
+#define FMA(t, l, m, r) real::affine::fma(t, l, m, r)
+#define FMS(t, l, m, r) real::affine::fma(t, l, m, real::affine::negated(r))
+#define FNMA(t, l, m, r) real::affine::fma(t, real::affine::negated(l), m, r)
+
+#if KEEP_ORIGINAL
+#define STREAM_OUT(os, r)  {\
+    std::ios_base::fmtflags old_flags = os.flags(); \
+    std::streamsize old_prec = os.precision(19); \
+    os << std::scientific; \
+    os << "[ " << std::setw(27) << r.shadow->shadowValue.center << " +- " << real::affine::rad(r.shadow->shadowValue) << " ]"; \
+    os << " (" << real::affine::symbols(r.shadow->shadowValue) << " symbols)"; \
+    os << " (original = " << r.shadow->originalValue <<")"; \
+    os.precision(old_prec); \
+    os.flags(old_flags); \
+}
+#else
+#define STREAM_OUT(os, r)  {\
+    std::ios_base::fmtflags old_flags = os.flags(); \
+    std::streamsize old_prec = os.precision(19); \
+    os << std::scientific; \
+    os << "[ " << std::setw(27) << r.shadow->shadowValue.center << " +- " << real::affine::rad(r.shadow->shadowValue) << " ]"; \
+    os << " (" << real::affine::symbols(r.shadow->shadowValue) << " symbols)"; \
+    os.precision(old_prec); \
+    os.flags(old_flags); \
+}
+#endif
+
+#define LESS_RR(l,r) (TO_DOUBLE(l) < TO_DOUBLE(r))
+#define LESSEQ_RR(l,r) (TO_DOUBLE(l) <= TO_DOUBLE(r))
+#define EQUAL_RR(l,r) (TO_DOUBLE(l) == TO_DOUBLE(r))
+#define GREATER_RR(l,r) (TO_DOUBLE(l) > TO_DOUBLE(r))
+#define GREATEREQ_RR(l,r) (TO_DOUBLE(l) >= TO_DOUBLE(r))
+
+#define AF_I1(res, r, f) real::affine::viaInterval(res, r, [](const real::interval::Interval &x) { return f; })
+#define AF_I2(res, a, b, f) real::affine::viaInterval(res, a, b, [](const real::interval::Interval &x, const real::interval::Interval &y) { return f; })
+
+#define EXP_R(res, r) real::affine::exp(res, r)
+#define POW_RR(res, a, b) real::affine::pow(res, a, b)
+#define SQRT_R(res, r) real::affine::sqrt(res, r)
+
+// <math.h>
+#define LOG_R(res, r) real::affine::log(res, r)
+#define LOG10_R(res, r) AF_I1(res, r, INTERVAL_LOG10(x))
+#define LOG2_R(res, r) AF_I1(res, r, INTERVAL_LOG2(x))
+#define LOG1P_R(res, r) AF_I1(res, r, INTERVAL_LOG1P(x))
+#define EXPM1_R(res, r) AF_I1(res, r, INTERVAL_EXPM1(x))
+#define SIN_R(res, r) AF_I1(res, r, real::interval::sin(x))
+#define COS_R(res, r) AF_I1(res, r, real::interval::cos(x))
+#define TAN_R(res, r) AF_I1(res, r, real::interval::tan(x))
+#define ASIN_R(res, r) AF_I1(res, r, INTERVAL_ASIN(x))
+#define ACOS_R(res, r) AF_I1(res, r, INTERVAL_ACOS(x))
+#define ATAN_R(res, r) AF_I1(res, r, INTERVAL_ATAN(x))
+#define SINH_R(res, r) AF_I1(res, r, INTERVAL_SINH(x))
+#define COSH_R(res, r) AF_I1(res, r, real::interval::cosh(x))
+#define TANH_R(res, r) AF_I1(res, r, INTERVAL_TANH(x))
+#define ASINH_R(res, r) AF_I1(res, r, INTERVAL_ASINH(x))
+#define ACOSH_R(res, r) AF_I1(res, r, INTERVAL_ACOSH(x))
+#define ATANH_R(res, r) AF_I1(res, r, INTERVAL_ATANH(x))
+#define FABS_R(res, r) real::affine::fabs(res, r)
+#define FLOOR_R(res, r) AF_I1(res, r, INTERVAL_FLOOR(x))
+#define CEIL_R(res, r) AF_I1(res, r, INTERVAL_CEIL(x))
+#define TRUNC_R(res, r) AF_I1(res, r, INTERVAL_TRUNC(x))
+#define ROUND_R(res, r) AF_I1(res, r, INTERVAL_ROUND(x))
+#define CBRT_R(res, r) AF_I1(res, r, INTERVAL_CBRT(x))
+#define ERF_R(res, r) AF_I1(res, r, INTERVAL_ERF(x))
+#define ERFC_R(res, r) AF_I1(res, r, INTERVAL_ERFC(x))
+#define ATAN2_RR(res, a, b) AF_I2(res, a, b, real::interval::atan2(x, y))
+#define FMOD_RR(res, a, b) AF_I2(res, a, b, real::interval::fmod(x, y))
+#define FMIN_RR(res, a, b) AF_I2(res, a, b, real::interval::fmin(x, y))
+#define FMAX_RR(res, a, b) AF_I2(res, a, b, real::interval::fmax(x, y))
+#define HYPOT_RR(res, a, b) AF_I2(res, a, b, real::interval::hypot(x, y))
+
+#define COPY_EXP_D(res, d) real::affine::copyExp(res, d)
+#define CLEAR_LOWS(res) real::affine::clearLows(res)
+#endif
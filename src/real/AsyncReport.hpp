@@ -0,0 +1,391 @@
+#ifndef ASYNC_REPORT_HPP
+#define ASYNC_REPORT_HPP
+/*
+Formatting of the error reports of EAST_DUMP_ERROR ("[ERROR]" text or JSON lines, SHADOW_REPORT_FORMAT) and,
+with SHADOW_ASYNC_REPORT, a reporting thread that takes formatting and writing off the instrumented program.
+EAST_DUMP_ERROR then copies the shadow state into a single-producer single-consumer ring of
+SHADOW_REPORT_CAPACITY records, and EAST_DRAW_ERROR copies the reachable error graph (ErrorGraph) for the DOT file.
+The ring has no lock: the program only advances the tail and the reporting thread only advances the head.
+There is one producer: like the rest of the shadow state, the queue belongs to the thread of the first report,
+and reporting from another thread fails an assertion.
+Once the ring is full, only every Nth report is queued, N doubling up to SHADOW_REPORT_MAX_SAMPLING and halving
+again when the ring drains, and a queued report waits for a free record. The skipped reports are counted in the
+output. Reports are written in order, but not in order with what the program writes itself to the same stream:
+EAST_REPORT_FLUSH waits until everything queued is written. Link with -pthread.
+*/
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <assert.h>
+#include "RealConfigure.h"
+#include "Real.hpp"
+
+namespace real
+{
+    // copies a shadow state into one constructed by ShadowInitializer
+    inline void copyState(ShadowState &d, const ShadowState &s)
+    {
+        ASSIGN(d.shadowValue, s.shadowValue);
+#if KEEP_ORIGINAL
+        d.originalValue = s.originalValue;
+#endif
+        SET_SINGLE(d, s.single);
+#if TRACK_ERROR
+        d.error = s.error;
+#endif
+    }
+
+    // the "[ERROR]" lines of EAST_DUMP_ERROR, re is the current relative error where it is reported
+    inline void formatErrorText(std::ostream &stream, ShadowState &state, double re)
+    {
+        Real view(state);
+        stream << "[ERROR]\t" << "Shadow value is ";
+        stream << view << "\n";
+        view.shadow = nullptr; // not taken from the pool
+#if TRACK_ERROR
+        if(state.error.maxRelativeError==0)
+        {
+            stream <<"[ERROR]\t" << "MRE < 10^-16\n";
+        }
+        else
+        {
+            stream <<"[ERROR]\t" << "MRE is "<<state.error.maxRelativeError<<" ("<<state.error.maxRelativeError/ORIGINAL_ULP_OF(state)<<" ulps), caused by "<< ERROR_STATE.locationStrings[state.error.errorCausingCalculationID] <<"\n";
+        }
+        if(state.error.relativeErrorOfLastCheck==0)
+        {
+            stream <<"[ERROR]\t" << "LRE < 10^-16\n";
+        }
+        else
+        {
+            stream <<"[ERROR]\t" << "LRE is "<<state.error.relativeErrorOfLastCheck<<" ("<<state.error.relativeErrorOfLastCheck/ORIGINAL_ULP_OF(state)<<" ulps), caused by "<< ERROR_STATE.locationStrings[state.error.errorCausingCalculationIDOfLastCheck] <<"\n";
+        }
+#endif
+#if TRACK_ERROR == false || ACTIVE_TRACK_ERROR
+        if(re==0)
+        {
+            stream <<"[ERROR]\t" << "Current RE < 10^-16\n";
+        }
+        else
+        {
+            stream <<"[ERROR]\t" << "Current RE is "<<re<<" ("<<re/ORIGINAL_ULP_OF(state)<<" ulps)\n";
+        }
+#endif
+    }
+
+    namespace json
+    {
+        inline void string(std::ostream &stream, const std::string &s)
+        {
+            stream << '"';
+            for (char c : s)
+            {
+                switch (c)
+                {
+                case '"': stream << "\\\""; break;
+                case '\\': stream << "\\\\"; break;
+                case '\n': stream << "\\n"; break;
+                case '\t': stream << "\\t"; break;
+                default:
+                    if ((unsigned char)c < 0x20)
+                    {
+                        char buffer[8];
+                        snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                        stream << buffer;
+                    }
+                    else
+                        stream << c;
+                }
+            }
+            stream << '"';
+        }
+
+        // JSON has no inf and nan
+        inline void number(std::ostream &stream, double d)
+        {
+            if (std::isfinite(d))
+                stream << d;
+            else
+                stream << "null";
+        }
+    }; // namespace json
+
+    // one JSON object per line with the same fields as the text
+    inline void formatErrorJson(std::ostream &stream, ShadowState &state, double ov, double re)
+    {
+        std::ostringstream shadow;
+        Real view(state);
+        shadow << view;
+        view.shadow = nullptr;
+
+        std::streamsize old_prec = stream.precision(17);
+        stream << "{\"type\":\"error\",\"shadow\":";
+        json::string(stream, shadow.str());
+        stream << ",\"value\":";
+        json::number(stream, TO_DOUBLE(state.shadowValue));
+        stream << ",\"original\":";
+        json::number(stream, ov);
+#if TRACK_ERROR
+        stream << ",\"mre\":";
+        json::number(stream, state.error.maxRelativeError);
+        stream << ",\"mre_ulps\":";
+        json::number(stream, state.error.maxRelativeError / ORIGINAL_ULP_OF(state));
+        stream << ",\"mre_location\":";
+        json::string(stream, ERROR_STATE.locationStrings[state.error.errorCausingCalculationID]);
+        stream << ",\"lre\":";
+        json::number(stream, state.error.relativeErrorOfLastCheck);
+        stream << ",\"lre_ulps\":";
+        json::number(stream, state.error.relativeErrorOfLastCheck / ORIGINAL_ULP_OF(state));
+        stream << ",\"lre_location\":";
+        json::string(stream, ERROR_STATE.locationStrings[state.error.errorCausingCalculationIDOfLastCheck]);
+#endif
+#if TRACK_ERROR == false || ACTIVE_TRACK_ERROR
+        stream << ",\"re\":";
+        json::number(stream, re);
+        stream << ",\"re_ulps\":";
+        json::number(stream, re / ORIGINAL_ULP_OF(state));
+#endif
+        stream << "}\n";
+        stream.precision(old_prec);
+    }
+
+    inline void formatError(std::ostream &stream, ShadowState &state, double ov, double re)
+    {
+#if SHADOW_REPORT_FORMAT == REPORT_JSON
+        formatErrorJson(stream, state, ov, re);
+#else
+        formatErrorText(stream, state, re);
+#endif
+    }
+
+    inline void formatSkipped(std::ostream &stream, uint64 skipped)
+    {
+#if SHADOW_REPORT_FORMAT == REPORT_JSON
+        stream << "{\"type\":\"skipped\",\"count\":" << skipped << "}\n";
+#else
+        stream << "[REPORT]\t" << skipped << " reports skipped by sampling\n";
+#endif
+    }
+
+#if SHADOW_ASYNC_REPORT
+    class ReportQueue
+    {
+        enum Kind
+        {
+            DUMP_ERROR,
+            DRAW_ERROR
+        };
+
+        struct DrawRequest
+        {
+            std::string file;
+            std::string name;
+            ErrorGraph graph;
+        };
+
+        struct Record
+        {
+            int kind;
+            uint64 skipped; // reports skipped by sampling before this one
+            std::ostream *stream;
+            ShadowState state;
+            double original;
+            double error;
+            DrawRequest *draw;
+        };
+
+        static const uint64 CAPACITY = SHADOW_REPORT_CAPACITY;
+        static_assert((CAPACITY & (CAPACITY - 1)) == 0, "SHADOW_REPORT_CAPACITY must be a power of two");
+
+        Record *ring;
+        alignas(64) std::atomic<uint64> head;    // next record to write, advanced by the reporting thread
+        alignas(64) std::atomic<uint64> written; // records written and flushed
+        alignas(64) std::atomic<uint64> tail;    // next free record, advanced by the program
+        uint64 seen;                             // reports of the program, queued or not
+        uint64 sampling;
+        uint64 skipped;
+        std::ostream *lastStream;                // of the last dump, for the skipped ones at the end, see flush
+        std::atomic<bool> stopping;
+        std::thread worker;
+        std::thread::id producer;                // the only thread that claims and publishes records
+        bool started;
+
+    public:
+        static ReportQueue INSTANCE;
+
+        ReportQueue() : ring(nullptr), head(0), written(0), tail(0), seen(0), sampling(1), skipped(0), lastStream(nullptr), stopping(false), started(false) {}
+
+        ~ReportQueue()
+        {
+            stop();
+            if (ring != nullptr)
+            {
+                for (uint64 i = 0; i < CAPACITY; i++)
+                    ShadowInitializer().destruct(ring[i].state);
+                delete[] ring;
+                ring = nullptr;
+            }
+        }
+
+        void dumpError(std::ostream &stream, const ShadowState &state, double ov, double re)
+        {
+            lastStream = &stream;
+            Record *r = claim();
+            if (r == nullptr)
+                return;
+            r->kind = DUMP_ERROR;
+            r->stream = &stream;
+            copyState(r->state, state);
+            r->original = ov;
+            r->error = re;
+            publish();
+        }
+
+        void drawError(const std::string &file, const std::string &name, const ProgramErrorState &errors, const SymbolicVarError &root)
+        {
+            Record *r = claim();
+            if (r == nullptr)
+                return;
+            r->kind = DRAW_ERROR;
+            r->stream = nullptr;
+            r->draw = new DrawRequest{file, name, ErrorGraph(errors, root)};
+            publish();
+        }
+
+        // waits until the queued reports are written, and counts the reports skipped since the last queued one
+        void flush()
+        {
+            if (!started)
+                return;
+            uint64 t = tail.load(std::memory_order_relaxed);
+            while (written.load(std::memory_order_acquire) < t)
+                std::this_thread::yield();
+            if (skipped != 0 && lastStream != nullptr)
+            {
+                formatSkipped(*lastStream, skipped);
+                lastStream->flush();
+                skipped = 0;
+            }
+        }
+
+        void stop()
+        {
+            if (!started || stopping.load())
+                return;
+            stopping.store(true, std::memory_order_release);
+            worker.join();
+        }
+
+    private:
+        static void atExit()
+        {
+            INSTANCE.stop();
+        }
+
+        void start()
+        {
+            ring = new Record[CAPACITY];
+            for (uint64 i = 0; i < CAPACITY; i++)
+            {
+                ShadowInitializer().construct(ring[i].state);
+                ring[i].draw = nullptr;
+            }
+            started = true;
+            producer = std::this_thread::get_id();
+            worker = std::thread([this]() { run(); });
+            atexit(atExit); // registered after the static state is constructed, so the ring drains before it is destroyed
+        }
+
+        Record *claim()
+        {
+            if (real_unlikely(!started))
+                start();
+            assert(std::this_thread::get_id() == producer && "EAST_DUMP_ERROR and EAST_DRAW_ERROR from a second thread");
+            if (seen++ % sampling != 0)
+            {
+                skipped++;
+                return nullptr;
+            }
+            uint64 t = tail.load(std::memory_order_relaxed);
+            uint64 used = t - head.load(std::memory_order_acquire);
+            if (real_unlikely(used == CAPACITY))
+            {
+                if (sampling < SHADOW_REPORT_MAX_SAMPLING)
+                    sampling *= 2;
+                while (t - head.load(std::memory_order_acquire) == CAPACITY)
+                    std::this_thread::yield(); // back-pressure
+            }
+            else if (sampling > 1 && used < CAPACITY / 4)
+            {
+                sampling /= 2;
+            }
+            Record *r = &ring[t & (CAPACITY - 1)];
+            r->skipped = skipped;
+            skipped = 0;
+            return r;
+        }
+
+        void publish()
+        {
+            tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        void write(Record &r, uint64 &carried)
+        {
+            carried += r.skipped;
+            if (r.kind == DRAW_ERROR)
+            {
+                std::ofstream outfile(r.draw->file, std::ios::out | std::ios::trunc);
+                r.draw->graph.writeDot(outfile, r.draw->name);
+                delete r.draw;
+                r.draw = nullptr;
+                return;
+            }
+            if (carried != 0)
+                formatSkipped(*r.stream, carried);
+            carried = 0;
+            formatError(*r.stream, r.state, r.original, r.error);
+        }
+
+        void run()
+        {
+            std::vector<std::ostream *> streams; // written since the last flush
+            uint64 carried = 0;                  // skipped reports, counted in the next dump
+            int idle = 0;
+            while (true)
+            {
+                uint64 h = head.load(std::memory_order_relaxed);
+                if (h == tail.load(std::memory_order_acquire))
+                {
+                    for (std::ostream *s : streams)
+                        s->flush();
+                    streams.clear();
+                    written.store(h, std::memory_order_release);
+                    if (stopping.load(std::memory_order_acquire) && h == tail.load(std::memory_order_acquire))
+                        break;
+                    // spin briefly, then back off up to a millisecond
+                    if (idle < 64)
+                        std::this_thread::yield();
+                    else
+                        std::this_thread::sleep_for(std::chrono::microseconds(idle < 1024 ? idle : 1000));
+                    idle++;
+                    continue;
+                }
+                idle = 0;
+                Record &r = ring[h & (CAPACITY - 1)];
+                write(r, carried);
+                if (r.stream != nullptr && std::find(streams.begin(), streams.end(), r.stream) == streams.end())
+                    streams.push_back(r.stream);
+                head.store(h + 1, std::memory_order_release);
+            }
+        }
+    };
+    ReportQueue ReportQueue::INSTANCE;
+#endif
+}; // namespace real
+
+#endif
@@ -0,0 +1,276 @@
+#ifndef COMPACT_PORT_HPP
+#define COMPACT_PORT_HPP
+/*
+Compact port for screening runs.
+A shadow value is the double x computed as in the original program plus a short estimate e of its
+accumulated absolute error, i.e., the shadow represents x + e. Rounding errors of +,-,*,/ and sqrt are
+obtained exactly with error-free transformations, and propagated to first order. Sites flagged by
+a compact run should be confirmed with the DD port.
+With double originals kept (KEEP_ORIGINAL), x is the original itself and the shadow stores e only:
+it reads x from the original that precedes it in its ShadowState (or in a lazy Operand), at
+HP_ORIGINAL_OFFSET bytes before it. Every operation reads the originals of its operands before
+the caller updates the original of the result.
+*/
+#include <cmath>
+#include <iomanip>
+
+#ifndef COMPACT_ERROR_TYPE
+#define COMPACT_ERROR_TYPE float
+#endif
+
+// the error term is kept against the original, which has to be the double result of the operation
+#if KEEP_ORIGINAL && !ORIGINAL_WIDTHS
+#define COMPACT_ERROR_ONLY 1
+#define HP_ORIGINAL_OFFSET sizeof(double)
+#else
+#define COMPACT_ERROR_ONLY 0
+#endif
+
+namespace real
+{
+    namespace compact
+    {
+#pragma pack(push, 4)
+        struct CompactReal
+        {
+#if !COMPACT_ERROR_ONLY
+            double x;
+#endif
+            COMPACT_ERROR_TYPE e;
+        };
+#pragma pack(pop)
+
+        typedef COMPACT_ERROR_TYPE err_t;
+
+        inline double x(const CompactReal &r)
+        {
+#if COMPACT_ERROR_ONLY
+            return *(const double *)((const char *)&r - HP_ORIGINAL_OFFSET);
+#else
+            return r.x;
+#endif
+        }
+
+        inline void set(CompactReal &t, double x, double e)
+        {
+#if !COMPACT_ERROR_ONLY
+            t.x = x;
+#endif
+            t.e = (err_t)e;
+        }
+
+        inline void assign(CompactReal &t, double d)
+        {
+            set(t, d, 0);
+        }
+
+        inline void add(CompactReal &t, double lx, double le, double rx, double re)
+        {
+            double s = lx + rx;
+            double bb = s - lx;
+            double err = (lx - (s - bb)) + (rx - bb); // two-sum
+            set(t, s, err + le + re);
+        }
+
+        inline void mul(CompactReal &t, double lx, double le, double rx, double re)
+        {
+            double p = lx * rx;
+            double err = std::fma(lx, rx, -p); // two-prod
+            set(t, p, err + lx * re + rx * le);
+        }
+
+        // l*m + r with both rounding errors, safe when t aliases an operand
+        inline void fma(CompactReal &t, double lx, double le, double mx, double me, double rx, double re)
+        {
+            double p = lx * mx;
+            double perr = std::fma(lx, mx, -p);
+            double s = p + rx;
+            double bb = s - p;
+            double serr = (p - (s - bb)) + (rx - bb);
+            set(t, s, perr + serr + lx * me + mx * le + re);
+        }
+
+        inline void div(CompactReal &t, double lx, double le, double rx, double re)
+        {
+            double q = lx / rx;
+            double rem = std::fma(-q, rx, lx); // exact remainder
+            set(t, q, (rem + le - q * re) / rx);
+        }
+
+        inline void sqrt(CompactReal &t, double ax, double ae)
+        {
+            double s = std::sqrt(ax);
+            if (s == 0)
+            {
+                set(t, s, 0);
+                return;
+            }
+            double rem = std::fma(-s, s, ax);
+            set(t, s, (rem + ae) / (2 * s));
+        }
+
+        inline void exp(CompactReal &t, double ax, double ae)
+        {
+            double y = std::exp(ax);
+            set(t, y, y * ae);
+        }
+
+        inline void pow(CompactReal &t, double ax, double ae, double bx, double be)
+        {
+            double y = std::pow(ax, bx);
+            double d = be == 0 ? 0 : std::log(std::fabs(ax)) * be;
+            if (ae != 0 && ax != 0)
+                d += bx * ae / ax;
+            set(t, y, y * d);
+        }
+
+        // f(x + e) ~ f(x) + f'(x) e, the rounding error of f itself is not tracked
+        inline void apply(CompactReal &t, double fx, double de)
+        {
+            set(t, fx, de == de ? de : 0); // 0 * inf for exact inputs at poles
+        }
+
+        inline double value(const CompactReal &r)
+        {
+            return x(r) + (double)r.e;
+        }
+
+        // f of the represented value, around f of the original: floor, ceil, trunc and round
+        template <typename F>
+        inline void step(CompactReal &t, const CompactReal &r, F f)
+        {
+            double fx = f(x(r));
+            set(t, fx, f(value(r)) - fx);
+        }
+
+        // the operand with the smaller (less) or larger represented value, around fmin or fmax of the originals
+        inline void select(CompactReal &t, const CompactReal &a, const CompactReal &b, bool less)
+        {
+            double fx = less ? std::fmin(x(a), x(b)) : std::fmax(x(a), x(b));
+            double va = value(a), vb = value(b);
+            double v = less ? (vb < va ? vb : va) : (va < vb ? vb : va);
+            set(t, fx, v - fx);
+        }
+
+        // sign of (l - r) in the represented values
+        inline double diff(const CompactReal &l, const CompactReal &r)
+        {
+            return (x(l) - x(r)) + ((double)l.e - (double)r.e);
+        }
+
+        // the exponent of the original becomes the one of d, see Real::reloadHigh
+        inline void copyExponent(CompactReal &t, double d)
+        {
+#if COMPACT_ERROR_ONLY
+            double o = x(t), n = o;
+            __HI(n) = __HI(d);
+            t.e = o == 0 ? 0 : (err_t)(t.e * (n / o));
+#else
+            __HI(t.x) = __HI(d);
+#endif
+        }
+
+        inline void clearLows(CompactReal &t)
+        {
+#if !COMPACT_ERROR_ONLY
+            __LO(t.x) = 0;
+#endif
+            t.e = 0;
+        }
+    }; // namespace compact
+};     // namespace real
+
+#define HP_TYPE real::compact::CompactReal
+
+#define ADD_RR(t, l, r) real::compact::add(t, real::compact::x(l), (l).e, real::compact::x(r), (r).e)
+#define SUB_RR(t, l, r) real::compact::add(t, real::compact::x(l), (l).e, -real::compact::x(r), -(double)(r).e)
+#define MUL_RR(t, l, r) real::compact::mul(t, real::compact::x(l), (l).e, real::compact::x(r), (r).e)
+#define DIV_RR(t, l, r) real::compact::div(t, real::compact::x(l), (l).e, real::compact::x(r), (r).e)
+
+#define ADD_RD(t, l, r) real::compact::add(t, real::compact::x(l), (l).e, r, 0)
+#define SUB_RD(t, l, r) real::compact::add(t, real::compact::x(l), (l).e, -(r), 0)
+#define SUB_DR(t, l, r) real::compact::add(t, l, 0, -real::compact::x(r), -(double)(r).e)
+#define MUL_RD(t, l, r) real::compact::mul(t, real::compact::x(l), (l).e, r, 0)
+#define DIV_RD(t, l, r) real::compact::div(t, real::compact::x(l), (l).e, r, 0)
+#define DIV_DR(t, l, r) real::compact::div(t, l, 0, real::compact::x(r), (r).e)
+
+#define ASSIGN(l,r) l = r
+#define ASSIGN_D(l,r) real::compact::assign(l, r)
+#define SWAP(l,r) l = r
+
+#define INIT(r, p) /*DO NOTHING*/
+#define CLEAR(r) /*DO NOTHING*/
+
+#define TO_DOUBLE(r) real::compact::value(r)
+
+#define FMA(t, l, m, r) real::compact::fma(t, real::compact::x(l), (l).e, real::compact::x(m), (m).e, real::compact::x(r), (r).e)
+#define FMS(t, l, m, r) real::compact::fma(t, real::compact::x(l), (l).e, real::compact::x(m), (m).e, -real::compact::x(r), -(double)(r).e)
+#define FNMA(t, l, m, r) real::compact::fma(t, -real::compact::x(l), -(double)(l).e, real::compact::x(m), (m).e, real::compact::x(r), (r).e)
+
+#if KEEP_ORIGINAL
+#define STREAM_OUT(os, r)  {\
+    std::ios_base::fmtflags old_flags = os.flags(); \
+    std::streamsize old_prec = os.precision(19); \
+    os << std::scientific; \
+    os << "[ " << std::setw(27) << real::compact::x(r.shadow->shadowValue) << ", " << std::setw(27) << (double)r.shadow->shadowValue.e << " ]"; \
+    os << " (original = " << r.shadow->originalValue <<")"; \
+    os.precision(old_prec); \
+    os.flags(old_flags); \
+}
+#else
+#define STREAM_OUT(os, r)  {\
+    std::ios_base::fmtflags old_flags = os.flags(); \
+    std::streamsize old_prec = os.precision(19); \
+    os << std::scientific; \
+    os << "[ " << std::setw(27) << real::compact::x(r.shadow->shadowValue) << ", " << std::setw(27) << (double)r.shadow->shadowValue.e << " ]"; \
+    os.precision(old_prec); \
+    os.flags(old_flags); \
+}
+#endif
+
+#define LESS_RR(l,r) (real::compact::diff(l, r) < 0)
+#define LESSEQ_RR(l,r) (real::compact::diff(l, r) <= 0)
+#define EQUAL_RR(l,r) (real::compact::diff(l, r) == 0)
+#define GREATER_RR(l,r) (real::compact::diff(l, r) > 0)
+#define GREATEREQ_RR(l,r) (real::compact::diff(l, r) >= 0)
+
+#define EXP_R(res, r) real::compact::exp(res, real::compact::x(r), (r).e)
+#define POW_RR(res, a, b) real::compact::pow(res, real::compact::x(a), (a).e, real::compact::x(b), (b).e)
+#define SQRT_R(res, r) real::compact::sqrt(res, real::compact::x(r), (r).e)
+
+// <math.h>
+#define LOG_R(res, r) real::compact::apply(res, std::log(real::compact::x(r)), (double)(r).e / real::compact::x(r))
+#define LOG10_R(res, r) real::compact::apply(res, std::log10(real::compact::x(r)), (double)(r).e / (real::compact::x(r) * M_LN10))
+#define LOG2_R(res, r) real::compact::apply(res, std::log2(real::compact::x(r)), (double)(r).e / (real::compact::x(r) * M_LN2))
+#define LOG1P_R(res, r) real::compact::apply(res, std::log1p(real::compact::x(r)), (double)(r).e / (1 + real::compact::x(r)))
+#define EXPM1_R(res, r) real::compact::apply(res, std::expm1(real::compact::x(r)), std::exp(real::compact::x(r)) * (double)(r).e)
+#define SIN_R(res, r) real::compact::apply(res, std::sin(real::compact::x(r)), std::cos(real::compact::x(r)) * (double)(r).e)
+#define COS_R(res, r) real::compact::apply(res, std::cos(real::compact::x(r)), -std::sin(real::compact::x(r)) * (double)(r).e)
+#define TAN_R(res, r) real::compact::apply(res, std::tan(real::compact::x(r)), (double)(r).e / (std::cos(real::compact::x(r)) * std::cos(real::compact::x(r))))
+#define ASIN_R(res, r) real::compact::apply(res, std::asin(real::compact::x(r)), (double)(r).e / std::sqrt(1 - real::compact::x(r) * real::compact::x(r)))
+#define ACOS_R(res, r) real::compact::apply(res, std::acos(real::compact::x(r)), -(double)(r).e / std::sqrt(1 - real::compact::x(r) * real::compact::x(r)))
+#define ATAN_R(res, r) real::compact::apply(res, std::atan(real::compact::x(r)), (double)(r).e / (1 + real::compact::x(r) * real::compact::x(r)))
+#define SINH_R(res, r) real::compact::apply(res, std::sinh(real::compact::x(r)), std::cosh(real::compact::x(r)) * (double)(r).e)
+#define COSH_R(res, r) real::compact::apply(res, std::cosh(real::compact::x(r)), std::sinh(real::compact::x(r)) * (double)(r).e)
+#define TANH_R(res, r) real::compact::apply(res, std::tanh(real::compact::x(r)), (double)(r).e / (std::cosh(real::compact::x(r)) * std::cosh(real::compact::x(r))))
+#define ASINH_R(res, r) real::compact::apply(res, std::asinh(real::compact::x(r)), (double)(r).e / std::sqrt(real::compact::x(r) * real::compact::x(r) + 1))
+#define ACOSH_R(res, r) real::compact::apply(res, std::acosh(real::compact::x(r)), (double)(r).e / std::sqrt(real::compact::x(r) * real::compact::x(r) - 1))
+#define ATANH_R(res, r) real::compact::apply(res, std::atanh(real::compact::x(r)), (double)(r).e / (1 - real::compact::x(r) * real::compact::x(r)))
+#define FABS_R(res, r) real::compact::apply(res, std::fabs(real::compact::x(r)), real::compact::x(r) < 0 ? -(double)(r).e : (double)(r).e)
+#define FLOOR_R(res, r) real::compact::step(res, r, [](double v) { return std::floor(v); })
+#define CEIL_R(res, r) real::compact::step(res, r, [](double v) { return std::ceil(v); })
+#define TRUNC_R(res, r) real::compact::step(res, r, [](double v) { return std::trunc(v); })
+#define ROUND_R(res, r) real::compact::step(res, r, [](double v) { return std::round(v); })
+#define CBRT_R(res, r) real::compact::apply(res, std::cbrt(real::compact::x(r)), real::compact::x(r) == 0 ? 0 : (double)(r).e / (3 * std::cbrt(real::compact::x(r)) * std::cbrt(real::compact::x(r))))
+#define ERF_R(res, r) real::compact::apply(res, std::erf(real::compact::x(r)), M_2_SQRTPI * std::exp(-real::compact::x(r) * real::compact::x(r)) * (double)(r).e)
+#define ERFC_R(res, r) real::compact::apply(res, std::erfc(real::compact::x(r)), -M_2_SQRTPI * std::exp(-real::compact::x(r) * real::compact::x(r)) * (double)(r).e)
+#define ATAN2_RR(res, a, b) real::compact::apply(res, std::atan2(real::compact::x(a), real::compact::x(b)), (real::compact::x(b) * (double)(a).e - real::compact::x(a) * (double)(b).e) / (real::compact::x(a) * real::compact::x(a) + real::compact::x(b) * real::compact::x(b)))
+#define FMOD_RR(res, a, b) real::compact::apply(res, std::fmod(real::compact::x(a), real::compact::x(b)), (double)(a).e - std::trunc(real::compact::x(a) / real::compact::x(b)) * (double)(b).e)
+#define FMIN_RR(res, a, b) real::compact::select(res, a, b, true)
+#define FMAX_RR(res, a, b) real::compact::select(res, a, b, false)
+#define HYPOT_RR(res, a, b) real::compact::apply(res, std::hypot(real::compact::x(a), real::compact::x(b)), (real::compact::x(a) * (double)(a).e + real::compact::x(b) * (double)(b).e) / std::hypot(real::compact::x(a), real::compact::x(b)))
+
+
+#define COPY_EXP_D(res, d) real::compact::copyExponent(res, d)
+#define CLEAR_LOWS(res) real::compact::clearLows(res)
+#endif
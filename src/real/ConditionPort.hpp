@@ -0,0 +1,136 @@
+#ifndef CONDITION_PORT_HPP
+#define CONDITION_PORT_HPP
+/*
+Condition number port of CONDITION_NUMBER_MODE, selected by the mode itself.
+There is no high-precision value: a shadow is the value computed as in the original program, and each
+operation records its local condition number kappa = |x f'(x) / f(x)| (the larger one over its operands)
+at the current PC, see ProgramErrorState::updateCondition. A large kappa means the operation amplifies the
+relative errors of its operands, e.g., the cancellation of an addition. This only finds candidate sites:
+operands may be exact, and errors of several operations may accumulate, which a run with DD_PORT reveals.
+*/
+#include <cmath>
+#include <iomanip>
+
+#define HP_TYPE double
+
+namespace real
+{
+    namespace condition
+    {
+        // |n / d|, where 0/0 is the limit 1 of the functions below
+        inline double ratio(double n, double d)
+        {
+            if (d == 0)
+                return n == 0 ? 1 : INFINITY;
+            return std::fabs(n / d);
+        }
+
+        inline double add(double a, double b) { return ratio(std::fabs(a) + std::fabs(b), a + b); }
+        inline double fma(double l, double m, double r) { return ratio(std::fabs(l * m) + std::fabs(r), l * m + r); }
+
+        inline double pow(double a, double b) { return std::fmax(std::fabs(b), std::fabs(b * std::log(std::fabs(a)))); }
+        inline double log(double x) { return ratio(1, std::log(x)); }
+        inline double log1p(double x) { return ratio(x, (1 + x) * std::log1p(x)); }
+        inline double expm1(double x) { return ratio(x * std::exp(x), std::expm1(x)); }
+        inline double sin(double x) { return ratio(x * std::cos(x), std::sin(x)); }
+        inline double cos(double x) { return ratio(x * std::sin(x), std::cos(x)); }
+        inline double tan(double x) { return ratio(x, std::sin(x) * std::cos(x)); }
+        inline double asin(double x) { return ratio(x, std::sqrt(1 - x * x) * std::asin(x)); }
+        inline double acos(double x) { return ratio(x, std::sqrt(1 - x * x) * std::acos(x)); }
+        inline double atan(double x) { return ratio(x, (1 + x * x) * std::atan(x)); }
+        inline double sinh(double x) { return ratio(x * std::cosh(x), std::sinh(x)); }
+        inline double cosh(double x) { return std::fabs(x * std::tanh(x)); }
+        inline double tanh(double x) { return ratio(x, std::sinh(x) * std::cosh(x)); }
+        inline double asinh(double x) { return ratio(x, std::sqrt(x * x + 1) * std::asinh(x)); }
+        inline double acosh(double x) { return ratio(x, std::sqrt(x * x - 1) * std::acosh(x)); }
+        inline double atanh(double x) { return ratio(x, (1 - x * x) * std::atanh(x)); }
+        inline double erf(double x) { return ratio(2 * x * std::exp(-x * x), 1.7724538509055160273 * std::erf(x)); }
+        inline double erfc(double x) { return ratio(2 * x * std::exp(-x * x), 1.7724538509055160273 * std::erfc(x)); }
+        inline double atan2(double y, double x) { return ratio(x * y, (x * x + y * y) * std::atan2(y, x)); }
+        inline double fmod(double a, double b) { return ratio(a, std::fmod(a, b)); }
+    }; // namespace condition
+};     // namespace real
+
+#define CONDITION(k) ERROR_STATE.updateCondition(k)
+
+#define ADD_RR(t, l, r) (CONDITION(real::condition::add(l, r)), t = l + r)
+#define SUB_RR(t, l, r) (CONDITION(real::condition::add(l, -(r))), t = l - r)
+#define MUL_RR(t, l, r) (CONDITION(1), t = l * r)
+#define DIV_RR(t, l, r) (CONDITION(1), t = l / r)
+
+#define ADD_RD(t, l, r) ADD_RR(t, l, r)
+#define SUB_RD(t, l, r) SUB_RR(t, l, r)
+#define SUB_DR(t, l, r) SUB_RR(t, l, r)
+#define MUL_RD(t, l, r) MUL_RR(t, l, r)
+#define DIV_RD(t, l, r) DIV_RR(t, l, r)
+#define DIV_DR(t, l, r) DIV_RR(t, l, r)
+
+#define ASSIGN(l,r) l = r
+#define ASSIGN_D(l,r) l = r
+#define SWAP(l,r) l = r
+
+#define INIT(r, p) /*DO NOTHING*/
+#define CLEAR(r) /*DO NOTHING*/
+
+#define TO_DOUBLE(r) (r)
+
+#define FMA(t, l, m, r) (CONDITION(real::condition::fma(l, m, r)), t = std::fma(l, m, r))
+#define FMS(t, l, m, r) (CONDITION(real::condition::fma(l, m, -(r))), t = std::fma(l, m, -(r)))
+#define FNMA(t, l, m, r) (CONDITION(real::condition::fma(-(l), m, r)), t = std::fma(-(l), m, r))
+
+#define STREAM_OUT(os, r)  {\
+    std::ios_base::fmtflags old_flags = os.flags(); \
+    std::streamsize old_prec = os.precision(19); \
+    os << std::scientific; \
+    os << "[ " << std::setw(27) << r.shadow->shadowValue << " ] (no shadow)"; \
+    os.precision(old_prec); \
+    os.flags(old_flags); \
+}
+
+#define LESS_RR(l,r) l<r
+#define LESSEQ_RR(l,r) l<=r
+#define EQUAL_RR(l,r) l==r
+#define GREATER_RR(l,r) l>r
+#define GREATEREQ_RR(l,r) l>=r
+
+#define CONDITION_R(res, r, k, f) (CONDITION(k), res = f(r))
+
+#define EXP_R(res, r) CONDITION_R(res, r, std::fabs(r), std::exp)
+#define POW_RR(res, a, b) (CONDITION(real::condition::pow(a, b)), res = std::pow(a, b))
+#define SQRT_R(res, r) CONDITION_R(res, r, 0.5, std::sqrt)
+
+// <math.h>
+#define LOG_R(res, r) CONDITION_R(res, r, real::condition::log(r), std::log)
+#define LOG10_R(res, r) CONDITION_R(res, r, real::condition::log(r), std::log10)
+#define LOG2_R(res, r) CONDITION_R(res, r, real::condition::log(r), std::log2)
+#define LOG1P_R(res, r) CONDITION_R(res, r, real::condition::log1p(r), std::log1p)
+#define EXPM1_R(res, r) CONDITION_R(res, r, real::condition::expm1(r), std::expm1)
+#define SIN_R(res, r) CONDITION_R(res, r, real::condition::sin(r), std::sin)
+#define COS_R(res, r) CONDITION_R(res, r, real::condition::cos(r), std::cos)
+#define TAN_R(res, r) CONDITION_R(res, r, real::condition::tan(r), std::tan)
+#define ASIN_R(res, r) CONDITION_R(res, r, real::condition::asin(r), std::asin)
+#define ACOS_R(res, r) CONDITION_R(res, r, real::condition::acos(r), std::acos)
+#define ATAN_R(res, r) CONDITION_R(res, r, real::condition::atan(r), std::atan)
+#define SINH_R(res, r) CONDITION_R(res, r, real::condition::sinh(r), std::sinh)
+#define COSH_R(res, r) CONDITION_R(res, r, real::condition::cosh(r), std::cosh)
+#define TANH_R(res, r) CONDITION_R(res, r, real::condition::tanh(r), std::tanh)
+#define ASINH_R(res, r) CONDITION_R(res, r, real::condition::asinh(r), std::asinh)
+#define ACOSH_R(res, r) CONDITION_R(res, r, real::condition::acosh(r), std::acosh)
+#define ATANH_R(res, r) CONDITION_R(res, r, real::condition::atanh(r), std::atanh)
+#define FABS_R(res, r) CONDITION_R(res, r, 1, std::fabs)
+#define FLOOR_R(res, r) CONDITION_R(res, r, 1, std::floor)
+#define CEIL_R(res, r) CONDITION_R(res, r, 1, std::ceil)
+#define TRUNC_R(res, r) CONDITION_R(res, r, 1, std::trunc)
+#define ROUND_R(res, r) CONDITION_R(res, r, 1, std::round)
+#define CBRT_R(res, r) CONDITION_R(res, r, 1.0 / 3, std::cbrt)
+#define ERF_R(res, r) CONDITION_R(res, r, real::condition::erf(r), std::erf)
+#define ERFC_R(res, r) CONDITION_R(res, r, real::condition::erfc(r), std::erfc)
+#define ATAN2_RR(res, a, b) (CONDITION(real::condition::atan2(a, b)), res = std::atan2(a, b))
+#define FMOD_RR(res, a, b) (CONDITION(real::condition::fmod(a, b)), res = std::fmod(a, b))
+#define FMIN_RR(res, a, b) (CONDITION(1), res = std::fmin(a, b))
+#define FMAX_RR(res, a, b) (CONDITION(1), res = std::fmax(a, b))
+#define HYPOT_RR(res, a, b) (CONDITION(1), res = std::hypot(a, b))
+
+#define COPY_EXP_D(res, d) __HI(res)=__HI(d)
+#define CLEAR_LOWS(res) __LO(res) = 0
+#endif
@@ -0,0 +1,210 @@
+#ifndef CYCLE_PROFILE_HPP
+#define CYCLE_PROFILE_HPP
+/*
+Per-PC cost of shadow execution (SHADOW_PROFILE), to decide where selective instrumentation pays off (see
+turnFpArith -profile) and which kernels to optimize first.
+PC(id) reads the time stamp counter, and the ticks since the previous PC are attributed to the previous PC, i.e.,
+a statement is charged with its shadow operations, variable lookups and its (usually small) native work.
+With SHADOW_PROFILE_PERIOD = N about every Nth statement is timed, and the ticks of a PC are extrapolated from its
+timed visits. The gaps between timed statements are random (geometric with mean N), a fixed gap would time the same
+statement on every pass of a loop whose body has a length dividing N, and none of the others. The cost of the timing itself is measured at startup and subtracted from every timed visit.
+The operators and the math functions of Real count their shadow operations per PC (PROFILE_OP), and so do the
+fused operations, the lazy expressions (RealLazy.hpp) and the JIT sites, interpreted or compiled.
+At exit the report is written to SHADOW_PROFILE_FILE, and EAST_PROFILE_REPORT prints it at any time.
+*/
+#include <vector>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "RealConfigure.h"
+#include "RealUtil.hpp"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace real
+{
+    // time stamp counter, or the virtual counter on arm64, or nanoseconds elsewhere
+    inline uint64 ticks()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64 t;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(t));
+        return t;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    struct CycleProfile
+    {
+        struct Record
+        {
+            uint64 visits;
+            uint64 timed;
+            uint64 ticks;
+            uint64 ops;
+        };
+        std::vector<Record> records;
+        uint64 pc;       // the current statement
+        uint64 timedPc;  // the statement being timed, if timing
+        bool timing;
+        uint64 last;
+        uint64 countdown;
+        uint64 random;   // xorshift64* state of the gaps
+        double overhead; // ticks of one timed visit without work
+        uint64 startTicks;
+        std::chrono::steady_clock::time_point startTime;
+
+        static CycleProfile INSTANCE;
+
+        CycleProfile() : pc(0), timedPc(0), timing(false), last(0), countdown(1), random(0x9E3779B97F4A7C15ULL), overhead(0)
+        {
+#ifdef PC_COUNT
+            records.resize(PC_COUNT, Record{0, 0, 0, 0});
+#endif
+            calibrate();
+            startTicks = ticks();
+            startTime = std::chrono::steady_clock::now();
+        }
+
+        ~CycleProfile()
+        {
+            std::ofstream out(SHADOW_PROFILE_FILE, std::ios::out | std::ios::trunc);
+            report(out);
+        }
+
+        // ticks of back-to-back PCs, the minimum of a few rounds to ignore interrupts
+        void calibrate()
+        {
+            const int ROUNDS = 16, VISITS = 256;
+            double best = -1;
+            for (int r = 0; r < ROUNDS; r++)
+            {
+                records.assign(records.size() > 1 ? records.size() : 1, Record{0, 0, 0, 0});
+                timing = false;
+                countdown = 1;
+                for (int i = 0; i < VISITS; i++)
+                    enter(0, 1);
+                flush();
+                double t = (double)records[0].ticks / records[0].timed;
+                if (best < 0 || t < best)
+                    best = t;
+            }
+            overhead = best;
+            records.assign(records.size(), Record{0, 0, 0, 0});
+            pc = 0;
+            timing = false;
+            countdown = gap(SHADOW_PROFILE_PERIOD);
+        }
+
+        // statements until the next timed one, geometric with mean period
+        uint64 gap(uint64 period)
+        {
+            if (period <= 1)
+                return 1;
+            random ^= random >> 12;
+            random ^= random << 25;
+            random ^= random >> 27;
+            double u = ((random * 0x2545F4914F6CDD1DULL >> 11) + 1) / (double)(1ULL << 53); // (0, 1]
+            return 1 + (uint64)(std::log(u) / std::log1p(-1.0 / period));
+        }
+
+        inline void enter(uint64 id, uint64 period = SHADOW_PROFILE_PERIOD)
+        {
+            uint64 now = ticks();
+            if (timing)
+            {
+                Record &r = records[timedPc];
+                r.ticks += now - last;
+                r.timed++;
+                timing = false;
+            }
+            if (real_unlikely(id >= records.size()))
+                records.resize(id + 1, Record{0, 0, 0, 0});
+            records[id].visits++;
+            pc = id;
+            if (--countdown == 0)
+            {
+                countdown = gap(period);
+                timedPc = id;
+                timing = true;
+                last = ticks(); // the bookkeeping above is not charged to the statement
+            }
+        }
+
+        inline void op()
+        {
+            if (real_likely(pc < records.size()))
+                records[pc].ops++;
+        }
+
+        // closes the statement being timed
+        void flush()
+        {
+            if (timing)
+            {
+                records[timedPc].ticks += ticks() - last;
+                records[timedPc].timed++;
+                timing = false;
+            }
+        }
+
+        // estimated ticks of a PC, without the profiling overhead
+        double estimate(const Record &r) const
+        {
+            if (r.timed == 0)
+                return 0;
+            double t = (double)r.ticks - overhead * r.timed;
+            if (t < 0)
+                t = 0;
+            return t * r.visits / r.timed;
+        }
+
+        // PCs by decreasing estimated ticks: "pc share ticks visits ops ticks/visit location"
+        void report(std::ostream &stream)
+        {
+            flush();
+            std::vector<uint64> order;
+            double total = 0;
+            for (uint64 i = 0; i < records.size(); i++)
+            {
+                if (records[i].visits == 0)
+                    continue;
+                order.push_back(i);
+                total += estimate(records[i]);
+            }
+            std::sort(order.begin(), order.end(), [this](uint64 a, uint64 b) { return estimate(records[a]) > estimate(records[b]); });
+
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            double ticksPerSecond = seconds > 0 ? (ticks() - startTicks) / seconds : 0;
+            std::ios_base::fmtflags flags = stream.flags();
+            stream << "[PROFILE]\t" << total << " ticks in " << order.size() << " PCs, " << ticksPerSecond * 1e-9
+                   << " ticks/ns, " << overhead << " ticks of overhead per timed visit subtracted, period "
+                   << SHADOW_PROFILE_PERIOD << "\n";
+            stream << "[PROFILE]\tpc\tshare\tticks\tvisits\tops\tticks/visit\tlocation\n";
+            stream << std::fixed;
+            for (uint64 i : order)
+            {
+                const Record &r = records[i];
+                double t = estimate(r);
+                stream << "[PROFILE]\t" << i << "\t" << std::setprecision(2) << (total > 0 ? 100 * t / total : 0) << "%\t"
+                       << std::setprecision(0) << t << "\t" << r.visits << "\t" << r.ops << "\t"
+                       << std::setprecision(1) << t / r.visits << "\t";
+#ifdef PC_COUNT
+                if (i < PC_COUNT)
+                    stream << PATH_STRINGS[i];
+#endif
+                stream << "\n";
+            }
+            stream.flags(flags);
+        }
+    };
+    CycleProfile CycleProfile::INSTANCE;
+}; // namespace real
+
+#endif
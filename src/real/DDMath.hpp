@@ -0,0 +1,161 @@
+#ifndef DD_MATH_HPP
+#define DD_MATH_HPP
+/*
+Double-double kernels of <math.h> functions that are missing in qd.
+The others (exp, log, trigonometric and hyperbolic functions, ...) are qd's table-driven kernels.
+*/
+#include <cmath>
+#include <qd/dd_real.h>
+
+namespace real
+{
+    namespace ddmath
+    {
+        // below it the series converge in about 25 terms, above it log(1 + a) and exp(a) - 1 do not cancel
+        static const double SERIES_BOUND = 0.5;
+
+        inline dd_real log2(const dd_real &a)
+        {
+            return log(a) / dd_real::_log2;
+        }
+
+        // log1p(x) = 2 atanh(s) = 2 (s + s^3/3 + s^5/5 + ...) with s = x / (2 + x), |s| <= 1/3
+        inline dd_real log1p(const dd_real &a)
+        {
+            if (std::fabs(a.x[0]) < SERIES_BOUND)
+            {
+                dd_real s = a / (2.0 + a);
+                dd_real s2 = sqr(s), power = s, sum = s;
+                for (int k = 1; k < 100; k++)
+                {
+                    power *= s2;
+                    dd_real term = power / (double)(2 * k + 1);
+                    sum += term;
+                    if (std::fabs(term.x[0]) < std::fabs(sum.x[0]) * 1e-33)
+                        break;
+                }
+                return mul_pwr2(sum, 2.0);
+            }
+            return log(1.0 + a);
+        }
+
+        // expm1(x) = x + x^2/2! + x^3/3! + ...
+        inline dd_real expm1(const dd_real &a)
+        {
+            if (std::fabs(a.x[0]) < SERIES_BOUND)
+            {
+                dd_real term = a, sum = a;
+                for (int n = 2; n < 100; n++)
+                {
+                    term = term * a / (double)n;
+                    sum += term;
+                    if (std::fabs(term.x[0]) < std::fabs(sum.x[0]) * 1e-33)
+                        break;
+                }
+                return sum;
+            }
+            return exp(a) - 1.0;
+        }
+
+        inline dd_real cbrt(const dd_real &a)
+        {
+            if (a.is_zero())
+                return a;
+            return nroot(a, 3);
+        }
+
+        inline dd_real hypot(const dd_real &a, const dd_real &b)
+        {
+            dd_real x = fabs(a), y = fabs(b);
+            dd_real m = x > y ? x : y;
+            if (m.is_zero() || m.isinf())
+                return m;
+            // scale by a power of two to avoid overflow in the squares
+            int e;
+            std::frexp(m.x[0], &e);
+            x = ldexp(x, -e);
+            y = ldexp(y, -e);
+            return ldexp(sqrt(sqr(x) + sqr(y)), e);
+        }
+
+        // erf(x) = 2/sqrt(pi) * exp(-x^2) * sum_n 2^n x^(2n+1) / (1*3*...*(2n+1)), all terms positive
+        inline dd_real erfSeries(const dd_real &x)
+        {
+            dd_real x2 = sqr(x);
+            dd_real term = x, sum = x;
+            for (int n = 1; n < 200; n++)
+            {
+                term = term * mul_pwr2(x2, 2.0) / (double)(2 * n + 1);
+                sum += term;
+                if (std::fabs(term.x[0]) < std::fabs(sum.x[0]) * 1e-33)
+                    break;
+            }
+            static const dd_real twoOverSqrtPi = 2.0 / sqrt(dd_real::_pi);
+            return twoOverSqrtPi * exp(-x2) * sum;
+        }
+
+        // erfc(x) = exp(-x^2)/sqrt(pi) / (x + 1/2/(x + 1/(x + 3/2/(x + 2/(x + ...))))), for x >= 2
+        inline dd_real erfcFraction(const dd_real &x)
+        {
+            int terms = 16 + (int)(800.0 / (x.x[0] * x.x[0]));
+            dd_real f = x;
+            for (int k = terms; k >= 1; k--)
+                f = x + (0.5 * k) / f;
+            static const dd_real invSqrtPi = 1.0 / sqrt(dd_real::_pi);
+            return invSqrtPi * exp(-sqr(x)) / f;
+        }
+
+        inline dd_real erf(const dd_real &a)
+        {
+            if (a.isnan())
+                return a;
+            double ax = std::fabs(a.x[0]);
+            if (ax < 2.0)
+                return erfSeries(a);
+            if (ax > 9.0)
+                return a.is_negative() ? dd_real(-1.0) : dd_real(1.0);
+            dd_real r = 1.0 - erfcFraction(fabs(a));
+            return a.is_negative() ? -r : r;
+        }
+
+        inline dd_real erfc(const dd_real &a)
+        {
+            if (a.isnan())
+                return a;
+            if (a.x[0] <= -2.0)
+                return a.x[0] < -9.0 ? dd_real(2.0) : 2.0 - erfcFraction(-a);
+            if (a.x[0] < 2.0)
+                return 1.0 - erfSeries(a);
+            if (a.x[0] > 27.0)
+                return dd_real(0.0);
+            return erfcFraction(a);
+        }
+
+        inline dd_real fmin(const dd_real &a, const dd_real &b)
+        {
+            if (a.isnan())
+                return b;
+            if (b.isnan())
+                return a;
+            return b < a ? b : a;
+        }
+
+        inline dd_real fmax(const dd_real &a, const dd_real &b)
+        {
+            if (a.isnan())
+                return b;
+            if (b.isnan())
+                return a;
+            return a < b ? b : a;
+        }
+
+        inline dd_real round(const dd_real &a)
+        {
+            // halfway cases away from zero, as in C
+            dd_real r = aint(fabs(a) + 0.5);
+            return a.is_negative() ? -r : r;
+        }
+    }; // namespace ddmath
+};     // namespace real
+
+#endif
@@ -2,6 +2,7 @@
 #define DD_PORT_HPP
 #include <iomanip>
 #include <qd/dd_real.h>
+#include "DDMath.hpp"
 
 #define HP_TYPE dd_real
 
@@ -28,6 +29,7 @@
 
 #define FMA(t, l, m, r) t = l * m + r
 #define FMS(t, l, m, r) t = l * m - r
+#define FNMA(t, l, m, r) t = r - l * m
 
 #if KEEP_ORIGINAL
 #define STREAM_OUT(os, r)  {\
@@ -60,6 +62,38 @@
 #define POW_RR(res, a, b) res=pow(a,b)
 #define SQRT_R(res, r) res=sqrt(r)
 
+// <math.h>, qd kernels completed by DDMath.hpp
+#define LOG_R(res, r) res = log(r)
+#define LOG10_R(res, r) res = log10(r)
+#define LOG2_R(res, r) res = real::ddmath::log2(r)
+#define LOG1P_R(res, r) res = real::ddmath::log1p(r)
+#define EXPM1_R(res, r) res = real::ddmath::expm1(r)
+#define SIN_R(res, r) res = sin(r)
+#define COS_R(res, r) res = cos(r)
+#define TAN_R(res, r) res = tan(r)
+#define ASIN_R(res, r) res = asin(r)
+#define ACOS_R(res, r) res = acos(r)
+#define ATAN_R(res, r) res = atan(r)
+#define SINH_R(res, r) res = sinh(r)
+#define COSH_R(res, r) res = cosh(r)
+#define TANH_R(res, r) res = tanh(r)
+#define ASINH_R(res, r) res = asinh(r)
+#define ACOSH_R(res, r) res = acosh(r)
+#define ATANH_R(res, r) res = atanh(r)
+#define FABS_R(res, r) res = fabs(r)
+#define FLOOR_R(res, r) res = floor(r)
+#define CEIL_R(res, r) res = ceil(r)
+#define TRUNC_R(res, r) res = aint(r)
+#define ROUND_R(res, r) res = real::ddmath::round(r)
+#define CBRT_R(res, r) res = real::ddmath::cbrt(r)
+#define ERF_R(res, r) res = real::ddmath::erf(r)
+#define ERFC_R(res, r) res = real::ddmath::erfc(r)
+#define ATAN2_RR(res, a, b) res = atan2(a, b)
+#define FMOD_RR(res, a, b) res = fmod(a, b)
+#define FMIN_RR(res, a, b) res = real::ddmath::fmin(a, b)
+#define FMAX_RR(res, a, b) res = real::ddmath::fmax(a, b)
+#define HYPOT_RR(res, a, b) res = real::ddmath::hypot(a, b)
+
 
 #define COPY_EXP_D(res, d) __HI(res.x[0])=__HI(d)
 #define CLEAR_LOWS(res) __LO(res.x[0]) = 0, res.x[1] = 0
@@ -0,0 +1,103 @@
+#ifndef DOUBLE_PORT_HPP
+#define DOUBLE_PORT_HPP
+#include <iomanip>
+#include <cmath>
+
+/*
+Plain double shadows. This is the cheapest port for programs computing in float (see ORIGINAL_WIDTHS),
+where a double carries 29 more significand bits than the original.
+*/
+#define HP_TYPE double
+
+#define ADD_RR(t, l, r) t = l + r
+#define SUB_RR(t, l, r) t = l - r
+#define MUL_RR(t, l, r) t = l * r
+#define DIV_RR(t, l, r) t = l / r
+
+#define ADD_RD(t, l, r) t = l + r
+#define SUB_RD(t, l, r) t = l - r
+#define SUB_DR(t, l, r) t = l - r
+#define MUL_RD(t, l, r) t = l * r
+#define DIV_RD(t, l, r) t = l / r
+#define DIV_DR(t, l, r) t = l / r
+
+#define ASSIGN(l,r) l = r
+#define ASSIGN_D(l,r) l = r
+#define SWAP(l,r) l = r
+
+#define INIT(r, p) /*DO NOTHING*/
+#define CLEAR(r) /*DO NOTHING*/
+
+#define TO_DOUBLE(r) (r)
+
+#define FMA(t, l, m, r) t = std::fma(l, m, r)
+#define FMS(t, l, m, r) t = std::fma(l, m, -(r))
+#define FNMA(t, l, m, r) t = std::fma(-(l), m, r)
+
+#if KEEP_ORIGINAL
+#define STREAM_OUT(os, r)  {\
+    std::ios_base::fmtflags old_flags = os.flags(); \
+    std::streamsize old_prec = os.precision(19); \
+    os << std::scientific; \
+    os << "[ " << std::setw(27) << r.shadow->shadowValue << " ]"; \
+    os << " (original = " << r.shadow->originalValue <<")"; \
+    os.precision(old_prec); \
+    os.flags(old_flags); \
+}
+#else
+#define STREAM_OUT(os, r)  {\
+    std::ios_base::fmtflags old_flags = os.flags(); \
+    std::streamsize old_prec = os.precision(19); \
+    os << std::scientific; \
+    os << "[ " << std::setw(27) << r.shadow->shadowValue << " ]"; \
+    os.precision(old_prec); \
+    os.flags(old_flags); \
+}
+#endif
+
+#define LESS_RR(l,r) l<r
+#define LESSEQ_RR(l,r) l<=r
+#define EQUAL_RR(l,r) l==r
+#define GREATER_RR(l,r) l>r
+#define GREATEREQ_RR(l,r) l>=r
+
+#define EXP_R(res, r) res = std::exp(r)
+#define POW_RR(res, a, b) res = std::pow(a,b)
+#define SQRT_R(res, r) res = std::sqrt(r)
+
+// <math.h>
+#define LOG_R(res, r) res = std::log(r)
+#define LOG10_R(res, r) res = std::log10(r)
+#define LOG2_R(res, r) res = std::log2(r)
+#define LOG1P_R(res, r) res = std::log1p(r)
+#define EXPM1_R(res, r) res = std::expm1(r)
+#define SIN_R(res, r) res = std::sin(r)
+#define COS_R(res, r) res = std::cos(r)
+#define TAN_R(res, r) res = std::tan(r)
+#define ASIN_R(res, r) res = std::asin(r)
+#define ACOS_R(res, r) res = std::acos(r)
+#define ATAN_R(res, r) res = std::atan(r)
+#define SINH_R(res, r) res = std::sinh(r)
+#define COSH_R(res, r) res = std::cosh(r)
+#define TANH_R(res, r) res = std::tanh(r)
+#define ASINH_R(res, r) res = std::asinh(r)
+#define ACOSH_R(res, r) res = std::acosh(r)
+#define ATANH_R(res, r) res = std::atanh(r)
+#define FABS_R(res, r) res = std::fabs(r)
+#define FLOOR_R(res, r) res = std::floor(r)
+#define CEIL_R(res, r) res = std::ceil(r)
+#define TRUNC_R(res, r) res = std::trunc(r)
+#define ROUND_R(res, r) res = std::round(r)
+#define CBRT_R(res, r) res = std::cbrt(r)
+#define ERF_R(res, r) res = std::erf(r)
+#define ERFC_R(res, r) res = std::erfc(r)
+#define ATAN2_RR(res, a, b) res = std::atan2(a, b)
+#define FMOD_RR(res, a, b) res = std::fmod(a, b)
+#define FMIN_RR(res, a, b) res = std::fmin(a, b)
+#define FMAX_RR(res, a, b) res = std::fmax(a, b)
+#define HYPOT_RR(res, a, b) res = std::hypot(a, b)
+
+
+#define COPY_EXP_D(res, d) __HI(res)=__HI(d)
+#define CLEAR_LOWS(res) __LO(res) = 0
+#endif
\ No newline at end of file
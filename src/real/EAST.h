@@ -1,6 +1,7 @@
 #ifndef EAST_H
 #define EAST_H
 #include "ShadowExecution.hpp"
+#include "AsyncReport.hpp"
 // EAST interface for developers
 
 void EAST_DUMP(std::ostream& stream, double d) {} // pseudo function
@@ -9,52 +10,55 @@ void EAST_DUMP(std::ostream& stream, const SVal &d) {
     stream << d << "\n";
 }
 
+void EAST_DUMP_DIGITS(std::ostream& stream, double d) {} // pseudo function
+
+void EAST_DUMP_DIGITS(std::ostream& stream, const SVal &sv)
+{
+#if PORT_TYPE == STOCHASTIC_PORT
+    stream << "[DIGITS]\t" << real::stochastic::significantDigits(sv.shadow->shadowValue) << " significant digits\n";
+#else
+    stream << "[DIGITS]\tsignificant digits are estimated by STOCHASTIC_PORT only\n";
+#endif
+}
+
+void EAST_DUMP_BOUND(std::ostream& stream, double d) {} // pseudo function
+
+void EAST_DUMP_BOUND(std::ostream& stream, const SVal &sv, double ov)
+{
+#ifdef SHADOW_ENCLOSURE
+    real::interval::Interval i = SHADOW_ENCLOSURE(sv.shadow->shadowValue);
+    double bound = real::interval::errorBound(i, ov);
+    stream << "[BOUND]\t" << "Exact value in [" << i.lo << ", " << i.hi << "], error of " << ov << " is at most " << bound;
+    if (i.lo > 0 || i.hi < 0)
+        stream << " (" << bound / real::interval::mig(i) / ORIGINAL_ULP_OF(*sv.shadow) << " ulps)";
+    stream << "\n";
+#else
+    stream << "[BOUND]\tenclosures are computed by INTERVAL_PORT and AFFINE_PORT only\n";
+#endif
+}
+
 void EAST_DUMP_ERROR(std::ostream& stream, double d) {stream << d <<"\n";} // pseudo function
 
 void EAST_DUMP_ERROR(std::ostream& stream, const SVal &sv, double ov) 
 {
-    stream << "[ERROR]\t" << "Shadow value is ";
-    EAST_DUMP(stream, sv);
-#if TRACK_ERROR
-    if(sv.shadow->error.maxRelativeError==0)
-    {
-        stream <<"[ERROR]\t" << "MRE < 10^-16\n";
-    }
-    else 
-    {
-        stream <<"[ERROR]\t" << "MRE is "<<sv.shadow->error.maxRelativeError<<", caused by "<< ERROR_STATE.locationStrings[sv.shadow->error.errorCausingCalculationID] <<"\n";
-    }
-    if(sv.shadow->error.relativeErrorOfLastCheck==0)
-    {
-        stream <<"[ERROR]\t" << "LRE < 10^-16\n";
-    }
-    else 
-    {
-        stream <<"[ERROR]\t" << "LRE is "<<sv.shadow->error.relativeErrorOfLastCheck<<", caused by "<< ERROR_STATE.locationStrings[sv.shadow->error.errorCausingCalculationIDOfLastCheck] <<"\n";
-    }
-#if ACTIVE_TRACK_ERROR
+#if TRACK_ERROR == false || ACTIVE_TRACK_ERROR
     double re = CALCERR(sv, ov);
-    if(re==0)
-    {
-        stream <<"[ERROR]\t" << "Current RE < 10^-16\n";
-    }
-    else 
-    {
-        stream <<"[ERROR]\t" << "Current RE is "<<re<<"\n";
-    }
+#else
+    double re = 0;
 #endif
+#if SHADOW_ASYNC_REPORT
+    real::ReportQueue::INSTANCE.dumpError(stream, *sv.shadow, ov, re);
 #else
-    double re = CALCERR(sv, ov);
-    if(re==0)
-    {
-        stream <<"[ERROR]\t" << "Current RE < 10^-16\n";
-    }
-    else 
-    {
-        stream <<"[ERROR]\t" << "Current RE is "<<re<<"\n";
-    }
+    real::formatError(stream, *sv.shadow, ov, re);
 #endif
+}
 
+// waits until the reports queued by EAST_DUMP_ERROR and EAST_DRAW_ERROR are written (SHADOW_ASYNC_REPORT)
+void EAST_REPORT_FLUSH()
+{
+#if SHADOW_ASYNC_REPORT
+    real::ReportQueue::INSTANCE.flush();
+#endif
 }
 
 void EAST_ANALYZE_ERROR(double d) {} // pseudo function
@@ -80,7 +84,11 @@ inline void EAST_ANALYZE_ERROR(const SVal &sv, double ov)
 bool EAST_CONDITION(std::ostream& stream, double v) {return v;}
 bool EAST_CONDITION(std::ostream& stream, bool sv, bool ov)
 {
-    if(sv!=ov) stream << "Control flow divergence!\n";
+    if(sv!=ov)
+    {
+        TRACE_DIVERGENCE();
+        stream << "Control flow divergence!\n";
+    }
     return ov;
 }
 
@@ -90,11 +98,68 @@ bool EAST_CONDITION(std::ostream& stream, bool sv, bool ov)
 void EAST_DRAW_ERROR(std::string name, double v, std::string file) {}
 void EAST_DRAW_ERROR(std::string name, const SVal &sv, std::string file) 
 {
-#if TRACK_ERROR
+#if TRACK_ERROR && SHADOW_ASYNC_REPORT
+    real::ReportQueue::INSTANCE.drawError(file, name, ERROR_STATE, sv.shadow->error);
+#elif TRACK_ERROR
     ERROR_STATE.visualizeTo(file, sv.shadow->error, name);
 #endif
 }
 
+// flagged PCs of CONDITION_NUMBER_MODE so far, also reported at exit
+void EAST_CONDITION_REPORT(std::ostream& stream)
+{
+#if TRACK_CONDITION
+    ERROR_STATE.reportConditions(stream);
+#endif
+}
+
+// the at most k statements that explain the first fraction of the error of sv (SHADOW_PROVENANCE)
+void EAST_EXPLAIN_ERROR(std::ostream& stream, double v, double fraction = 0.9, uint64 k = 10) {} // pseudo function
+void EAST_EXPLAIN_ERROR(std::ostream& stream, const SVal &sv, double fraction = 0.9, uint64 k = 10)
+{
+#if SHADOW_PROVENANCE && TRACK_ERROR
+    real::Provenance::INSTANCE.explain(stream, sv.shadow->error.errorCausingCalculationIDOfLastCheck, ERROR_STATE.locationStrings, fraction, k);
+#else
+    stream << "[EXPLAIN]\tbuild with SHADOW_PROVENANCE in a mode tracking errors to explain errors\n";
+#endif
+}
+
+// per-PC distributions of the error estimates so far (ERROR_HISTOGRAM)
+void EAST_ERROR_HISTOGRAM(std::ostream& stream)
+{
+#if ERROR_HISTOGRAM && TRACK_ERROR
+    ERROR_STATE.reportHistograms(stream);
+#else
+    stream << "[HISTOGRAM]\tbuild with ERROR_HISTOGRAM in a mode tracking errors for histograms of the errors\n";
+#endif
+}
+
+// where the shadow execution time goes so far (SHADOW_PROFILE), also written to SHADOW_PROFILE_FILE at exit
+void EAST_PROFILE_REPORT(std::ostream& stream)
+{
+#if SHADOW_PROFILE
+    real::CycleProfile::INSTANCE.report(stream);
+#else
+    stream << "[PROFILE]\tbuild with SHADOW_PROFILE to profile shadow execution\n";
+#endif
+}
+
+// memory of the shadow runtime so far in the Prometheus text format (SHADOW_MEMSTATS), also dumped to SHADOW_MEMSTATS_FILE
+void EAST_MEMSTATS(std::ostream& stream)
+{
+#if SHADOW_MEMSTATS
+    real::MemStats::INSTANCE.report(stream);
+#else
+    stream << "# build with SHADOW_MEMSTATS to account the shadow memory\n";
+#endif
+}
+
+// releases idle pool batches while more than keep values per pool stay free, returns the bytes
+uint64 EAST_MEMTRIM(uint64 keep = 0)
+{
+    return real::MemStats::INSTANCE.trimPools(keep);
+}
+
 #if ACTIVE_TRACK_ERROR && TRACKING_ON==false
 #define EAST_TRACKING_ON() ERROR_STATE.setTracking(true)
 #define EAST_TRACKING_OFF() ERROR_STATE.setTracking(false)
@@ -103,12 +168,7 @@ void EAST_DRAW_ERROR(std::string name, const SVal &sv, std::string file)
 #define EAST_TRACKING_OFF() 
 #endif
 
-void EAST_SYNC(double v) {}
-
-inline void EAST_SYNC(SVal &sv, double v)
-{
-    sv = v;
-}
+void EAST_SYNC(double v) {} // pseudo function, EAST_SYNC(SVal &, double) is in ShadowExecution.hpp
 
 void EAST_FIX(double v) {}
 inline void EAST_FIX(SVal &sv, double& v)
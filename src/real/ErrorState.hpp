@@ -1,11 +1,38 @@
 #ifndef ERROR_STATE_HPP
 #define ERROR_STATE_HPP
-#include <set>
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <fstream>
+#include <vector>
+#include <cstring>
+#include <cmath>
 #include "RealConfigure.h"
 #include "RealUtil.hpp"
+#if PC_PROFILE
+#include "PcProfile.hpp"
+#define PROFILE_ERROR(pc, re) real::PcProfile::INSTANCE.error(pc, re)
+#else
+#define PROFILE_ERROR(pc, re)
+#endif
+#if SHADOW_TRACE
+#include "ErrorTrace.hpp"
+#define TRACE_ERROR(pc, re) real::ErrorTrace::INSTANCE.sample(pc, re)
+#define TRACE_EDGE(pc, var) real::ErrorTrace::INSTANCE.edge(pc, (var).errorCausingCalculationID, (var).maxRelativeError)
+#define TRACE_DIVERGENCE() real::ErrorTrace::INSTANCE.divergence()
+#else
+#define TRACE_ERROR(pc, re) (void)0
+#define TRACE_EDGE(pc, var) (void)0
+#define TRACE_DIVERGENCE() (void)0
+#endif
+#if SHADOW_PROVENANCE
+#include "Provenance.hpp"
+#define PROVENANCE_INPUT(pc, var) real::Provenance::INSTANCE.input(pc, (var).errorCausingCalculationIDOfLastCheck, (var).relativeErrorOfLastCheck)
+#define PROVENANCE_ERROR(pc, re) real::Provenance::INSTANCE.error(pc, re)
+#else
+#define PROVENANCE_INPUT(pc, var) (void)0
+#define PROVENANCE_ERROR(pc, re) (void)0
+#endif
 
 #define MAX_ULONG 0xFFFFFFFFFFFFFFFF
 
@@ -50,11 +77,83 @@ namespace real
         }
     };
 
+    // distance of a and b in ulps: the bit patterns, ordered as integers (negatives mirrored), subtracted
+    inline uint64 ulpDistance(double a, double b)
+    {
+        int64_t ia, ib;
+        std::memcpy(&ia, &a, sizeof(ia));
+        std::memcpy(&ib, &b, sizeof(ib));
+        ia = (ia ^ ((ia >> 63) & INT64_MAX)) - (ia >> 63); // -0 and +0 are both 0
+        ib = (ib ^ ((ib >> 63) & INT64_MAX)) - (ib >> 63);
+        return ia > ib ? (uint64)ia - (uint64)ib : (uint64)ib - (uint64)ia;
+    }
+    inline uint64 ulpDistance(float a, float b)
+    {
+        int32_t ia, ib;
+        std::memcpy(&ia, &a, sizeof(ia));
+        std::memcpy(&ib, &b, sizeof(ib));
+        ia = (ia ^ ((ia >> 31) & INT32_MAX)) - (ia >> 31);
+        ib = (ib ^ ((ib >> 31) & INT32_MAX)) - (ib >> 31);
+        return ia > ib ? (uint64)((uint32_t)ia - (uint32_t)ib) : (uint64)((uint32_t)ib - (uint32_t)ia);
+    }
+
+#if ERROR_HISTOGRAM
+    // error estimates of a PC by log2 of ulps
+    struct ErrorHistogram
+    {
+        static const int BUCKETS = 64;
+
+        uint64 count;
+        uint64 histogram[BUCKETS]; // below 1 ulp in the first bucket, [2^(b-1), 2^b) ulps in bucket b
+
+        ErrorHistogram() : count(0)
+        {
+            std::memset(histogram, 0, sizeof(histogram));
+        }
+
+        // from the exponent of the estimate, which is ulps * ORIGINAL_ULP with ULP_METRIC
+        static inline int bucketOf(double re)
+        {
+            uint64 bits;
+            std::memcpy(&bits, &re, sizeof(bits));
+            int e = (int)((bits >> 52) & 0x7FF) - 1023 - ORIGINAL_ULP_EXPONENT;
+            return e < 0 ? 0 : (e >= BUCKETS - 1 ? BUCKETS - 1 : e + 1);
+        }
+
+        inline void update(double re)
+        {
+            count++;
+            histogram[bucketOf(re)]++;
+        }
+
+        // the bucket below which the fraction q of the estimates lies
+        int quantile(double q) const
+        {
+            uint64 seen = 0;
+            for (int b = 0; b < BUCKETS; b++)
+            {
+                seen += histogram[b];
+                if (seen >= q * count)
+                    return b;
+            }
+            return BUCKETS - 1;
+        }
+
+        // the upper bound of bucket b, the last one is open
+        static std::string bound(int b)
+        {
+            if (b == BUCKETS - 1)
+                return ">= 2^" + std::to_string(BUCKETS - 2);
+            return "< 2^" + std::to_string(b);
+        }
+    };
+#endif
+
     struct CalculationError
     {
         // double maxRelativeError;
         // double relativeErrorOfLastCheck;
-        std::vector<SymbolicVarError> inputVars;
+        std::vector<SymbolicVarError, TrackedAllocator<SymbolicVarError, MEM_ERRORS>> inputVars;
 
         CalculationError() {}
         //: maxRelativeError(0),relativeErrorOfLastCheck(0) {}
@@ -77,6 +176,43 @@ namespace real
         }
     };
 
+#if TRACK_CONDITION
+    // local condition numbers of the operations at a PC, see ConditionPort.hpp
+    struct ConditionRecord
+    {
+        static const int BUCKETS = 64;
+
+        uint64 count;
+        uint64 flagged; // operations with a condition number of at least 2^CONDITION_FLAG_BITS
+        double maxCondition;
+        uint64 histogram[BUCKETS]; // by floor(log2(condition number)), below 1 in the first bucket
+
+        ConditionRecord() : count(0), flagged(0), maxCondition(0)
+        {
+            std::memset(histogram, 0, sizeof(histogram));
+        }
+
+        static inline int bucketOf(double k)
+        {
+            uint64 bits;
+            std::memcpy(&bits, &k, sizeof(bits));
+            int e = (int)((bits >> 52) & 0x7FF) - 1023;
+            return e < 0 ? 0 : (e >= BUCKETS ? BUCKETS - 1 : e);
+        }
+
+        inline void update(double k)
+        {
+            int b = bucketOf(k);
+            count++;
+            histogram[b]++;
+            if (b >= CONDITION_FLAG_BITS)
+                flagged++;
+            if (maxCondition < k)
+                maxCondition = k;
+        }
+    };
+#endif
+
     struct ProgramErrorState
     {
         uint64 programCounter;
@@ -90,6 +226,13 @@ namespace real
         CalculationError errors[PC_COUNT];
 #else
         CalculationError *errors;
+        uint64 errorCount;
+#endif
+#if TRACK_CONDITION
+        std::vector<ConditionRecord, TrackedAllocator<ConditionRecord, MEM_ERRORS>> conditions;
+#endif
+#if ERROR_HISTOGRAM
+        std::vector<ErrorHistogram, TrackedAllocator<ErrorHistogram, MEM_ERRORS>> histograms;
 #endif
         ProgramErrorState() : programCounter(0), symbolicVarId(0), locationStrings(nullptr)
         {
@@ -98,6 +241,7 @@ namespace real
             setLocationStrings(PATH_STRINGS);
 #else
             errors = nullptr;
+            errorCount = 0;
 #endif
 
 #if ACTIVE_TRACK_ERROR && TRACKING_ON==false
@@ -106,14 +250,19 @@ namespace real
             std::cout 
                     << "Tracking Error: "<<TRACK_ERROR<<"\n"
                     << "Active Tracking Error: "<<ACTIVE_TRACK_ERROR<<"\n"
-                    << "Tracking On: "<<TRACKING_ON<<"\n";
+                    << "Tracking On: "<<TRACKING_ON<<"\n"
+                    << "Tracking Condition: "<<TRACK_CONDITION<<"\n";
         }
         ~ProgramErrorState()
         {
+#if TRACK_CONDITION
+            reportConditions(std::cout);
+#endif
 #ifndef PC_COUNT
             if (errors)
             {
                 delete[] errors;
+                MEMSTATS_FREE(MEM_ERRORS, errorCount * sizeof(CalculationError));
                 errors = nullptr;
             }
 #endif
@@ -123,6 +272,8 @@ namespace real
         void initErrors(uint64 count)
         {
             errors = new CalculationError[count];
+            errorCount = count;
+            MEMSTATS_ALLOC(MEM_ERRORS, count * sizeof(CalculationError));
         }
 #endif
 
@@ -149,6 +300,8 @@ namespace real
             if(!tracking) return;
 #endif
             var.initError(re, programCounter);
+            PROFILE_ERROR(programCounter, re);
+            TRACE_ERROR(programCounter, re);
         }
 
         inline void updateError(SymbolicVarError &var, double re)
@@ -157,6 +310,14 @@ namespace real
             if(!tracking) return;
 #endif
             var.update(re, programCounter);
+            PROFILE_ERROR(programCounter, re);
+            TRACE_ERROR(programCounter, re);
+            PROVENANCE_ERROR(programCounter, re);
+#if ERROR_HISTOGRAM
+            if (real_unlikely(programCounter >= histograms.size()))
+                histograms.resize(programCounter + 1);
+            histograms[programCounter].update(re);
+#endif
         }
 
         inline void updateSymbolicVarError(const SymbolicVarError &var)
@@ -164,6 +325,8 @@ namespace real
 #if ACTIVE_TRACK_ERROR && TRACKING_ON==false
             if(!tracking) return;
 #endif
+            TRACE_EDGE(programCounter, var);
+            PROVENANCE_INPUT(programCounter, var);
 #ifndef PC_COUNT
             if (errors)
             {
@@ -174,46 +337,172 @@ namespace real
 #endif
         }
 
-        void visualizeTo(const std::string &filename, const SymbolicVarError &root, const std::string &name)
+#if TRACK_CONDITION
+        inline void updateCondition(double k)
+        {
+            if (k != k)
+                k = INFINITY; // e.g., inf - inf
+            if (programCounter >= conditions.size())
+                conditions.resize(programCounter + 1);
+            conditions[programCounter].update(k);
+            PROFILE_ERROR(programCounter, k * ORIGINAL_ULP); // the error bound of exact operands rounded once
+            TRACE_ERROR(programCounter, k * ORIGINAL_ULP);
+        }
+
+        // PCs whose maximal condition number reaches 2^CONDITION_FLAG_BITS, with their histograms
+        void reportConditions(std::ostream &stream)
+        {
+            uint64 total = 0, flagged = 0, pcs = 0;
+            for (uint64 pc = 0; pc < conditions.size(); pc++)
+            {
+                auto &c = conditions[pc];
+                total += c.count;
+                flagged += c.flagged;
+                if (c.flagged == 0)
+                    continue;
+                pcs++;
+                stream << "[CONDITION]\tPC " << pc;
+                if (locationStrings != nullptr)
+                    stream << " (" << shortPathName(locationStrings[pc]) << ")";
+                stream << ": max " << c.maxCondition << ", " << c.flagged << " of " << c.count << " operations flagged\n";
+                stream << "[CONDITION]\t\tlog2 histogram:";
+                for (int b = 0; b < ConditionRecord::BUCKETS; b++)
+                {
+                    if (c.histogram[b] != 0)
+                        stream << " " << b << ":" << c.histogram[b];
+                }
+                stream << "\n";
+            }
+            stream << "[CONDITION]\t" << pcs << " PCs flagged, " << flagged << " of " << total
+                   << " operations with condition numbers of at least 2^" << CONDITION_FLAG_BITS << "\n";
+        }
+#endif
+
+#if ERROR_HISTOGRAM
+        // per PC, the number of estimates, their median and 99th percentile and the log2 histogram of ulps
+        void reportHistograms(std::ostream &stream)
+        {
+            uint64 total = 0, pcs = 0;
+            for (uint64 pc = 0; pc < histograms.size(); pc++)
+            {
+                auto &h = histograms[pc];
+                if (h.count == 0)
+                    continue;
+                total += h.count;
+                pcs++;
+                stream << "[HISTOGRAM]\tPC " << pc;
+                if (locationStrings != nullptr)
+                    stream << " (" << shortPathName(locationStrings[pc]) << ")";
+                stream << ": " << h.count << " estimates, median " << ErrorHistogram::bound(h.quantile(0.5))
+                       << " ulps, 99% " << ErrorHistogram::bound(h.quantile(0.99)) << " ulps\n";
+                stream << "[HISTOGRAM]\t\tlog2 histogram:";
+                for (int b = 0; b < ErrorHistogram::BUCKETS - 1; b++)
+                {
+                    if (h.histogram[b] != 0)
+                        stream << " " << b << ":" << h.histogram[b];
+                }
+                if (h.histogram[ErrorHistogram::BUCKETS - 1] != 0)
+                    stream << " >=2^" << ErrorHistogram::BUCKETS - 2 << ":" << h.histogram[ErrorHistogram::BUCKETS - 1];
+                stream << "\n";
+            }
+            stream << "[HISTOGRAM]\t" << total << " estimates at " << pcs << " PCs\n";
+        }
+#endif
+
+        void visualizeTo(const std::string &filename, const SymbolicVarError &root, const std::string &name);
+        void visualize(std::ostream &stream, const SymbolicVarError &root, const std::string &name);
+
+        static std::string shortPathName(const std::string &path)
+        {
+            size_t pos = path.find_last_of('/', path.size());
+            if(pos==-1)
+            {
+                return path;
+            }
+            else
+            {
+                return path.substr(pos+1, path.size()-1-pos);
+            }
+        }
+    };
+
+    // the part of the error graph reachable from the error of a shadow value, copied out of ProgramErrorState,
+    // so that it can be written later, e.g., by the reporting thread (see AsyncReport.hpp)
+    struct ErrorGraph
+    {
+        SymbolicVarError root;
+        const char **locationStrings;
+        std::vector<uint64> pcs;     // sorted
+        std::vector<uint64> offsets; // the input variables of pcs[i] are vars[offsets[i]] to vars[offsets[i + 1] - 1]
+        std::vector<SymbolicVarError> vars;
+
+        ErrorGraph(const ProgramErrorState &state, const SymbolicVarError &r) : root(r), locationStrings(state.locationStrings)
         {
-            std::ofstream outfile;
-            outfile.open(filename, std::ios::out | std::ios::trunc);
-            visualize(outfile, root, name);
-            outfile.flush();
-            outfile.close();
+            std::vector<uint64> marks; // one bit per PC
+            std::vector<uint64> work = {root.errorCausingCalculationID, root.errorCausingCalculationIDOfLastCheck};
+            while (!work.empty())
+            {
+                uint64 pc = work.back();
+                work.pop_back();
+                if ((pc >> 6) >= marks.size())
+                    marks.resize((pc >> 6) + 1, 0);
+                if ((marks[pc >> 6] >> (pc & 63)) & 1)
+                    continue;
+                marks[pc >> 6] |= 1UL << (pc & 63);
+                pcs.push_back(pc);
+#ifndef PC_COUNT
+                if (state.errors == nullptr)
+                    continue;
+#endif
+                for (auto &var : state.errors[pc].inputVars)
+                {
+                    work.push_back(var.errorCausingCalculationID);
+                    work.push_back(var.errorCausingCalculationIDOfLastCheck);
+                }
+            }
+            std::sort(pcs.begin(), pcs.end());
+            offsets.push_back(0);
+            for (uint64 pc : pcs)
+            {
+#ifndef PC_COUNT
+                if (state.errors != nullptr)
+#endif
+                    vars.insert(vars.end(), state.errors[pc].inputVars.begin(), state.errors[pc].inputVars.end());
+                offsets.push_back(vars.size());
+            }
         }
 
-        void visualize(std::ostream &stream, const SymbolicVarError &root, const std::string &name)
+        void writeDot(std::ostream &stream, const std::string &name) const
         {
-            std::set<void *> visited;
             stream << "digraph root {\n";
             stream << "subgraph maxError {\n";
-            visualize(true, true, stream, root, name, visited);
+            writeDot(true, stream, name);
             stream << "};\n";
-            visited.clear();
             stream << "subgraph lastError {\n";
-            visualize(false, true, stream, root, name, visited);
+            writeDot(false, stream, name);
             stream << "};\n";
             stream << "}";
         }
 
-        void visualize(bool max, bool critical, std::ostream &stream, const SymbolicVarError &var, const std::string &name, std::set<void *> &visited, const std::string *from = nullptr)
+    private:
+        uint64 indexOf(uint64 pc) const
+        {
+            return std::lower_bound(pcs.begin(), pcs.end(), pc) - pcs.begin();
+        }
+
+        void writeVar(bool max, bool critical, std::ostream &stream, const SymbolicVarError &var, const std::string &name, const std::string *from) const
         {
-            if (visited.count((void *)&var) != 0)
-                return;
-            visited.insert((void *)&var);
             stream << (max ? "MAX_" : "LAST_") << name
                    << " [shape=record, label=\"{"
                    << name << "|";
-            if(max) 
+            if(max)
                 stream << "MRE=" << var.maxRelativeError;
-            else 
+            else
                 stream << "LRE=" << var.relativeErrorOfLastCheck;
             stream << "}\"";
             if(critical)
                 stream << ", color=\"red\", penwidth=2.0";
             stream << "];\n";
-            uint64 causing = max ? var.errorCausingCalculationID : var.errorCausingCalculationIDOfLastCheck;
             if (from != nullptr)
             {
                 stream << (max ? "MAX_" : "LAST_") << *from << "->" << (max ? "MAX_" : "LAST_") << name;
@@ -221,70 +510,100 @@ namespace real
                     stream << "[color=\"red\", penwidth=2.0]";
                 stream << ";\n";
             }
-            visualize(max, critical, stream, causing, visited, &name);
         }
-        std::string shortPathName(const std::string &path)
+
+        // depth first from the root, every PC once, with the edge from the variable that reaches it first;
+        // the inputs of a critical PC with at least 1/1.1 of its largest error are critical
+        void writeDot(bool max, std::ostream &stream, const std::string &name) const
         {
-            size_t pos = path.find_last_of('/', path.size());
-            if(pos==-1)
-            {
-                return path;
-            }
-            else
+            struct Frame
             {
-                return path.substr(pos+1, path.size()-1-pos);
-            }
-        }
-        void visualize(bool max, bool critical, std::ostream &stream, uint64 PC, std::set<void *> &visited, const std::string *from = nullptr)
-        {
-            if (visited.count((void *)&errors[PC]) != 0)
-                return;
-            visited.insert((void *)&errors[PC]);
-            auto &calc = errors[PC];
+                uint64 index;
+                uint64 next;
+                bool critical;
+                double mre;
+                std::string name;
+            };
+            std::vector<bool> visited(pcs.size(), false);
+            std::vector<Frame> stack;
+            auto causing = [max](const SymbolicVarError &var) {
+                return max ? var.errorCausingCalculationID : var.errorCausingCalculationIDOfLastCheck;
+            };
+            auto errorOf = [max](const SymbolicVarError &var) {
+                return max ? var.maxRelativeError : var.relativeErrorOfLastCheck;
+            };
+            auto enter = [&](uint64 pc, bool critical, const std::string &from) {
+                uint64 index = indexOf(pc);
+                if (index == pcs.size() || pcs[index] != pc || visited[index])
+                    return;
+                visited[index] = true;
 
-            std::ostringstream calcNameString("");
-            calcNameString << "_CALC_" << PC << "";
-            std::string name = calcNameString.str();
-
-            stream << (max ? "MAX_" : "LAST_") << name
-                   << " [shape=ellipse, label=\""
-                   << PC << ":" << shortPathName(locationStrings[PC]) << "\"";
-            if(critical)
+                std::ostringstream calcNameString("");
+                calcNameString << "_CALC_" << pc << "";
+                std::string calcName = calcNameString.str();
+                stream << (max ? "MAX_" : "LAST_") << calcName
+                       << " [shape=ellipse, label=\"" << pc << ":";
+                if (locationStrings != nullptr)
+                    stream << ProgramErrorState::shortPathName(locationStrings[pc]);
+                stream << "\"";
+                if(critical)
                     stream << ", color=\"red\", penwidth=2.0";
-            stream << "];\n";
-            if (from != nullptr)
-            {
-                stream << (max ? "MAX_" : "LAST_") << *from << "->" << (max ? "MAX_" : "LAST_") << name ;
+                stream << "];\n";
+                stream << (max ? "MAX_" : "LAST_") << from << "->" << (max ? "MAX_" : "LAST_") << calcName;
                 if(critical)
                     stream << "[color=\"red\", penwidth=2.0]";
                 stream << ";\n";
-            }
 
-            double mre = 0;
-            if(critical)
-            {
-                for (int i = 0, size = calc.inputVars.size(); i < size; i++)
+                double mre = 0;
+                if(critical)
                 {
-                    auto &var = calc.inputVars[i];
-                    double re = max ? var.maxRelativeError : var.relativeErrorOfLastCheck;
-                    if(re>mre) mre = re;
-                }    
-            }
+                    for (uint64 i = offsets[index]; i < offsets[index + 1]; i++)
+                    {
+                        double re = errorOf(vars[i]);
+                        if(re>mre) mre = re;
+                    }
+                }
+                stack.push_back({index, 0, critical, mre, calcName});
+            };
 
-            for (int i = 0, size = calc.inputVars.size(); i < size; i++)
+            writeVar(max, true, stream, root, name, nullptr);
+            enter(causing(root), true, name);
+            while (!stack.empty())
             {
-                auto &var = calc.inputVars[i];
-                double re = max ? var.maxRelativeError : var.relativeErrorOfLastCheck;
-                bool ncritical = critical && mre!=0 && (mre < re * 1.1);
+                Frame &f = stack.back();
+                if (offsets[f.index] + f.next == offsets[f.index + 1])
+                {
+                    stack.pop_back();
+                    continue;
+                }
+                uint64 i = f.next++;
+                const SymbolicVarError &var = vars[offsets[f.index] + i];
+                double re = errorOf(var);
+                bool ncritical = f.critical && f.mre!=0 && (f.mre < re * 1.1);
                 std::ostringstream namestream("");
-                namestream << "_CALC_" << PC << "_" << i;
+                namestream << "_CALC_" << pcs[f.index] << "_" << i;
                 std::string varName = namestream.str();
-                visualize(max, ncritical, stream, var, varName, visited, &name);
+                writeVar(max, ncritical, stream, var, varName, &f.name);
+                enter(causing(var), ncritical, varName); // may reallocate the stack
             }
         }
     };
 
-#if TRACK_ERROR
+    inline void ProgramErrorState::visualizeTo(const std::string &filename, const SymbolicVarError &root, const std::string &name)
+    {
+        std::ofstream outfile;
+        outfile.open(filename, std::ios::out | std::ios::trunc);
+        visualize(outfile, root, name);
+        outfile.flush();
+        outfile.close();
+    }
+
+    inline void ProgramErrorState::visualize(std::ostream &stream, const SymbolicVarError &root, const std::string &name)
+    {
+        ErrorGraph(*this, root).writeDot(stream, name);
+    }
+
+#if TRACK_ERROR || TRACK_CONDITION
     static ProgramErrorState programErrorState;
 
 #define ERROR_STATE real::programErrorState
@@ -0,0 +1,239 @@
+#ifndef ERROR_TRACE_HPP
+#define ERROR_TRACE_HPP
+/*
+Writer of the binary error trace (SHADOW_TRACE), see TraceFormat.h for the format and bin/easttrace for queries.
+Every SHADOW_TRACE_PERIOD-th error estimate (ProgramErrorState::updateError and updateCondition) and provenance
+edge with an error (updateSymbolicVarError: the PC that reads a value <- the PC that caused its largest error) is
+recorded, and every control-flow divergence of EAST_CONDITION. The time of a record is its seq, the number of PCs executed so far.
+Records are buffered by kind and written in blocks of SHADOW_TRACE_BLOCK records, and the trace is closed at exit.
+*/
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include "RealConfigure.h"
+#include "RealUtil.hpp"
+#include "TraceFormat.h"
+
+namespace real
+{
+    struct ErrorTrace
+    {
+        struct Buffer
+        {
+            trace::Kind kind;
+            std::vector<float> errors;
+            std::vector<uint64> seqs;
+            std::vector<uint64> pcs;
+            std::vector<uint64> causes;
+            double maxError;
+
+            Buffer(trace::Kind k) : kind(k), maxError(0) {}
+        };
+
+        FILE *file;
+        bool failed; // SHADOW_TRACE_FILE could not be opened, records are dropped
+        uint64 seq;
+        uint64 pc;
+        uint64 sampleCountdown;
+        uint64 edgeCountdown;
+        uint64 startTime;
+        std::chrono::steady_clock::time_point start;
+        Buffer samples;
+        Buffer edges;
+        Buffer divergences;
+        std::vector<uint8_t> payload;
+
+        static ErrorTrace INSTANCE;
+
+        ErrorTrace() : file(nullptr), failed(false), seq(0), pc(0), sampleCountdown(1), edgeCountdown(1), samples(trace::SAMPLES), edges(trace::EDGES), divergences(trace::DIVERGENCES)
+        {
+            start = std::chrono::steady_clock::now();
+            startTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        ~ErrorTrace()
+        {
+            close();
+        }
+
+        inline void enter(uint64 id)
+        {
+            seq++;
+            pc = id;
+        }
+
+        inline void sample(uint64 at, double re)
+        {
+            if (--sampleCountdown != 0)
+                return;
+            sampleCountdown = SHADOW_TRACE_PERIOD;
+            add(samples, at, re);
+            if (real_unlikely(samples.seqs.size() == SHADOW_TRACE_BLOCK))
+                write(samples);
+        }
+
+        inline void edge(uint64 at, uint64 cause, double re)
+        {
+            if (re == 0 || --edgeCountdown != 0)
+                return; // exact values explain nothing
+            edgeCountdown = SHADOW_TRACE_PERIOD;
+            add(edges, at, re);
+            edges.causes.push_back(cause);
+            if (real_unlikely(edges.seqs.size() == SHADOW_TRACE_BLOCK))
+                write(edges);
+        }
+
+        void divergence()
+        {
+            add(divergences, pc, 0);
+            if (divergences.seqs.size() == SHADOW_TRACE_BLOCK)
+                write(divergences);
+        }
+
+        void close()
+        {
+            write(samples);
+            write(edges);
+            write(divergences);
+            if (file == nullptr)
+                return; // nothing traced, or the trace could not be opened
+            writeLocations();
+            fclose(file);
+            file = nullptr;
+        }
+
+    private:
+        inline void add(Buffer &b, uint64 at, double re)
+        {
+            b.errors.push_back((float)re);
+            b.seqs.push_back(seq);
+            b.pcs.push_back(at);
+            if (b.maxError < re)
+                b.maxError = re;
+        }
+
+        bool open()
+        {
+            if (file != nullptr)
+                return true;
+            if (failed)
+                return false;
+            file = fopen(SHADOW_TRACE_FILE, "wb");
+            if (file == nullptr)
+            {
+                failed = true;
+                std::cerr << "Warning! Failed to open the error trace " << SHADOW_TRACE_FILE << ", nothing is traced\n";
+                return false;
+            }
+            trace::FileHeader h;
+            memset(&h, 0, sizeof(h));
+            memcpy(h.magic, trace::FILE_MAGIC, sizeof(h.magic));
+            h.version = trace::VERSION;
+            h.headerBytes = sizeof(h);
+            h.startTime = startTime;
+            h.period = SHADOW_TRACE_PERIOD;
+            fwrite(&h, sizeof(h), 1, file);
+            return true;
+        }
+
+        void writeBlock(trace::BlockHeader &h)
+        {
+            static const char zeros[8] = {0};
+            h.magic = trace::BLOCK_MAGIC;
+            h.payloadBytes = payload.size();
+            h.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            fwrite(&h, sizeof(h), 1, file);
+            fwrite(payload.data(), 1, payload.size(), file);
+            fwrite(zeros, 1, trace::padded(payload.size()) - payload.size(), file);
+            fflush(file); // complete blocks survive a crash
+        }
+
+        // appends a varint column, returns its bytes
+        uint32_t putColumn(const std::vector<uint64> &values, bool delta)
+        {
+            size_t begin = payload.size();
+            payload.resize(begin + values.size() * 10);
+            uint8_t *p = payload.data() + begin;
+            uint64 last = 0;
+            for (uint64 v : values)
+            {
+                p = trace::putVarint(p, delta ? v - last : v);
+                last = v;
+            }
+            payload.resize(p - payload.data());
+            return payload.size() - begin;
+        }
+
+        void write(Buffer &b)
+        {
+            if (b.seqs.empty())
+                return;
+            if (!open())
+            {
+                clear(b);
+                return;
+            }
+            trace::BlockHeader h;
+            memset(&h, 0, sizeof(h));
+            h.kind = b.kind;
+            h.count = b.seqs.size();
+            h.firstSeq = b.seqs.front();
+            h.lastSeq = b.seqs.back();
+            h.minPc = *std::min_element(b.pcs.begin(), b.pcs.end());
+            h.maxPc = *std::max_element(b.pcs.begin(), b.pcs.end());
+            h.maxError = b.maxError;
+
+            payload.clear();
+            int c = 0;
+            if (b.kind != trace::DIVERGENCES)
+            {
+                payload.resize(b.errors.size() * sizeof(float));
+                memcpy(payload.data(), b.errors.data(), payload.size());
+                h.columnBytes[c++] = payload.size();
+            }
+            h.columnBytes[c++] = putColumn(b.seqs, true);
+            h.columnBytes[c++] = putColumn(b.pcs, false);
+            if (b.kind == trace::EDGES)
+                h.columnBytes[c++] = putColumn(b.causes, false);
+            writeBlock(h);
+            clear(b);
+        }
+
+        static void clear(Buffer &b)
+        {
+            b.errors.clear();
+            b.seqs.clear();
+            b.pcs.clear();
+            b.causes.clear();
+            b.maxError = 0;
+        }
+
+        void writeLocations()
+        {
+#ifdef PC_COUNT
+            if (!open())
+                return;
+            trace::BlockHeader h;
+            memset(&h, 0, sizeof(h));
+            h.kind = trace::LOCATIONS;
+            h.count = PC_COUNT;
+            h.maxPc = PC_COUNT - 1;
+            payload.clear();
+            for (uint64 i = 0; i < PC_COUNT; i++)
+            {
+                size_t n = strlen(PATH_STRINGS[i]);
+                uint8_t length[10];
+                payload.insert(payload.end(), length, trace::putVarint(length, n));
+                payload.insert(payload.end(), PATH_STRINGS[i], PATH_STRINGS[i] + n);
+            }
+            h.columnBytes[0] = payload.size();
+            writeBlock(h);
+#endif
+        }
+    };
+    ErrorTrace ErrorTrace::INSTANCE;
+}; // namespace real
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef FLOAT128_PORT_HPP
+#define FLOAT128_PORT_HPP
+/*
+IEEE binary128 shadows on the compiler's __float128, with libquadmath for the math functions
+(link with -lquadmath). A shadow is a fixed 16-byte value with a 113-bit significand, without heap
+allocation, and every operation is correctly rounded as IEEE 754 requires. It is more precise than DD
+(about 106 bits, faster) and cheaper than MPFR (any precision, heap-allocated).
+*/
+#include <iomanip>
+#include <cmath>
+#include <quadmath.h>
+
+namespace real
+{
+    namespace quad
+    {
+        typedef __float128 float128;
+
+        // the high word of d replaces the high word of the leading double, as the x[0] of DD, see Real::reloadHigh
+        inline void copyExp(float128 &r, double d)
+        {
+            double h = (double)r;
+            float128 tail = r - h;
+            __HI(h) = __HI(d);
+            r = h + tail;
+        }
+
+        // the low word of the leading double and the tail are cleared, see Real::reloadLow
+        inline void clearLows(float128 &r)
+        {
+            double d = (double)r;
+            __LO(d) = 0;
+            r = d;
+        }
+
+        inline std::ostream &print(std::ostream &os, const float128 &r)
+        {
+            char buffer[64];
+            quadmath_snprintf(buffer, sizeof(buffer), "%+.34Qe", r);
+            return os << buffer;
+        }
+    }; // namespace quad
+};     // namespace real
+
+#define HP_TYPE real::quad::float128
+
+#define ADD_RR(t, l, r) t = l + r
+#define SUB_RR(t, l, r) t = l - r
+#define MUL_RR(t, l, r) t = l * r
+#define DIV_RR(t, l, r) t = l / r
+
+#define ADD_RD(t, l, r) t = l + (HP_TYPE)(r)
+#define SUB_RD(t, l, r) t = l - (HP_TYPE)(r)
+#define SUB_DR(t, l, r) t = (HP_TYPE)(l) - r
+#define MUL_RD(t, l, r) t = l * (HP_TYPE)(r)
+#define DIV_RD(t, l, r) t = l / (HP_TYPE)(r)
+#define DIV_DR(t, l, r) t = (HP_TYPE)(l) / r
+
+#define ASSIGN(l,r) l = r
+#define ASSIGN_D(l,r) l = r
+#define SWAP(l,r) l = r
+
+#define INIT(r, p) /*DO NOTHING*/
+#define CLEAR(r) /*DO NOTHING*/
+
+#define TO_DOUBLE(r) ((double)(r))
+
+#define FMA(t, l, m, r) t = fmaq(l, m, r)
+#define FMS(t, l, m, r) t = fmaq(l, m, -(r))
+#define FNMA(t, l, m, r) t = fmaq(-(l), m, r)
+
+#if KEEP_ORIGINAL
+#define STREAM_OUT(os, r)  {\
+    std::ios_base::fmtflags old_flags = os.flags(); \
+    std::streamsize old_prec = os.precision(19); \
+    os << std::scientific; \
+    os << "[ "; \
+    real::quad::print(os, r.shadow->shadowValue) << " ]"; \
+    os << " (original = " << r.shadow->originalValue <<")"; \
+    os.precision(old_prec); \
+    os.flags(old_flags); \
+}
+#else
+#define STREAM_OUT(os, r)  {\
+    os << "[ "; \
+    real::quad::print(os, r.shadow->shadowValue) << " ]"; \
+}
+#endif
+
+#define LESS_RR(l,r) l<r
+#define LESSEQ_RR(l,r) l<=r
+#define EQUAL_RR(l,r) l==r
+#define GREATER_RR(l,r) l>r
+#define GREATEREQ_RR(l,r) l>=r
+
+#define EXP_R(res, r) res = expq(r)
+#define POW_RR(res, a, b) res = powq(a, b)
+#define SQRT_R(res, r) res = sqrtq(r)
+
+// <math.h>
+#define LOG_R(res, r) res = logq(r)
+#define LOG10_R(res, r) res = log10q(r)
+#define LOG2_R(res, r) res = log2q(r)
+#define LOG1P_R(res, r) res = log1pq(r)
+#define EXPM1_R(res, r) res = expm1q(r)
+#define SIN_R(res, r) res = sinq(r)
+#define COS_R(res, r) res = cosq(r)
+#define TAN_R(res, r) res = tanq(r)
+#define ASIN_R(res, r) res = asinq(r)
+#define ACOS_R(res, r) res = acosq(r)
+#define ATAN_R(res, r) res = atanq(r)
+#define SINH_R(res, r) res = sinhq(r)
+#define COSH_R(res, r) res = coshq(r)
+#define TANH_R(res, r) res = tanhq(r)
+#define ASINH_R(res, r) res = asinhq(r)
+#define ACOSH_R(res, r) res = acoshq(r)
+#define ATANH_R(res, r) res = atanhq(r)
+#define FABS_R(res, r) res = fabsq(r)
+#define FLOOR_R(res, r) res = floorq(r)
+#define CEIL_R(res, r) res = ceilq(r)
+#define TRUNC_R(res, r) res = truncq(r)
+#define ROUND_R(res, r) res = roundq(r)
+#define CBRT_R(res, r) res = cbrtq(r)
+#define ERF_R(res, r) res = erfq(r)
+#define ERFC_R(res, r) res = erfcq(r)
+#define ATAN2_RR(res, a, b) res = atan2q(a, b)
+#define FMOD_RR(res, a, b) res = fmodq(a, b)
+#define FMIN_RR(res, a, b) res = fminq(a, b)
+#define FMAX_RR(res, a, b) res = fmaxq(a, b)
+#define HYPOT_RR(res, a, b) res = hypotq(a, b)
+
+#define COPY_EXP_D(res, d) real::quad::copyExp(res, d)
+#define CLEAR_LOWS(res) real::quad::clearLows(res)
+#endif
@@ -0,0 +1,414 @@
+#ifndef INTERVAL_MATH_HPP
+#define INTERVAL_MATH_HPP
+/*
+Interval arithmetic with outward rounding for INTERVAL_PORT and AFFINE_PORT.
+The rounding mode is never switched: an operation is rounded to nearest, and the sign of its exact
+rounding error (two-sum, two-prod, fma remainders) tells whether the nearest result is already the
+lower or upper bound, or whether the bound is the neighbouring double.
++, -, *, / and sqrt are rigorous. The other functions assume that libm results are within
+INTERVAL_LIBM_ULPS ulps, and widen their bounds by that many ulps.
+*/
+#include <cmath>
+#include <cstring>
+#include <cfloat>
+#include <algorithm>
+
+#ifndef INTERVAL_LIBM_ULPS
+#define INTERVAL_LIBM_ULPS 2
+#endif
+
+namespace real
+{
+    namespace interval
+    {
+        struct Interval
+        {
+            double lo;
+            double hi;
+        };
+
+        static const double PI_DOWN = 3.141592653589793116;  // round-to-nearest pi is below pi
+        static const double PI_UP = 3.141592653589793560;
+        // below it, the rounding error of a product, quotient or square root may not be representable and its remainder
+        // can flush to 0 or lose its sign, results that small are widened without looking at the remainder
+        static const double TINY = DBL_MIN * 0x1p53;
+
+        inline double nextUp(double x)
+        {
+            if (x != x || x == INFINITY)
+                return x;
+            if (x == 0)
+                return 0x1p-1074;
+            int64_t bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+            bits += x > 0 ? 1 : -1;
+            std::memcpy(&x, &bits, sizeof(bits));
+            return x;
+        }
+
+        inline double nextDown(double x)
+        {
+            return -nextUp(-x);
+        }
+
+        // s is the nearest of an exact result that is s + (something with the sign of e)
+        inline double down(double s, double e)
+        {
+            if (std::isinf(s))
+                return s > 0 ? DBL_MAX : s; // overflow of a finite result, inf operands give nan e
+            return e < 0 ? nextDown(s) : s;
+        }
+
+        inline double up(double s, double e)
+        {
+            if (std::isinf(s))
+                return s < 0 ? -DBL_MAX : s;
+            return e > 0 ? nextUp(s) : s;
+        }
+
+        inline double twoSumError(double a, double b, double s)
+        {
+            double bb = s - a;
+            return (a - (s - bb)) + (b - bb);
+        }
+
+        inline double addDown(double a, double b)
+        {
+            double s = a + b;
+            if (std::isinf(a) || std::isinf(b))
+                return s;
+            return down(s, twoSumError(a, b, s));
+        }
+
+        inline double addUp(double a, double b)
+        {
+            double s = a + b;
+            if (std::isinf(a) || std::isinf(b))
+                return s;
+            return up(s, twoSumError(a, b, s));
+        }
+
+        // 0 * inf is 0 for interval bounds
+        inline double mulDown(double a, double b)
+        {
+            if (a == 0 || b == 0)
+                return 0;
+            double p = a * b;
+            if (std::isinf(a) || std::isinf(b))
+                return p;
+            if (std::fabs(p) < TINY)
+                return nextDown(p); // also an underflow to 0
+            return down(p, std::fma(a, b, -p));
+        }
+
+        inline double mulUp(double a, double b)
+        {
+            if (a == 0 || b == 0)
+                return 0;
+            double p = a * b;
+            if (std::isinf(a) || std::isinf(b))
+                return p;
+            if (std::fabs(p) < TINY)
+                return nextUp(p);
+            return up(p, std::fma(a, b, -p));
+        }
+
+        // the sign of a/b - q is the sign of the remainder a - q*b times the sign of b
+        inline double divDown(double a, double b)
+        {
+            double q = a / b;
+            if (std::isinf(a) || std::isinf(b) || a == 0)
+                return q;
+            if (std::fabs(q) < TINY || std::fabs(a) < TINY)
+                return nextDown(q);
+            double r = std::fma(-q, b, a);
+            return down(q, b > 0 ? r : -r);
+        }
+
+        inline double divUp(double a, double b)
+        {
+            double q = a / b;
+            if (std::isinf(a) || std::isinf(b) || a == 0)
+                return q;
+            if (std::fabs(q) < TINY || std::fabs(a) < TINY)
+                return nextUp(q);
+            double r = std::fma(-q, b, a);
+            return up(q, b > 0 ? r : -r);
+        }
+
+        inline double sqrtDown(double a)
+        {
+            double s = std::sqrt(a);
+            if (std::isinf(s) || s == 0)
+                return s;
+            if (a < TINY)
+                return nextDown(s);
+            return down(s, std::fma(-s, s, a));
+        }
+
+        inline double sqrtUp(double a)
+        {
+            double s = std::sqrt(a);
+            if (std::isinf(s) || s == 0)
+                return s;
+            if (a < TINY)
+                return nextUp(s);
+            return up(s, std::fma(-s, s, a));
+        }
+
+        // bounds of a libm result within INTERVAL_LIBM_ULPS ulps
+        inline double widenDown(double d)
+        {
+            for (int i = 0; i < INTERVAL_LIBM_ULPS; i++)
+                d = nextDown(d);
+            return d;
+        }
+
+        inline double widenUp(double d)
+        {
+            for (int i = 0; i < INTERVAL_LIBM_ULPS; i++)
+                d = nextUp(d);
+            return d;
+        }
+
+        inline Interval point(double d)
+        {
+            return {d, d};
+        }
+
+        inline Interval entire()
+        {
+            return {-INFINITY, INFINITY};
+        }
+
+        inline Interval empty()
+        {
+            return {NAN, NAN};
+        }
+
+        inline bool contains(const Interval &x, double d)
+        {
+            return x.lo <= d && d <= x.hi;
+        }
+
+        // smallest and largest magnitude
+        inline double mig(const Interval &x)
+        {
+            return contains(x, 0) ? 0 : std::min(std::fabs(x.lo), std::fabs(x.hi));
+        }
+
+        inline double mag(const Interval &x)
+        {
+            return std::max(std::fabs(x.lo), std::fabs(x.hi));
+        }
+
+        inline double mid(const Interval &x)
+        {
+            return x.lo == x.hi ? x.lo : 0.5 * x.lo + 0.5 * x.hi;
+        }
+
+        inline Interval add(const Interval &a, const Interval &b)
+        {
+            return {addDown(a.lo, b.lo), addUp(a.hi, b.hi)};
+        }
+
+        inline Interval sub(const Interval &a, const Interval &b)
+        {
+            return {addDown(a.lo, -b.hi), addUp(a.hi, -b.lo)};
+        }
+
+        inline Interval neg(const Interval &a)
+        {
+            return {-a.hi, -a.lo};
+        }
+
+        inline Interval mul(const Interval &a, const Interval &b)
+        {
+            double lo = std::min(std::min(mulDown(a.lo, b.lo), mulDown(a.lo, b.hi)), std::min(mulDown(a.hi, b.lo), mulDown(a.hi, b.hi)));
+            double hi = std::max(std::max(mulUp(a.lo, b.lo), mulUp(a.lo, b.hi)), std::max(mulUp(a.hi, b.lo), mulUp(a.hi, b.hi)));
+            return {lo, hi};
+        }
+
+        inline Interval div(const Interval &a, const Interval &b)
+        {
+            if (contains(b, 0))
+                return entire();
+            double lo = std::min(std::min(divDown(a.lo, b.lo), divDown(a.lo, b.hi)), std::min(divDown(a.hi, b.lo), divDown(a.hi, b.hi)));
+            double hi = std::max(std::max(divUp(a.lo, b.lo), divUp(a.lo, b.hi)), std::max(divUp(a.hi, b.lo), divUp(a.hi, b.hi)));
+            return {lo, hi};
+        }
+
+        inline Interval sqrt(const Interval &a)
+        {
+            if (a.hi < 0)
+                return empty();
+            return {a.lo <= 0 ? 0 : sqrtDown(a.lo), sqrtUp(a.hi)};
+        }
+
+        inline Interval fma(const Interval &l, const Interval &m, const Interval &r)
+        {
+            return add(mul(l, m), r);
+        }
+
+        // a monotone libm function on its domain [dlo, dhi]
+        template <typename F>
+        inline Interval monotone(const Interval &x, F f, bool increasing, double dlo = -INFINITY, double dhi = INFINITY)
+        {
+            double lo = std::max(x.lo, dlo), hi = std::min(x.hi, dhi);
+            if (!(lo <= hi))
+                return empty();
+            double flo = f(lo), fhi = f(hi);
+            if (!increasing)
+                std::swap(flo, fhi);
+            return {widenDown(flo), widenUp(fhi)};
+        }
+
+        // a monotone function that is exact in double
+        template <typename F>
+        inline Interval exact(const Interval &x, F f)
+        {
+            return {f(x.lo), f(x.hi)};
+        }
+
+        inline Interval clamp(const Interval &x, double lo, double hi)
+        {
+            return {std::max(x.lo, lo), std::min(x.hi, hi)};
+        }
+
+        // whether phase + 2k*pi lies in x for some k, erring on yes
+        inline bool hits(const Interval &x, double phase)
+        {
+            double k = std::ceil((x.lo - phase) / (2 * PI_DOWN) - 0x1p-40);
+            return phase + k * 2 * PI_DOWN <= x.hi + 0x1p-40 * (std::fabs(x.hi) + 1);
+        }
+
+        // sin and cos from their values at the bounds and their extrema inside
+        template <typename F>
+        inline Interval periodic(const Interval &x, F f, double phaseOfMax, double phaseOfMin)
+        {
+            if (!(x.hi - x.lo < 2 * PI_DOWN) || std::fabs(x.lo) > 0x1p30 || std::fabs(x.hi) > 0x1p30)
+                return {-1, 1};
+            double flo = f(x.lo), fhi = f(x.hi);
+            Interval r = {widenDown(std::min(flo, fhi)), widenUp(std::max(flo, fhi))};
+            if (hits(x, phaseOfMax))
+                r.hi = 1;
+            if (hits(x, phaseOfMin))
+                r.lo = -1;
+            return clamp(r, -1, 1);
+        }
+
+        inline Interval sin(const Interval &x) { return periodic(x, [](double d) { return std::sin(d); }, PI_DOWN / 2, -PI_DOWN / 2); }
+        inline Interval cos(const Interval &x) { return periodic(x, [](double d) { return std::cos(d); }, 0, PI_DOWN); }
+
+        inline Interval tan(const Interval &x)
+        {
+            if (!(x.hi - x.lo < PI_DOWN) || std::fabs(x.lo) > 0x1p30 || std::fabs(x.hi) > 0x1p30 ||
+                hits(x, PI_DOWN / 2) || hits(x, -PI_DOWN / 2))
+                return entire();
+            return monotone(x, [](double d) { return std::tan(d); }, true);
+        }
+
+        inline Interval fabs(const Interval &x)
+        {
+            if (contains(x, 0))
+                return {0, mag(x)};
+            return {mig(x), mag(x)};
+        }
+
+        inline Interval cosh(const Interval &x)
+        {
+            Interval a = fabs(x);
+            return {std::max(1.0, widenDown(std::cosh(a.lo))), widenUp(std::cosh(a.hi))};
+        }
+
+        inline Interval pow(const Interval &a, const Interval &b)
+        {
+            if (a.lo > 0)
+            {
+                // exp(b * log(a)), each step enclosed
+                Interval l = monotone(a, [](double d) { return std::log(d); }, true);
+                return monotone(mul(b, l), [](double d) { return std::exp(d); }, true);
+            }
+            if (b.lo == b.hi && b.lo == std::trunc(b.lo) && std::fabs(b.lo) < 0x1p53)
+            {
+                double n = b.lo;
+                if (n == 0)
+                    return point(1);
+                if (n < 0 && contains(a, 0))
+                    return entire();
+                // monotone on each sign of a, so the extrema are at the bounds or at 0
+                double lo = std::min(std::pow(a.lo, n), std::pow(a.hi, n));
+                double hi = std::max(std::pow(a.lo, n), std::pow(a.hi, n));
+                if (contains(a, 0))
+                    lo = std::min(lo, 0.0);
+                return {widenDown(lo), widenUp(hi)};
+            }
+            return entire();
+        }
+
+        inline Interval atan2(const Interval &y, const Interval &x)
+        {
+            if (x.lo > 0)
+                return monotone(div(y, x), [](double d) { return std::atan(d); }, true);
+            return {-PI_UP, PI_UP};
+        }
+
+        inline Interval fmod(const Interval &a, const Interval &b)
+        {
+            if (a.lo == a.hi && b.lo == b.hi)
+                return point(std::fmod(a.lo, b.lo)); // fmod is exact
+            double m = mag(b);
+            if (a.lo >= 0)
+                return {0, std::min(a.hi, m)};
+            if (a.hi <= 0)
+                return {std::max(a.lo, -m), 0};
+            return {std::max(a.lo, -m), std::min(a.hi, m)};
+        }
+
+        inline Interval fmin(const Interval &a, const Interval &b)
+        {
+            return {std::fmin(a.lo, b.lo), std::fmin(a.hi, b.hi)};
+        }
+
+        inline Interval fmax(const Interval &a, const Interval &b)
+        {
+            return {std::fmax(a.lo, b.lo), std::fmax(a.hi, b.hi)};
+        }
+
+        inline Interval hypot(const Interval &a, const Interval &b)
+        {
+            return {std::max(0.0, widenDown(std::hypot(mig(a), mig(b)))), widenUp(std::hypot(mag(a), mag(b)))};
+        }
+
+        // the largest distance from d to the enclosure x, i.e., a bound of the error of d
+        inline double errorBound(const Interval &x, double d)
+        {
+            return std::max(addUp(d, -x.lo), addUp(x.hi, -d));
+        }
+    }; // namespace interval
+};     // namespace real
+
+// enclosures of the libm functions of the port macros
+#define INTERVAL_EXP(x) real::interval::monotone(x, [](double d) { return std::exp(d); }, true)
+#define INTERVAL_LOG(x) real::interval::monotone(x, [](double d) { return std::log(d); }, true, 0)
+#define INTERVAL_LOG10(x) real::interval::monotone(x, [](double d) { return std::log10(d); }, true, 0)
+#define INTERVAL_LOG2(x) real::interval::monotone(x, [](double d) { return std::log2(d); }, true, 0)
+#define INTERVAL_LOG1P(x) real::interval::monotone(x, [](double d) { return std::log1p(d); }, true, -1)
+#define INTERVAL_EXPM1(x) real::interval::monotone(x, [](double d) { return std::expm1(d); }, true)
+#define INTERVAL_ASIN(x) real::interval::monotone(x, [](double d) { return std::asin(d); }, true, -1, 1)
+#define INTERVAL_ACOS(x) real::interval::monotone(x, [](double d) { return std::acos(d); }, false, -1, 1)
+#define INTERVAL_ATAN(x) real::interval::monotone(x, [](double d) { return std::atan(d); }, true)
+#define INTERVAL_SINH(x) real::interval::monotone(x, [](double d) { return std::sinh(d); }, true)
+#define INTERVAL_TANH(x) real::interval::monotone(x, [](double d) { return std::tanh(d); }, true)
+#define INTERVAL_ASINH(x) real::interval::monotone(x, [](double d) { return std::asinh(d); }, true)
+#define INTERVAL_ACOSH(x) real::interval::monotone(x, [](double d) { return std::acosh(d); }, true, 1)
+#define INTERVAL_ATANH(x) real::interval::monotone(x, [](double d) { return std::atanh(d); }, true, -1, 1)
+#define INTERVAL_CBRT(x) real::interval::monotone(x, [](double d) { return std::cbrt(d); }, true)
+#define INTERVAL_ERF(x) real::interval::monotone(x, [](double d) { return std::erf(d); }, true)
+#define INTERVAL_ERFC(x) real::interval::monotone(x, [](double d) { return std::erfc(d); }, false)
+#define INTERVAL_FLOOR(x) real::interval::exact(x, [](double d) { return std::floor(d); })
+#define INTERVAL_CEIL(x) real::interval::exact(x, [](double d) { return std::ceil(d); })
+#define INTERVAL_TRUNC(x) real::interval::exact(x, [](double d) { return std::trunc(d); })
+#define INTERVAL_ROUND(x) real::interval::exact(x, [](double d) { return std::round(d); })
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef INTERVAL_PORT_HPP
+#define INTERVAL_PORT_HPP
+/*
+Interval port. A shadow value is an enclosure [lo, hi] of the exact result of the computation, see
+IntervalMath.hpp. Instead of an estimate of the error of an original, it gives a guaranteed bound,
+errorBound(shadow, original), which also contains the errors of the inputs folded in by the program.
+TO_DOUBLE is the midpoint, and comparisons compare midpoints.
+*/
+#include <iomanip>
+#include "IntervalMath.hpp"
+
+#define HP_TYPE real::interval::Interval
+
+#define IV(d) real::interval::point(d)
+
+#define ADD_RR(t, l, r) t = real::interval::add(l, r)
+#define SUB_RR(t, l, r) t = real::interval::sub(l, r)
+#define MUL_RR(t, l, r) t = real::interval::mul(l, r)
+#define DIV_RR(t, l, r) t = real::interval::div(l, r)
+
+#define ADD_RD(t, l, r) t = real::interval::add(l, IV(r))
+#define SUB_RD(t, l, r) t = real::interval::sub(l, IV(r))
+#define SUB_DR(t, l, r) t = real::interval::sub(IV(l), r)
+#define MUL_RD(t, l, r) t = real::interval::mul(l, IV(r))
+#define DIV_RD(t, l, r) t = real::interval::div(l, IV(r))
+#define DIV_DR(t, l, r) t = real::interval::div(IV(l), r)
+
+#define ASSIGN(l,r) l = r
+#define ASSIGN_D(l,r) l = IV(r)
+#define SWAP(l,r) l = r
+
+#define INIT(r, p) /*DO NOTHING*/
+#define CLEAR(r) /*DO NOTHING*/
+
+#define TO_DOUBLE(r) real::interval::mid(r)
+
+#define SHADOW_ENCLOSURE(s) (s)
+
+#define FMA(t, l, m, r) t = real::interval::fma(l, m, r)
+#define FMS(t, l, m, r) t = real::interval::fma(l, m, real::interval::neg(r))
+#define FNMA(t, l, m, r) t = real::interval::fma(real::interval::neg(l), m, r)
+
+#if KEEP_ORIGINAL
+#define STREAM_OUT(os, r)  {\
+    std::ios_base::fmtflags old_flags = os.flags(); \
+    std::streamsize old_prec = os.precision(19); \
+    os << std::scientific; \
+    os << "[ " << std::setw(27) << r.shadow->shadowValue.lo << ", " << std::setw(27) << r.shadow->shadowValue.hi << " ]"; \
+    os << " (original = " << r.shadow->originalValue <<")"; \
+    os.precision(old_prec); \
+    os.flags(old_flags); \
+}
+#else
+#define STREAM_OUT(os, r)  {\
+    std::ios_base::fmtflags old_flags = os.flags(); \
+    std::streamsize old_prec = os.precision(19); \
+    os << std::scientific; \
+    os << "[ " << std::setw(27) << r.shadow->shadowValue.lo << ", " << std::setw(27) << r.shadow->shadowValue.hi << " ]"; \
+    os.precision(old_prec); \
+    os.flags(old_flags); \
+}
+#endif
+
+#define LESS_RR(l,r) (TO_DOUBLE(l) < TO_DOUBLE(r))
+#define LESSEQ_RR(l,r) (TO_DOUBLE(l) <= TO_DOUBLE(r))
+#define EQUAL_RR(l,r) (TO_DOUBLE(l) == TO_DOUBLE(r))
+#define GREATER_RR(l,r) (TO_DOUBLE(l) > TO_DOUBLE(r))
+#define GREATEREQ_RR(l,r) (TO_DOUBLE(l) >= TO_DOUBLE(r))
+
+#define EXP_R(res, r) res = INTERVAL_EXP(r)
+#define POW_RR(res, a, b) res = real::interval::pow(a, b)
+#define SQRT_R(res, r) res = real::interval::sqrt(r)
+
+// <math.h>
+#define LOG_R(res, r) res = INTERVAL_LOG(r)
+#define LOG10_R(res, r) res = INTERVAL_LOG10(r)
+#define LOG2_R(res, r) res = INTERVAL_LOG2(r)
+#define LOG1P_R(res, r) res = INTERVAL_LOG1P(r)
+#define EXPM1_R(res, r) res = INTERVAL_EXPM1(r)
+#define SIN_R(res, r) res = real::interval::sin(r)
+#define COS_R(res, r) res = real::interval::cos(r)
+#define TAN_R(res, r) res = real::interval::tan(r)
+#define ASIN_R(res, r) res = INTERVAL_ASIN(r)
+#define ACOS_R(res, r) res = INTERVAL_ACOS(r)
+#define ATAN_R(res, r) res = INTERVAL_ATAN(r)
+#define SINH_R(res, r) res = INTERVAL_SINH(r)
+#define COSH_R(res, r) res = real::interval::cosh(r)
+#define TANH_R(res, r) res = INTERVAL_TANH(r)
+#define ASINH_R(res, r) res = INTERVAL_ASINH(r)
+#define ACOSH_R(res, r) res = INTERVAL_ACOSH(r)
+#define ATANH_R(res, r) res = INTERVAL_ATANH(r)
+#define FABS_R(res, r) res = real::interval::fabs(r)
+#define FLOOR_R(res, r) res = INTERVAL_FLOOR(r)
+#define CEIL_R(res, r) res = INTERVAL_CEIL(r)
+#define TRUNC_R(res, r) res = INTERVAL_TRUNC(r)
+#define ROUND_R(res, r) res = INTERVAL_ROUND(r)
+#define CBRT_R(res, r) res = INTERVAL_CBRT(r)
+#define ERF_R(res, r) res = INTERVAL_ERF(r)
+#define ERFC_R(res, r) res = INTERVAL_ERFC(r)
+#define ATAN2_RR(res, a, b) res = real::interval::atan2(a, b)
+#define FMOD_RR(res, a, b) res = real::interval::fmod(a, b)
+#define FMIN_RR(res, a, b) res = real::interval::fmin(a, b)
+#define FMAX_RR(res, a, b) res = real::interval::fmax(a, b)
+#define HYPOT_RR(res, a, b) res = real::interval::hypot(a, b)
+
+// bitwise edits of the original apply to both bounds, see Real::reloadHigh/reloadLow
+#define COPY_EXP_D(res, d) __HI(res.lo)=__HI(d), __HI(res.hi)=__HI(d)
+#define CLEAR_LOWS(res) __LO(res.lo) = 0, __LO(res.hi) = 0
+#endif
@@ -23,6 +23,7 @@
 
 #define INIT(r, p) mpfr_init2(r, p)
 #define CLEAR(r) mpfr_clear(r)
+#define HP_HEAP_BYTES(p) mpfr_custom_get_size(p)
 
 #define TO_DOUBLE(r) mpfr_get_d(r, RND)
 
@@ -39,6 +40,7 @@
 
 #define FMA(t, l, m, r) mpfr_fma(t, l, m, r, RND)
 #define FMS(t, l, m, r) mpfr_fms(t, l, m, r, RND)
+#define FNMA(t, l, m, r) (mpfr_fms(t, l, m, r, RND), mpfr_neg(t, t, RND))
 
 
 #define LESS_RR(l,r) mpfr_less_p(l,r)
@@ -53,6 +55,38 @@
 #define POW_RR(res, a, b) mpfr_pow(res, a, b, RND) 
 #define SQRT_R(res, r) mpfr_sqrt(res, r, RND)
 
+// <math.h>
+#define LOG_R(res, r) mpfr_log(res, r, RND)
+#define LOG10_R(res, r) mpfr_log10(res, r, RND)
+#define LOG2_R(res, r) mpfr_log2(res, r, RND)
+#define LOG1P_R(res, r) mpfr_log1p(res, r, RND)
+#define EXPM1_R(res, r) mpfr_expm1(res, r, RND)
+#define SIN_R(res, r) mpfr_sin(res, r, RND)
+#define COS_R(res, r) mpfr_cos(res, r, RND)
+#define TAN_R(res, r) mpfr_tan(res, r, RND)
+#define ASIN_R(res, r) mpfr_asin(res, r, RND)
+#define ACOS_R(res, r) mpfr_acos(res, r, RND)
+#define ATAN_R(res, r) mpfr_atan(res, r, RND)
+#define SINH_R(res, r) mpfr_sinh(res, r, RND)
+#define COSH_R(res, r) mpfr_cosh(res, r, RND)
+#define TANH_R(res, r) mpfr_tanh(res, r, RND)
+#define ASINH_R(res, r) mpfr_asinh(res, r, RND)
+#define ACOSH_R(res, r) mpfr_acosh(res, r, RND)
+#define ATANH_R(res, r) mpfr_atanh(res, r, RND)
+#define FABS_R(res, r) mpfr_abs(res, r, RND)
+#define FLOOR_R(res, r) mpfr_floor(res, r)
+#define CEIL_R(res, r) mpfr_ceil(res, r)
+#define TRUNC_R(res, r) mpfr_trunc(res, r)
+#define ROUND_R(res, r) mpfr_round(res, r)
+#define CBRT_R(res, r) mpfr_cbrt(res, r, RND)
+#define ERF_R(res, r) mpfr_erf(res, r, RND)
+#define ERFC_R(res, r) mpfr_erfc(res, r, RND)
+#define ATAN2_RR(res, a, b) mpfr_atan2(res, a, b, RND)
+#define FMOD_RR(res, a, b) mpfr_fmod(res, a, b, RND)
+#define FMIN_RR(res, a, b) mpfr_min(res, a, b, RND)
+#define FMAX_RR(res, a, b) mpfr_max(res, a, b, RND)
+#define HYPOT_RR(res, a, b) mpfr_hypot(res, a, b, RND)
+
 
 #define COPY_EXP_D(res, d) mpfr_set_exp(res, __EXP_BITS(d))
 
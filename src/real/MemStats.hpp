@@ -0,0 +1,356 @@
+#ifndef MEM_STATS_HPP
+#define MEM_STATS_HPP
+/*
+Memory of the shadow runtime (SHADOW_MEMSTATS), included by RealUtil.hpp.
+Every allocator of the runtime reports to MemStats::INSTANCE by kind: the value pools, the hash maps of VariableMap,
+the ArraySlots, the shadow blocks of heap arrays, the CalculationError vectors and condition records, the shadow
+call stack and the limbs of MPFR shadows. Per kind there are the current and the peak bytes and the number of
+allocations, and per PC the allocations made while it was the current statement.
+The metrics are written in the Prometheus text format to SHADOW_MEMSTATS_FILE every SHADOW_MEMSTATS_INTERVAL
+seconds (checked at PCs) and at exit, e.g., for the textfile collector of node_exporter, and EAST_MEMSTATS prints
+them at any time.
+
+Pools never shrink by themselves. EAST_MEMTRIM releases the batches of a pool whose values are all free, and with
+SHADOW_POOL_HIGH_WATER the periodic dump trims every pool holding more free values than that.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <typeinfo>
+#include "RealConfigure.h"
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace real
+{
+    enum MemKind
+    {
+        MEM_POOL,      // batches and slots of util::ValuePool
+        MEM_VARIABLES, // hash map of VariableMap
+        MEM_ARRAYS,    // ArraySlots of VariableMap
+        MEM_RANGES,    // shadow blocks of heap arrays
+        MEM_ERRORS,    // CalculationError and ConditionRecord
+        MEM_CALLS,     // shadow stack frames
+        MEM_LIMBS,     // heap part of the shadow values, e.g., MPFR limbs
+        MEM_KINDS
+    };
+    static const char *MEM_KIND_NAMES[MEM_KINDS] = {"pool", "variables", "arrays", "ranges", "errors", "calls", "limbs"};
+
+    // a pool that can give its idle memory back, see util::ValuePool
+    struct PoolAccount
+    {
+        PoolAccount *nextPool;
+
+        virtual std::string poolName() const = 0;
+        virtual uint64 poolCapacity() const = 0; // values
+        virtual uint64 poolFree() const = 0;     // values
+        virtual uint64 trim(uint64 keep) = 0;    // releases idle batches while more than keep values stay free, returns the bytes
+
+    protected:
+        ~PoolAccount() {}
+    };
+
+    // all members are zero-initialized before any pool is constructed, so that pools can report from their constructors
+    struct MemStats
+    {
+        struct Counter
+        {
+            uint64 current;
+            uint64 peak;
+            uint64 allocations;
+        };
+        Counter kinds[MEM_KINDS];
+        uint64 current;
+        uint64 peak;
+        uint64 trimmed;
+        uint64 pc;
+        uint64 pcSize;
+        uint64 *pcBytes;
+        uint64 *pcAllocations;
+        uint64 visits;
+        uint64 lastDump; // steady_clock nanoseconds
+        bool hooked;
+        bool finished;
+        PoolAccount *pools;
+
+        static MemStats INSTANCE;
+
+        ~MemStats()
+        {
+            finish();
+            free(pcBytes);
+            free(pcAllocations);
+            pcBytes = pcAllocations = nullptr;
+            pcSize = 0;
+        }
+
+        inline void alloc(int kind, uint64 bytes)
+        {
+            Counter &c = kinds[kind];
+            c.current += bytes;
+            c.allocations++;
+            if (c.peak < c.current)
+                c.peak = c.current;
+            current += bytes;
+            if (peak < current)
+                peak = current;
+            if (real_unlikely(pc >= pcSize))
+                growPcs(pc + 1);
+            pcBytes[pc] += bytes;
+            pcAllocations[pc]++;
+        }
+
+        inline void release(int kind, uint64 bytes)
+        {
+            kinds[kind].current -= bytes;
+            current -= bytes;
+        }
+
+        inline void enter(uint64 id)
+        {
+            pc = id;
+            if (real_unlikely((visits++ & 0xFFFF) == 0))
+                tick();
+        }
+
+        // the last dump, before the runtime releases its memory at exit
+        void finish()
+        {
+#if SHADOW_MEMSTATS
+            if (finished)
+                return;
+            finished = true;
+            dump(SHADOW_MEMSTATS_FILE);
+#endif
+        }
+
+        void registerPool(PoolAccount *pool)
+        {
+            pool->nextPool = pools;
+            pools = pool;
+        }
+
+        void unregisterPool(PoolAccount *pool)
+        {
+            for (PoolAccount **p = &pools; *p != nullptr; p = &(*p)->nextPool)
+            {
+                if (*p == pool)
+                {
+                    *p = pool->nextPool;
+                    return;
+                }
+            }
+        }
+
+        // trims every pool, again while a pass frees something: releasing Reals frees their ShadowStates
+        uint64 trimPools(uint64 keep)
+        {
+            uint64 total = 0, freed;
+            do
+            {
+                freed = 0;
+                for (PoolAccount *p = pools; p != nullptr; p = p->nextPool)
+                    freed += p->trim(keep);
+                total += freed;
+            } while (freed != 0);
+#if defined(__GLIBC__)
+            malloc_trim(0);
+#endif
+            trimmed += total;
+            return total;
+        }
+
+        void report(std::ostream &stream)
+        {
+            stream << "# HELP east_shadow_memory_bytes Bytes allocated by the shadow runtime.\n"
+                   << "# TYPE east_shadow_memory_bytes gauge\n";
+            for (int k = 0; k < MEM_KINDS; k++)
+                stream << "east_shadow_memory_bytes{kind=\"" << MEM_KIND_NAMES[k] << "\"} " << kinds[k].current << "\n";
+            stream << "east_shadow_memory_bytes{kind=\"total\"} " << current << "\n";
+            stream << "# HELP east_shadow_memory_peak_bytes Peak of east_shadow_memory_bytes.\n"
+                   << "# TYPE east_shadow_memory_peak_bytes gauge\n";
+            for (int k = 0; k < MEM_KINDS; k++)
+                stream << "east_shadow_memory_peak_bytes{kind=\"" << MEM_KIND_NAMES[k] << "\"} " << kinds[k].peak << "\n";
+            stream << "east_shadow_memory_peak_bytes{kind=\"total\"} " << peak << "\n";
+            stream << "# HELP east_shadow_allocations_total Allocations of the shadow runtime.\n"
+                   << "# TYPE east_shadow_allocations_total counter\n";
+            for (int k = 0; k < MEM_KINDS; k++)
+                stream << "east_shadow_allocations_total{kind=\"" << MEM_KIND_NAMES[k] << "\"} " << kinds[k].allocations << "\n";
+
+            stream << "# HELP east_shadow_pool_values Values of a pool by state.\n"
+                   << "# TYPE east_shadow_pool_values gauge\n";
+            for (PoolAccount *p = pools; p != nullptr; p = p->nextPool)
+            {
+                uint64 capacity = p->poolCapacity(), available = p->poolFree();
+                std::string name = label(p->poolName());
+                stream << "east_shadow_pool_values{pool=\"" << name << "\",state=\"free\"} " << available << "\n";
+                stream << "east_shadow_pool_values{pool=\"" << name << "\",state=\"used\"} " << capacity - available << "\n";
+            }
+            stream << "# HELP east_shadow_pool_trimmed_bytes_total Bytes of idle pool batches released.\n"
+                   << "# TYPE east_shadow_pool_trimmed_bytes_total counter\n"
+                   << "east_shadow_pool_trimmed_bytes_total " << trimmed << "\n";
+
+            stream << "# HELP east_shadow_pc_allocated_bytes_total Bytes allocated while a PC was the current statement.\n"
+                   << "# TYPE east_shadow_pc_allocated_bytes_total counter\n";
+            for (uint64 i = 0; i < pcSize; i++)
+            {
+                if (pcAllocations[i] != 0)
+                    stream << "east_shadow_pc_allocated_bytes_total{" << pcLabels(i) << "} " << pcBytes[i] << "\n";
+            }
+            stream << "# HELP east_shadow_pc_allocations_total Allocations while a PC was the current statement.\n"
+                   << "# TYPE east_shadow_pc_allocations_total counter\n";
+            for (uint64 i = 0; i < pcSize; i++)
+            {
+                if (pcAllocations[i] != 0)
+                    stream << "east_shadow_pc_allocations_total{" << pcLabels(i) << "} " << pcAllocations[i] << "\n";
+            }
+        }
+
+        // replaces the file at once, a scraper never reads a partial dump
+        void dump(const char *filename)
+        {
+            std::string tmp = std::string(filename) + ".tmp";
+            {
+                std::ofstream out(tmp, std::ios::out | std::ios::trunc);
+                if (!out)
+                    return;
+                report(out);
+            }
+            rename(tmp.c_str(), filename);
+        }
+
+    private:
+        void growPcs(uint64 size)
+        {
+            if (size < 2 * pcSize)
+                size = 2 * pcSize;
+            if (size < 64)
+                size = 64;
+            pcBytes = (uint64 *)realloc(pcBytes, size * sizeof(uint64));
+            pcAllocations = (uint64 *)realloc(pcAllocations, size * sizeof(uint64));
+            for (uint64 i = pcSize; i < size; i++)
+                pcBytes[i] = pcAllocations[i] = 0;
+            pcSize = size;
+        }
+
+        static void atExit()
+        {
+            INSTANCE.finish();
+        }
+
+        void tick()
+        {
+#if SHADOW_MEMSTATS
+            if (!hooked)
+            {
+                // registered after the static pools and maps are constructed, so it runs before they are destroyed
+                hooked = true;
+                atexit(atExit);
+            }
+            uint64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            if (now - lastDump < (uint64)(SHADOW_MEMSTATS_INTERVAL * 1e9))
+                return;
+            lastDump = now;
+            if (SHADOW_POOL_HIGH_WATER > 0)
+                trimPools(SHADOW_POOL_HIGH_WATER);
+            dump(SHADOW_MEMSTATS_FILE);
+#endif
+        }
+
+        static std::string label(const std::string &s)
+        {
+            std::string r;
+            for (char c : s)
+            {
+                if (c == '\\' || c == '"')
+                    r += '\\';
+                if (c == '\n')
+                    r += "\\n";
+                else
+                    r += c;
+            }
+            return r;
+        }
+
+        std::string pcLabels(uint64 i)
+        {
+            std::ostringstream os;
+            os << "pc=\"" << i << "\"";
+#ifdef PC_COUNT
+            if (i < PC_COUNT)
+                os << ",location=\"" << label(PATH_STRINGS[i]) << "\"";
+#endif
+            return os.str();
+        }
+    };
+    MemStats MemStats::INSTANCE;
+
+    inline std::string typeName(const std::type_info &type)
+    {
+#if defined(__GNUG__)
+        int status = 0;
+        char *name = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        if (status == 0 && name != nullptr)
+        {
+            std::string r(name);
+            free(name);
+            return r;
+        }
+#endif
+        return type.name();
+    }
+
+#if SHADOW_MEMSTATS
+#define MEMSTATS_ALLOC(kind, bytes) real::MemStats::INSTANCE.alloc(kind, bytes)
+#define MEMSTATS_FREE(kind, bytes) real::MemStats::INSTANCE.release(kind, bytes)
+
+    // std::allocator that reports to MemStats, for the containers of the runtime
+    template <typename T, int kind>
+    struct CountingAllocator
+    {
+        typedef T value_type;
+        template <typename U>
+        struct rebind
+        {
+            typedef CountingAllocator<U, kind> other;
+        };
+
+        CountingAllocator() noexcept {}
+        template <typename U>
+        CountingAllocator(const CountingAllocator<U, kind> &) noexcept {}
+
+        T *allocate(size_t n)
+        {
+            MEMSTATS_ALLOC(kind, n * sizeof(T));
+            return std::allocator<T>().allocate(n);
+        }
+        void deallocate(T *p, size_t n)
+        {
+            MEMSTATS_FREE(kind, n * sizeof(T));
+            std::allocator<T>().deallocate(p, n);
+        }
+        template <typename U>
+        bool operator==(const CountingAllocator<U, kind> &) const noexcept { return true; }
+        template <typename U>
+        bool operator!=(const CountingAllocator<U, kind> &) const noexcept { return false; }
+    };
+    template <typename T, int kind>
+    using TrackedAllocator = CountingAllocator<T, kind>;
+#else
+#define MEMSTATS_ALLOC(kind, bytes) (void)0
+#define MEMSTATS_FREE(kind, bytes) (void)0
+    template <typename T, int kind>
+    using TrackedAllocator = std::allocator<T>;
+#endif
+}; // namespace real
+
+#endif
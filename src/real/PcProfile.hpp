@@ -0,0 +1,68 @@
+#ifndef PC_PROFILE_HPP
+#define PC_PROFILE_HPP
+/*
+Per-PC profile for profile-guided instrumentation (turnFpArith -profile/-error-profile).
+Phase one compiles the annotated source (sourceAnnotation, before turnFpArith) with PC_PROFILE: PC(id) only
+counts, no shadow value is computed. An instrumented build with PC_PROFILE also records, per PC, the maximal
+relative error of the shadow values assigned there, which is the optional error report.
+At exit the profile is written to PC_PROFILE_FILE, one line "pc count maxRelativeError" per executed PC,
+the error being -1 where no shadow value was assigned.
+*/
+#include <vector>
+#include <fstream>
+#include "RealConfigure.h"
+#include "RealUtil.hpp"
+
+namespace real
+{
+    struct PcProfile
+    {
+        std::vector<uint64> counts;
+        std::vector<double> errors;
+
+        static PcProfile INSTANCE;
+
+        PcProfile()
+        {
+#ifdef PC_COUNT
+            counts.resize(PC_COUNT, 0);
+            errors.resize(PC_COUNT, -1);
+#endif
+        }
+
+        ~PcProfile()
+        {
+            dump(PC_PROFILE_FILE);
+        }
+
+        inline void hit(uint64 pc)
+        {
+            if (pc >= counts.size())
+            {
+                counts.resize(pc + 1, 0);
+                errors.resize(pc + 1, -1);
+            }
+            counts[pc]++;
+        }
+
+        inline void error(uint64 pc, double re)
+        {
+            if (pc < errors.size() && errors[pc] < re)
+                errors[pc] = re;
+        }
+
+        void dump(const char *filename)
+        {
+            std::ofstream out(filename, std::ios::out | std::ios::trunc);
+            out.precision(17);
+            for (uint64 pc = 0; pc < counts.size(); pc++)
+            {
+                if (counts[pc] != 0)
+                    out << pc << " " << counts[pc] << " " << errors[pc] << "\n";
+            }
+        }
+    };
+    PcProfile PcProfile::INSTANCE;
+}; // namespace real
+
+#endif
@@ -0,0 +1,294 @@
+#ifndef PROVENANCE_HPP
+#define PROVENANCE_HPP
+/*
+Bounded-memory provenance of errors (SHADOW_PROVENANCE), included by ErrorState.hpp.
+A SymbolicVarError only remembers the PC that caused its largest error, and CalculationError::inputVars grows with
+the operands of a PC. Here every PC keeps a fixed table of SHADOW_PROVENANCE_K causes, ranked by the relative error
+they contributed to it, summed over its executions:
+    - an operand read at the PC contributes its current error to the PC that computed it (errorCausingCalculationID
+      of its last check),
+    - the PC itself is charged with the error its statement adds, the estimate of the result beyond the largest error
+      of its operands, and with the operands it computed itself in earlier iterations.
+The local error of a PC is not only its own rounding: an operation that amplifies the errors of its operands, e.g.,
+the subtraction of nearly equal values, is charged with the amplified part, the operands only with what they had.
+A full table evicts its smallest cause and gives the newcomer its weight (Space-Saving), so that the weights of a
+table keep summing to all the error contributed and the largest causes are kept. Updates scan the K slots only.
+The slots are atomics, and merge() adds another instance, e.g., of another thread, lock-free while this one is
+updated. Tables are allocated in chunks of PCs on first use.
+
+explain() walks the tables back from the PC of an output value, splitting the error of every PC among its causes by
+their weights, and lists the statements to which most of the error is attributed (EAST_EXPLAIN_ERROR). These are
+the statements that introduce error or amplify it, a cancellation ranks above the roundings it magnifies.
+*/
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include "RealConfigure.h"
+#include "RealUtil.hpp"
+
+namespace real
+{
+    struct Provenance
+    {
+        static const uint64 CHUNK = 1024;       // PCs per chunk
+        static const uint64 MAX_CHUNKS = 16384; // PCs up to 16M
+        static const uint64 NONE = ~(uint64)0;
+
+        // zero-initialized: cause 0 is no cause, causes are stored as PC + 1
+        struct Slot
+        {
+            std::atomic<uint64> cause;
+            std::atomic<uint64> weight; // bits of a double
+        };
+        struct Table
+        {
+            Slot slots[SHADOW_PROVENANCE_K];
+        };
+
+        std::atomic<Table *> chunks[MAX_CHUNKS];
+        // the statement being executed by this thread and the largest error of its operands, see input() and error()
+        static thread_local uint64 pendingPc;
+        static thread_local double pendingInput;
+
+        static Provenance INSTANCE;
+
+        ~Provenance()
+        {
+            for (uint64 c = 0; c < MAX_CHUNKS; c++)
+            {
+                Table *t = chunks[c].load(std::memory_order_relaxed);
+                if (t != nullptr)
+                {
+                    MEMSTATS_FREE(MEM_ERRORS, CHUNK * sizeof(Table));
+                    delete[] t;
+                }
+            }
+        }
+
+        // an operand with error re, last computed at cause, read at pc
+        inline void input(uint64 pc, uint64 cause, double re)
+        {
+            if (pendingPc != pc)
+            {
+                pendingPc = pc;
+                pendingInput = 0;
+            }
+            if (re > 0)
+            {
+                if (pendingInput < re)
+                    pendingInput = re;
+                add(pc, cause, re);
+            }
+        }
+
+        // the error estimate of the result of pc
+        inline void error(uint64 pc, double re)
+        {
+            double local = pendingPc == pc ? re - pendingInput : re;
+            pendingPc = NONE;
+            if (local > 0)
+                add(pc, pc, local);
+        }
+
+        // weight of cause at pc += w, evicting the smallest cause of a full table
+        void add(uint64 pc, uint64 cause, double w)
+        {
+            Table *t = table(pc);
+            if (t == nullptr)
+                return;
+            uint64 key = cause + 1;
+            Slot *min = nullptr;
+            double minWeight = 0;
+            for (;;)
+            {
+                for (Slot &s : t->slots)
+                {
+                    uint64 c = s.cause.load(std::memory_order_relaxed);
+                    if (c == key)
+                    {
+                        addWeight(s, w);
+                        return;
+                    }
+                    if (c == 0)
+                    {
+                        if (s.cause.compare_exchange_strong(c, key, std::memory_order_relaxed) || c == key)
+                        {
+                            addWeight(s, w);
+                            return;
+                        }
+                        continue; // taken by another cause meanwhile
+                    }
+                    double sw = weightOf(s);
+                    if (min == nullptr || sw < minWeight)
+                    {
+                        min = &s;
+                        minWeight = sw;
+                    }
+                }
+                if (min == nullptr)
+                    continue; // every slot was taken meanwhile
+                uint64 c = min->cause.load(std::memory_order_relaxed);
+                if (c != key && c != 0 && min->cause.compare_exchange_strong(c, key, std::memory_order_relaxed))
+                {
+                    addWeight(*min, w); // on top of the weight of the evicted cause
+                    return;
+                }
+                min = nullptr; // the table changed, look again
+            }
+        }
+
+        // adds the tables of another instance, lock-free with concurrent updates and merges of this one
+        void merge(const Provenance &other)
+        {
+            for (uint64 c = 0; c < MAX_CHUNKS; c++)
+            {
+                const Table *t = other.chunks[c].load(std::memory_order_acquire);
+                if (t == nullptr)
+                    continue;
+                for (uint64 i = 0; i < CHUNK; i++)
+                {
+                    for (const Slot &s : t[i].slots)
+                    {
+                        uint64 cause = s.cause.load(std::memory_order_relaxed);
+                        double w = weightOf(s);
+                        if (cause != 0 && w > 0)
+                            add(c * CHUNK + i, cause - 1, w);
+                    }
+                }
+            }
+        }
+
+        // the statements to which the first fraction of the error of root is attributed, at most k of them
+        void explain(std::ostream &stream, uint64 root, const char **locations, double fraction, uint64 k) const
+        {
+            std::vector<double> pending, attributed;
+            std::vector<uint64> work;
+            uint64 head = 0;
+            auto push = [&](uint64 pc, double mass) {
+                if (pc >= pending.size())
+                {
+                    pending.resize(pc + 1, 0);
+                    attributed.resize(pc + 1, 0);
+                }
+                if (pending[pc] == 0)
+                    work.push_back(pc);
+                pending[pc] += mass;
+            };
+            push(root, 1);
+            // cycles of PCs pass their mass around, a bounded number of steps leaves the rest where it is
+            for (; head < work.size() && head < 1024 + 64 * pending.size(); head++)
+            {
+                uint64 pc = work[head];
+                double mass = pending[pc];
+                pending[pc] = 0;
+                const Table *t = table(pc);
+                double total = 0;
+                if (t != nullptr)
+                {
+                    for (const Slot &s : t->slots)
+                        total += weightOf(s);
+                }
+                if (total <= 0)
+                {
+                    attributed[pc] += mass;
+                    continue;
+                }
+                for (const Slot &s : t->slots)
+                {
+                    uint64 cause = s.cause.load(std::memory_order_relaxed);
+                    double share = mass * weightOf(s) / total;
+                    if (cause == 0 || share == 0)
+                        continue;
+                    if (cause - 1 == pc || share < 1e-9)
+                        attributed[pc] += share;
+                    else
+                        push(cause - 1, share);
+                }
+            }
+            for (uint64 pc = 0; pc < pending.size(); pc++)
+                attributed[pc] += pending[pc];
+
+            std::vector<uint64> order;
+            for (uint64 pc = 0; pc < attributed.size(); pc++)
+            {
+                if (attributed[pc] > 0)
+                    order.push_back(pc);
+            }
+            std::sort(order.begin(), order.end(), [&](uint64 a, uint64 b) { return attributed[a] > attributed[b]; });
+            double explained = 0;
+            uint64 n = 0;
+            for (; n < order.size() && n < k && explained < fraction; n++)
+            {
+                explained += attributed[order[n]];
+                stream << "[EXPLAIN]\t" << attributed[order[n]] * 100 << "%\t" << location(locations, order[n]) << "\n";
+            }
+            stream << "[EXPLAIN]\t" << n << " statements explain " << explained * 100 << "% of the error of "
+                   << location(locations, root) << "\n";
+        }
+
+    private:
+        static inline double weightOf(const Slot &s)
+        {
+            uint64 bits = s.weight.load(std::memory_order_relaxed);
+            double w;
+            std::memcpy(&w, &bits, sizeof(w));
+            return w;
+        }
+
+        static inline void addWeight(Slot &s, double w)
+        {
+            uint64 bits = s.weight.load(std::memory_order_relaxed), next;
+            do
+            {
+                double sum;
+                std::memcpy(&sum, &bits, sizeof(sum));
+                sum += w;
+                std::memcpy(&next, &sum, sizeof(next));
+            } while (!s.weight.compare_exchange_weak(bits, next, std::memory_order_relaxed));
+        }
+
+        const Table *table(uint64 pc) const
+        {
+            uint64 c = pc / CHUNK;
+            if (c >= MAX_CHUNKS)
+                return nullptr;
+            const Table *t = chunks[c].load(std::memory_order_acquire);
+            return t == nullptr ? nullptr : t + pc % CHUNK;
+        }
+
+        // allocates the chunk of pc on first use, the first thread to install one wins
+        Table *table(uint64 pc)
+        {
+            uint64 c = pc / CHUNK;
+            if (real_unlikely(c >= MAX_CHUNKS))
+                return nullptr;
+            Table *t = chunks[c].load(std::memory_order_acquire);
+            if (real_unlikely(t == nullptr))
+            {
+                Table *fresh = new Table[CHUNK]();
+                if (chunks[c].compare_exchange_strong(t, fresh, std::memory_order_acq_rel))
+                {
+                    MEMSTATS_ALLOC(MEM_ERRORS, CHUNK * sizeof(Table));
+                    t = fresh;
+                }
+                else
+                    delete[] fresh;
+            }
+            return t + pc % CHUNK;
+        }
+
+        static std::string location(const char **locations, uint64 pc)
+        {
+            if (locations != nullptr)
+                return locations[pc];
+            return "PC " + std::to_string(pc);
+        }
+    };
+    Provenance Provenance::INSTANCE;
+    thread_local uint64 Provenance::pendingPc = Provenance::NONE;
+    thread_local double Provenance::pendingInput = 0;
+}; // namespace real
+
+#endif
@@ -19,11 +19,32 @@
  * 2021/1/7. LEI is not better than EEI in simple cases without compiler optimazation. 
  *           EEI has already being well optimized to avoid unnecessary storage and calculation.
  *           The trick of pool (real::util::ValuePool) has been used to optimize object allocation and deallocation.
+ * 2026/10/19. LEI is used by turnFpArith -lazy (see RealLazy.hpp). On a DD stencil kernel it is ~1.6x slower than EEI at -O0,
+ *           and ~20% faster at -O2 and -O3, where the whole tree is inlined and the pool traffic disappears.
  */
 
+#include <type_traits>
 #include "RealConfigure.h"
+#if SHADOW_PROFILE
+#include "CycleProfile.hpp"
+#define PROFILE_OP() real::CycleProfile::INSTANCE.op()
+#else
+#define PROFILE_OP() (void)0
+#endif
 #include "ShadowValue.hpp"
 
+#if KEEP_ORIGINAL && ORIGINAL_WIDTHS
+// the original of t from those of l and r: float when both are, see ORIGINAL_WIDTHS
+#define NARROW_RR(t, l, r) ((t).single = (l).single && (r).single, (t).originalValue = NARROW((t).originalValue, (t).single))
+// the original of t from that of l and a double constant, or stored into t = l
+#define NARROW_R(t, l) ((t).single = (l).single, (t).originalValue = NARROW((t).originalValue, (t).single))
+#define SET_SINGLE(t, s) ((t).single = (s))
+#else
+#define NARROW_RR(t, l, r) (void)0
+#define NARROW_R(t, l) (void)0
+#define SET_SINGLE(t, s) (void)0
+#endif
+
 namespace real
 {
     using namespace real::util;
@@ -33,9 +54,16 @@ namespace real
     public:
         sval_ptr shadow;
 
-    static inline double CalcError(const Real &svar, double ovar)
+    static inline double CalcError(const ShadowState &svar, double ovar)
     {
-        double dsv = TO_DOUBLE(svar.shadow->shadowValue);
+#if ERROR_METRIC == ULP_METRIC
+#if KEEP_ORIGINAL && ORIGINAL_WIDTHS
+        if (svar.single)
+            return ulpDistance((float)TO_DOUBLE(svar.shadowValue), (float)ovar) * FLOAT_ULP;
+#endif
+        return ulpDistance(TO_DOUBLE(svar.shadowValue), ovar) * ORIGINAL_ULP;
+#else
+        double dsv = TO_DOUBLE(svar.shadowValue);
         if (dsv == 0) {
             if(ovar==0) return 0;
             dsv = 1.1E-16;
@@ -43,14 +71,23 @@ namespace real
         double re = (dsv - ovar) / dsv;
         if(re<0) return -re;
         else return re;
+#endif
+    }
+    static inline double CalcError(const Real &svar, double ovar)
+    {
+        return CalcError(*svar.shadow, ovar);
     }
 #if TRACK_ERROR
-    static inline void UpdError(const real::Real &svar, double ovar)
+    static inline void UpdError(ShadowState &svar, double ovar)
     {
         double re = real::Real::CalcError(svar, ovar);
         // if(re>1E-5) 
         //     assert(false);
-        ERROR_STATE.updateError(svar.shadow->error, re);
+        ERROR_STATE.updateError(svar.error, re);
+    }
+    static inline void UpdError(const real::Real &svar, double ovar)
+    {
+        UpdError(*svar.shadow, ovar);
     }
     #define INTERNAL_INIT_ERROR(v) ERROR_STATE.setError((v).shadow->error,0)
 #if ACTIVE_TRACK_ERROR
@@ -67,6 +104,7 @@ namespace real
         Real()
         {
             shadow = ShadowPool::INSTANCE.get();
+            SET_SINGLE(*shadow, false);
         }
         Real(double v)
         {
@@ -75,11 +113,18 @@ namespace real
 #if KEEP_ORIGINAL
             shadow->originalValue = v;
 #endif
+            SET_SINGLE(*shadow, false);
 #if TRACK_ERROR
             ERROR_STATE.setError(shadow->error, 0);
 #endif
         }
 
+        // the state is owned by the caller, see util::RangeCell<Real>
+        explicit Real(ShadowState &external)
+        {
+            shadow = &external;
+        }
+
         Real(Real &&r) noexcept
         {
             this->shadow = r.shadow;
@@ -89,14 +134,15 @@ namespace real
 
         Real(const Real &r)
         {
+            shadow = ShadowPool::INSTANCE.get();
 #if TRACK_ERROR
             ERROR_STATE.setError(shadow->error, r.shadow->error.maxRelativeError);
 #endif
-            shadow = ShadowPool::INSTANCE.get();
             ASSIGN(shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             shadow->originalValue = r.shadow->originalValue;
 #endif
+            SET_SINGLE(*shadow, r.shadow->single);
         }
 
         ~Real()
@@ -117,6 +163,7 @@ namespace real
             SUB_DR(res.shadow->shadowValue, 0, this->shadow->shadowValue);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = - shadow->originalValue;
+            NARROW_R(*res.shadow, *shadow);
 #endif
             return std::move(res);
         }
@@ -128,9 +175,11 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
             Real &res = *RealPool<Real>::INSTANCE.get();
+            PROFILE_OP();
             ADD_RR(res.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = l.shadow->originalValue + r.shadow->originalValue;
+            NARROW_RR(*res.shadow, *l.shadow, *r.shadow);
 #endif
             return std::move(res);
         }
@@ -140,9 +189,11 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
+            PROFILE_OP();
             ADD_RR(l.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             l.shadow->originalValue += r.shadow->originalValue;
+            NARROW_RR(*l.shadow, *l.shadow, *r.shadow);
 #endif
             return std::move(l);
         }
@@ -152,18 +203,22 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(l.shadow->error);
 #endif
+            PROFILE_OP();
             ADD_RR(r.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             r.shadow->originalValue += l.shadow->originalValue;
+            NARROW_RR(*r.shadow, *r.shadow, *l.shadow);
 #endif
             return std::move(r);
         }
 
         INLINE_FLAGS friend Real &&operator+(Real &&l, Real &&r)
         {
+            PROFILE_OP();
             ADD_RR(l.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             l.shadow->originalValue += r.shadow->originalValue;
+            NARROW_RR(*l.shadow, *l.shadow, *r.shadow);
 #endif
             RealPool<Real>::INSTANCE.put(&r); // r should be an useless temp
             return std::move(l);
@@ -176,9 +231,11 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
             Real &res = *RealPool<Real>::INSTANCE.get();
+            PROFILE_OP();
             SUB_RR(res.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = l.shadow->originalValue - r.shadow->originalValue;
+            NARROW_RR(*res.shadow, *l.shadow, *r.shadow);
 #endif
             return std::move(res);
         }
@@ -188,17 +245,21 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
+            PROFILE_OP();
             SUB_RR(l.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             l.shadow->originalValue -= r.shadow->originalValue;
+            NARROW_RR(*l.shadow, *l.shadow, *r.shadow);
 #endif
             return std::move(l);
         }
         INLINE_FLAGS friend Real &&operator-(Real &&l, Real &&r)
         {
+            PROFILE_OP();
             SUB_RR(l.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             l.shadow->originalValue -= r.shadow->originalValue;
+            NARROW_RR(*l.shadow, *l.shadow, *r.shadow);
 #endif
             RealPool<Real>::INSTANCE.put(&r);
             return std::move(l);
@@ -208,9 +269,11 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(l.shadow->error);
 #endif
+            PROFILE_OP();
             SUB_RR(r.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             r.shadow->originalValue = l.shadow->originalValue - r.shadow->originalValue;
+            NARROW_RR(*r.shadow, *l.shadow, *r.shadow);
 #endif
             return std::move(r);
         }
@@ -221,9 +284,11 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
             Real &res = *RealPool<Real>::INSTANCE.get();
+            PROFILE_OP();
             MUL_RR(res.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = l.shadow->originalValue * r.shadow->originalValue;
+            NARROW_RR(*res.shadow, *l.shadow, *r.shadow);
 #endif
             return std::move(res);
         }
@@ -233,9 +298,11 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
+            PROFILE_OP();
             MUL_RR(l.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             l.shadow->originalValue *= r.shadow->originalValue;
+            NARROW_RR(*l.shadow, *l.shadow, *r.shadow);
 #endif
             return std::move(l);
         }
@@ -245,18 +312,22 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(l.shadow->error);
 #endif
+            PROFILE_OP();
             MUL_RR(r.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             r.shadow->originalValue *= l.shadow->originalValue;
+            NARROW_RR(*r.shadow, *r.shadow, *l.shadow);
 #endif
             return std::move(r);
         }
 
         INLINE_FLAGS friend Real &&operator*(Real &&l, Real &&r)
         {
+            PROFILE_OP();
             MUL_RR(l.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             l.shadow->originalValue *= r.shadow->originalValue;
+            NARROW_RR(*l.shadow, *l.shadow, *r.shadow);
 #endif
             RealPool<Real>::INSTANCE.put(&r);
             return std::move(l);
@@ -269,9 +340,11 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
             Real &res = *RealPool<Real>::INSTANCE.get();
+            PROFILE_OP();
             DIV_RR(res.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = l.shadow->originalValue / r.shadow->originalValue;
+            NARROW_RR(*res.shadow, *l.shadow, *r.shadow);
 #endif
             return std::move(res);
         }
@@ -281,17 +354,21 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
+            PROFILE_OP();
             DIV_RR(l.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             l.shadow->originalValue /= r.shadow->originalValue;
+            NARROW_RR(*l.shadow, *l.shadow, *r.shadow);
 #endif
             return std::move(l);
         }
         INLINE_FLAGS friend Real &&operator/(Real &&l, Real &&r)
         {
+            PROFILE_OP();
             DIV_RR(l.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             l.shadow->originalValue /= r.shadow->originalValue;
+            NARROW_RR(*l.shadow, *l.shadow, *r.shadow);
 #endif
             RealPool<Real>::INSTANCE.put(&r);
             return std::move(l);
@@ -301,18 +378,22 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(l.shadow->error);
 #endif
+            PROFILE_OP();
             DIV_RR(r.shadow->shadowValue, l.shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             r.shadow->originalValue = l.shadow->originalValue / r.shadow->originalValue;
+            NARROW_RR(*r.shadow, *l.shadow, *r.shadow);
 #endif
             return std::move(r);
         }
 
         INLINE_FLAGS friend Real &&operator+(Real &&l, const double i)
         {
+            PROFILE_OP();
             ADD_RD(l.shadow->shadowValue, l.shadow->shadowValue, i);
 #if KEEP_ORIGINAL
             l.shadow->originalValue += i;
+            NARROW_R(*l.shadow, *l.shadow);
 #endif
             return std::move(l);
         }
@@ -322,17 +403,21 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(l.shadow->error);
 #endif
             Real &res = *RealPool<Real>::INSTANCE.get();
+            PROFILE_OP();
             ADD_RD(res.shadow->shadowValue, l.shadow->shadowValue, i);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = l.shadow->originalValue + i;
+            NARROW_R(*res.shadow, *l.shadow);
 #endif
             return std::move(res);
         }
         INLINE_FLAGS friend Real &&operator+(const double i, Real &&l)
         {
+            PROFILE_OP();
             ADD_RD(l.shadow->shadowValue, l.shadow->shadowValue, i);
 #if KEEP_ORIGINAL
             l.shadow->originalValue = i + l.shadow->originalValue;
+            NARROW_R(*l.shadow, *l.shadow);
 #endif
             return std::move(l);
         }
@@ -342,18 +427,22 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(l.shadow->error);
 #endif
             Real &res = *RealPool<Real>::INSTANCE.get();
+            PROFILE_OP();
             ADD_RD(res.shadow->shadowValue, l.shadow->shadowValue, i);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = i + l.shadow->originalValue;
+            NARROW_R(*res.shadow, *l.shadow);
 #endif
             return std::move(res);
         }
 
         INLINE_FLAGS friend Real &&operator-(Real &&l, const double i)
         {
+            PROFILE_OP();
             SUB_RD(l.shadow->shadowValue, l.shadow->shadowValue, i);
 #if KEEP_ORIGINAL
             l.shadow->originalValue -= i;
+            NARROW_R(*l.shadow, *l.shadow);
 #endif
             return std::move(l);
         }
@@ -363,17 +452,21 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(l.shadow->error);
 #endif
             Real &res = *RealPool<Real>::INSTANCE.get();
+            PROFILE_OP();
             SUB_RD(res.shadow->shadowValue, l.shadow->shadowValue, i);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = l.shadow->originalValue - i;
+            NARROW_R(*res.shadow, *l.shadow);
 #endif
             return std::move(res);
         }
         INLINE_FLAGS friend Real &&operator-(const double i, Real &&l)
         {
+            PROFILE_OP();
             SUB_DR(l.shadow->shadowValue, i, l.shadow->shadowValue);
 #if KEEP_ORIGINAL
             l.shadow->originalValue = i - l.shadow->originalValue;
+            NARROW_R(*l.shadow, *l.shadow);
 #endif
             return std::move(l);
         }
@@ -383,18 +476,22 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(l.shadow->error);
 #endif
             Real &res = *RealPool<Real>::INSTANCE.get();
+            PROFILE_OP();
             SUB_DR(res.shadow->shadowValue, i, l.shadow->shadowValue);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = i - l.shadow->originalValue;
+            NARROW_R(*res.shadow, *l.shadow);
 #endif
             return std::move(res);
         }
 
         INLINE_FLAGS friend Real &&operator*(Real &&l, const double i)
         {
+            PROFILE_OP();
             MUL_RD(l.shadow->shadowValue, l.shadow->shadowValue, i);
 #if KEEP_ORIGINAL
             l.shadow->originalValue *= i;
+            NARROW_R(*l.shadow, *l.shadow);
 #endif
             return std::move(l);
         }
@@ -404,17 +501,21 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(l.shadow->error);
 #endif
             Real &res = *RealPool<Real>::INSTANCE.get();
+            PROFILE_OP();
             MUL_RD(res.shadow->shadowValue, l.shadow->shadowValue, i);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = l.shadow->originalValue * i;
+            NARROW_R(*res.shadow, *l.shadow);
 #endif
             return std::move(res);
         }
         INLINE_FLAGS friend Real &&operator*(const double i, Real &&l)
         {
+            PROFILE_OP();
             MUL_RD(l.shadow->shadowValue, l.shadow->shadowValue, i);
 #if KEEP_ORIGINAL
             l.shadow->originalValue = i * l.shadow->originalValue;
+            NARROW_R(*l.shadow, *l.shadow);
 #endif
             return std::move(l);
         }
@@ -424,18 +525,22 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(l.shadow->error);
 #endif
             Real &res = *RealPool<Real>::INSTANCE.get();
+            PROFILE_OP();
             MUL_RD(res.shadow->shadowValue, l.shadow->shadowValue, i);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = i * l.shadow->originalValue;
+            NARROW_R(*res.shadow, *l.shadow);
 #endif
             return std::move(res);
         }
 
         INLINE_FLAGS friend Real &&operator/(Real &&l, const double i)
         {
+            PROFILE_OP();
             DIV_RD(l.shadow->shadowValue, l.shadow->shadowValue, i);
 #if KEEP_ORIGINAL
             l.shadow->originalValue /= i;
+            NARROW_R(*l.shadow, *l.shadow);
 #endif
             return std::move(l);
         }
@@ -445,17 +550,21 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(l.shadow->error);
 #endif
             Real &res = *RealPool<Real>::INSTANCE.get();
+            PROFILE_OP();
             DIV_RD(res.shadow->shadowValue, l.shadow->shadowValue, i);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = l.shadow->originalValue / i;
+            NARROW_R(*res.shadow, *l.shadow);
 #endif
             return std::move(res);
         }
         INLINE_FLAGS friend Real &&operator/(const double i, Real &&l)
         {
+            PROFILE_OP();
             DIV_DR(l.shadow->shadowValue, i, l.shadow->shadowValue);
 #if KEEP_ORIGINAL
             l.shadow->originalValue = i / l.shadow->originalValue;
+            NARROW_R(*l.shadow, *l.shadow);
 #endif
             return std::move(l);
         }
@@ -465,9 +574,11 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(l.shadow->error);
 #endif
             Real &res = *RealPool<Real>::INSTANCE.get();
+            PROFILE_OP();
             DIV_DR(res.shadow->shadowValue, i, l.shadow->shadowValue);
 #if KEEP_ORIGINAL
             res.shadow->originalValue = i / l.shadow->originalValue;
+            NARROW_R(*res.shadow, *l.shadow);
 #endif
             return std::move(res);
         }
@@ -480,6 +591,7 @@ namespace real
             ASSIGN(shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             shadow->originalValue = r.shadow->originalValue;
+            NARROW_R(*shadow, *shadow);
 #endif
             INTERNAL_ESTIMATE_ERROR(*this);
             return *this;
@@ -489,6 +601,7 @@ namespace real
             SWAP(shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             shadow->originalValue = r.shadow->originalValue;
+            NARROW_R(*shadow, *shadow);
 #endif
             RealPool<Real>::INSTANCE.put(&r);
             INTERNAL_ESTIMATE_ERROR(*this);
@@ -499,6 +612,7 @@ namespace real
             ASSIGN_D(shadow->shadowValue, r);
 #if KEEP_ORIGINAL
             shadow->originalValue = r;
+            NARROW_R(*shadow, *shadow);
 #endif
             INTERNAL_INIT_ERROR(*this);
             return *this;
@@ -510,9 +624,11 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(shadow->error);
             ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
+            PROFILE_OP();
             ADD_RR(this->shadow->shadowValue, this->shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             shadow->originalValue += r.shadow->originalValue;
+            NARROW_R(*shadow, *shadow);
 #endif
             INTERNAL_ESTIMATE_ERROR(*this);
             return *this;
@@ -524,9 +640,11 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(shadow->error);
             ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
+            PROFILE_OP();
             SUB_RR(this->shadow->shadowValue, this->shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             shadow->originalValue -= r.shadow->originalValue;
+            NARROW_R(*shadow, *shadow);
 #endif
             INTERNAL_ESTIMATE_ERROR(*this);
             return *this;
@@ -538,9 +656,11 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(shadow->error);
             ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
+            PROFILE_OP();
             MUL_RR(this->shadow->shadowValue, this->shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             shadow->originalValue *= r.shadow->originalValue;
+            NARROW_R(*shadow, *shadow);
 #endif
             INTERNAL_ESTIMATE_ERROR(*this);
             return *this;
@@ -552,9 +672,11 @@ namespace real
             ERROR_STATE.updateSymbolicVarError(shadow->error);
             ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
+            PROFILE_OP();
             DIV_RR(this->shadow->shadowValue, this->shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             shadow->originalValue /= r.shadow->originalValue;
+            NARROW_R(*shadow, *shadow);
 #endif
             INTERNAL_ESTIMATE_ERROR(*this);
             return *this;
@@ -565,9 +687,11 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(shadow->error);
 #endif
+            PROFILE_OP();
             ADD_RR(this->shadow->shadowValue, this->shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             shadow->originalValue += r.shadow->originalValue;
+            NARROW_R(*shadow, *shadow);
 #endif
             RealPool<Real>::INSTANCE.put(&r);
             INTERNAL_ESTIMATE_ERROR(*this);
@@ -579,9 +703,11 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(shadow->error);
 #endif
+            PROFILE_OP();
             SUB_RR(this->shadow->shadowValue, this->shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             shadow->originalValue -= r.shadow->originalValue;
+            NARROW_R(*shadow, *shadow);
 #endif
             RealPool<Real>::INSTANCE.put(&r);
             INTERNAL_ESTIMATE_ERROR(*this);
@@ -593,9 +719,11 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(shadow->error);
 #endif
+            PROFILE_OP();
             MUL_RR(this->shadow->shadowValue, this->shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             shadow->originalValue *= r.shadow->originalValue;
+            NARROW_R(*shadow, *shadow);
 #endif
             RealPool<Real>::INSTANCE.put(&r);
             INTERNAL_ESTIMATE_ERROR(*this);
@@ -607,9 +735,11 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(shadow->error);
 #endif
+            PROFILE_OP();
             DIV_RR(this->shadow->shadowValue, this->shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
             shadow->originalValue /= r.shadow->originalValue;
+            NARROW_R(*shadow, *shadow);
 #endif
             RealPool<Real>::INSTANCE.put(&r);
             INTERNAL_ESTIMATE_ERROR(*this);
@@ -621,9 +751,11 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(shadow->error);
 #endif
+            PROFILE_OP();
             ADD_RD(this->shadow->shadowValue, this->shadow->shadowValue, r);
 #if KEEP_ORIGINAL
             shadow->originalValue += r;
+            NARROW_R(*shadow, *shadow);
 #endif
             INTERNAL_ESTIMATE_ERROR(*this);
             return *this;
@@ -634,9 +766,11 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(shadow->error);
 #endif
+            PROFILE_OP();
             SUB_RD(this->shadow->shadowValue, this->shadow->shadowValue, r);
 #if KEEP_ORIGINAL
             shadow->originalValue -= r;
+            NARROW_R(*shadow, *shadow);
 #endif
             INTERNAL_ESTIMATE_ERROR(*this);
             return *this;
@@ -647,9 +781,11 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(shadow->error);
 #endif
+            PROFILE_OP();
             MUL_RD(this->shadow->shadowValue, this->shadow->shadowValue, r);
 #if KEEP_ORIGINAL
             shadow->originalValue *= r;
+            NARROW_R(*shadow, *shadow);
 #endif
             INTERNAL_ESTIMATE_ERROR(*this);
             return *this;
@@ -660,9 +796,11 @@ namespace real
 #if TRACK_ERROR
             ERROR_STATE.updateSymbolicVarError(shadow->error);
 #endif
+            PROFILE_OP();
             DIV_RD(this->shadow->shadowValue, this->shadow->shadowValue, r);
 #if KEEP_ORIGINAL
             shadow->originalValue /= r;
+            NARROW_R(*shadow, *shadow);
 #endif
             INTERNAL_ESTIMATE_ERROR(*this);
             return *this;
@@ -824,6 +962,24 @@ namespace real
             return ret;
         }
 
+        INLINE_FLAGS void reloadHigh(float v)
+        {
+            *this = v; // a float has no hi/lo words
+        }
+
+        INLINE_FLAGS void reloadLow(float v)
+        {
+            *this = v;
+        }
+
+        // the width of the variable of type VT this shadow stands for, its stores are rounded to it
+        template <typename VT>
+        INLINE_FLAGS Real &setWidth()
+        {
+            SET_SINGLE(*shadow, (std::is_same<VT, float>::value));
+            return *this;
+        }
+
         INLINE_FLAGS void reloadHigh(double v)
         {
             double current;
@@ -865,6 +1021,34 @@ namespace real
         }
     };
 
+    namespace util
+    {
+        // cells of heap-array ranges keep the shadow state inline, so a spilled block holds the whole shadow
+        template <>
+        struct RangeCell<Real>
+        {
+            Real value;
+            ShadowState state;
+
+            template <typename VT>
+            inline void init(VT &original)
+            {
+                ShadowInitializer().construct(state);
+                new (&value) Real(state);
+                value.setWidth<VT>() = original;
+            }
+            inline void destroy()
+            {
+                ShadowInitializer().destruct(state);
+                value.shadow = nullptr; // not taken from the pool
+            }
+            inline void relocate()
+            {
+                value.shadow = &state;
+            }
+        };
+    }; // namespace util
+
     class Timer
     {
     private:
@@ -898,156 +1082,280 @@ namespace real
     };
 
 
+#if TRACK_ERROR
+#define REAL_TRACK_INPUT(v) ERROR_STATE.updateSymbolicVarError((v).shadow->error)
+#else
+#define REAL_TRACK_INPUT(v)
+#endif
+
+#if KEEP_ORIGINAL && ORIGINAL_WIDTHS
+// float originals call the float overloads, as the program does
+#define REAL_UNARY_ORIGINAL(original) \
+    res.shadow->single = r.shadow->single; \
+    res.shadow->originalValue = res.shadow->single ? (double)original((float)r.shadow->originalValue) : original(r.shadow->originalValue)
+#define REAL_BINARY_ORIGINAL(original) \
+    res.shadow->single = a.shadow->single && b.shadow->single; \
+    res.shadow->originalValue = res.shadow->single ? (double)original((float)a.shadow->originalValue, (float)b.shadow->originalValue) \
+                                                   : original(a.shadow->originalValue, b.shadow->originalValue)
+#else
+#define REAL_UNARY_ORIGINAL(original) res.shadow->originalValue = original(r.shadow->originalValue)
+#define REAL_BINARY_ORIGINAL(original) res.shadow->originalValue = original(a.shadow->originalValue, b.shadow->originalValue)
+#endif
+
 #if KEEP_ORIGINAL
-#define EXPBODY \
-    EXP_R(res.shadow->shadowValue, r.shadow->shadowValue); \
-    res.shadow->originalValue = exp(r.shadow->originalValue);\
+#define REAL_UNARY_BODY(port, original) \
+    PROFILE_OP(); \
+    port(res.shadow->shadowValue, r.shadow->shadowValue); \
+    REAL_UNARY_ORIGINAL(original); \
+    return std::move(res)
+#define REAL_BINARY_BODY(port, original) \
+    PROFILE_OP(); \
+    port(res.shadow->shadowValue, a.shadow->shadowValue, b.shadow->shadowValue); \
+    REAL_BINARY_ORIGINAL(original); \
+    return std::move(res)
+#define REAL_BINARY_BODY2(port, original, x) \
+    PROFILE_OP(); \
+    port(res.shadow->shadowValue, a.shadow->shadowValue, b.shadow->shadowValue); \
+    REAL_BINARY_ORIGINAL(original); \
+    real::RealPool<real::Real>::INSTANCE.put(&x); \
     return std::move(res)
 #else
-#define EXPBODY \
-    EXP_R(res.shadow->shadowValue, r.shadow->shadowValue); \
+#define REAL_UNARY_BODY(port, original) \
+    PROFILE_OP(); \
+    port(res.shadow->shadowValue, r.shadow->shadowValue); \
+    return std::move(res)
+#define REAL_BINARY_BODY(port, original) \
+    PROFILE_OP(); \
+    port(res.shadow->shadowValue, a.shadow->shadowValue, b.shadow->shadowValue); \
+    return std::move(res)
+#define REAL_BINARY_BODY2(port, original, x) \
+    PROFILE_OP(); \
+    port(res.shadow->shadowValue, a.shadow->shadowValue, b.shadow->shadowValue); \
+    real::RealPool<real::Real>::INSTANCE.put(&x); \
     return std::move(res)
 #endif
 
-    real::Real &&RealExp(const real::Real &r)
-    {
-#if TRACK_ERROR
-        ERROR_STATE.updateSymbolicVarError(r.shadow->error);
-#endif
-        real::Real &res = *real::RealPool<real::Real>::INSTANCE.get();
-        EXPBODY;
+// Overloads of a math function for reals, pooled temporaries and doubles.
+// port is the port macro computing the shadow, original the function applied to the originals.
+#define REAL_UNARY_FUNCTION(name, port, original) \
+    real::Real &&name(const real::Real &r) \
+    { \
+        REAL_TRACK_INPUT(r); \
+        real::Real &res = *real::RealPool<real::Real>::INSTANCE.get(); \
+        REAL_UNARY_BODY(port, original); \
+    } \
+    real::Real &&name(real::Real &&r) \
+    { \
+        real::Real &res = r; \
+        REAL_UNARY_BODY(port, original); \
+    } \
+    real::Real &&name(double dr) \
+    { \
+        real::Real &r = *real::RealPool<real::Real>::INSTANCE.get(); \
+        real::Real &res = r; \
+        SET_SINGLE(*r.shadow, false); \
+        r = dr; \
+        REAL_UNARY_BODY(port, original); \
     }
-    real::Real &&RealExp(real::Real &&r)
-    {
-        real::Real &res = r;
-        EXPBODY;
+
+#define REAL_BINARY_FUNCTION(name, port, original) \
+    real::Real &&name(const real::Real &a, const real::Real &b) \
+    { \
+        REAL_TRACK_INPUT(a); \
+        REAL_TRACK_INPUT(b); \
+        real::Real &res = *real::RealPool<real::Real>::INSTANCE.get(); \
+        REAL_BINARY_BODY(port, original); \
+    } \
+    real::Real &&name(real::Real &&a, const real::Real &b) \
+    { \
+        REAL_TRACK_INPUT(b); \
+        real::Real &res = a; \
+        REAL_BINARY_BODY(port, original); \
+    } \
+    real::Real &&name(const real::Real &a, real::Real &&b) \
+    { \
+        REAL_TRACK_INPUT(a); \
+        real::Real &res = b; \
+        REAL_BINARY_BODY(port, original); \
+    } \
+    real::Real &&name(real::Real &&a, real::Real &&b) \
+    { \
+        real::Real &res = a; \
+        REAL_BINARY_BODY2(port, original, b); \
+    } \
+    real::Real &&name(const real::Real &a, double db) \
+    { \
+        REAL_TRACK_INPUT(a); \
+        real::Real &b = *real::RealPool<real::Real>::INSTANCE.get(); \
+        real::Real &res = b; \
+        SET_SINGLE(*b.shadow, a.shadow->single); \
+        b = db; \
+        REAL_BINARY_BODY(port, original); \
+    } \
+    real::Real &&name(double da, const real::Real &b) \
+    { \
+        REAL_TRACK_INPUT(b); \
+        real::Real &a = *real::RealPool<real::Real>::INSTANCE.get(); \
+        real::Real &res = a; \
+        SET_SINGLE(*a.shadow, b.shadow->single); \
+        a = da; \
+        REAL_BINARY_BODY(port, original); \
+    } \
+    real::Real &&name(real::Real &&a, double db) \
+    { \
+        real::Real &res = a; \
+        real::Real b(db); \
+        NARROW_R(*b.shadow, *a.shadow); \
+        REAL_BINARY_BODY(port, original); \
+    } \
+    real::Real &&name(double da, real::Real &&b) \
+    { \
+        real::Real a(da); \
+        NARROW_R(*a.shadow, *b.shadow); \
+        real::Real &res = b; \
+        REAL_BINARY_BODY(port, original); \
     }
-    real::Real &&RealExp(double dr)
+
+    REAL_UNARY_FUNCTION(RealExp, EXP_R, std::exp)
+    REAL_UNARY_FUNCTION(RealSqrt, SQRT_R, std::sqrt)
+    REAL_BINARY_FUNCTION(RealPow, POW_RR, std::pow)
+
+    REAL_UNARY_FUNCTION(RealLog, LOG_R, std::log)
+    REAL_UNARY_FUNCTION(RealLog10, LOG10_R, std::log10)
+    REAL_UNARY_FUNCTION(RealLog2, LOG2_R, std::log2)
+    REAL_UNARY_FUNCTION(RealLog1p, LOG1P_R, std::log1p)
+    REAL_UNARY_FUNCTION(RealExpm1, EXPM1_R, std::expm1)
+    REAL_UNARY_FUNCTION(RealSin, SIN_R, std::sin)
+    REAL_UNARY_FUNCTION(RealCos, COS_R, std::cos)
+    REAL_UNARY_FUNCTION(RealTan, TAN_R, std::tan)
+    REAL_UNARY_FUNCTION(RealAsin, ASIN_R, std::asin)
+    REAL_UNARY_FUNCTION(RealAcos, ACOS_R, std::acos)
+    REAL_UNARY_FUNCTION(RealAtan, ATAN_R, std::atan)
+    REAL_UNARY_FUNCTION(RealSinh, SINH_R, std::sinh)
+    REAL_UNARY_FUNCTION(RealCosh, COSH_R, std::cosh)
+    REAL_UNARY_FUNCTION(RealTanh, TANH_R, std::tanh)
+    REAL_UNARY_FUNCTION(RealAsinh, ASINH_R, std::asinh)
+    REAL_UNARY_FUNCTION(RealAcosh, ACOSH_R, std::acosh)
+    REAL_UNARY_FUNCTION(RealAtanh, ATANH_R, std::atanh)
+    REAL_UNARY_FUNCTION(RealFabs, FABS_R, std::fabs)
+    REAL_UNARY_FUNCTION(RealFloor, FLOOR_R, std::floor)
+    REAL_UNARY_FUNCTION(RealCeil, CEIL_R, std::ceil)
+    REAL_UNARY_FUNCTION(RealTrunc, TRUNC_R, std::trunc)
+    REAL_UNARY_FUNCTION(RealRound, ROUND_R, std::round)
+    REAL_UNARY_FUNCTION(RealCbrt, CBRT_R, std::cbrt)
+    REAL_UNARY_FUNCTION(RealErf, ERF_R, std::erf)
+    REAL_UNARY_FUNCTION(RealErfc, ERFC_R, std::erfc)
+
+    REAL_BINARY_FUNCTION(RealAtan2, ATAN2_RR, std::atan2)
+    REAL_BINARY_FUNCTION(RealFmod, FMOD_RR, std::fmod)
+    REAL_BINARY_FUNCTION(RealFmin, FMIN_RR, std::fmin)
+    REAL_BINARY_FUNCTION(RealFmax, FMAX_RR, std::fmax)
+    REAL_BINARY_FUNCTION(RealHypot, HYPOT_RR, std::hypot)
+
+    namespace fused
     {
-        real::Real &r = *real::RealPool<real::Real>::INSTANCE.get();
-        real::Real &res = r;
-        r = dr;
-        EXPBODY;
-    }
+        // pooled temporaries arrive as Real&& and deduce T = Real
+        template <typename T>
+        using is_temp = std::is_same<T, Real>;
 
+        inline Real &scratch(int slot)
+        {
+            static Real s[3];
+            return s[slot];
+        }
 
+        // doubles are loaded into scratch shadows, reals are used in place
+        template <typename T, typename V>
+        inline const Real &operand(V &v, int slot)
+        {
+            if constexpr (std::is_arithmetic<typename std::decay<V>::type>::value)
+            {
+                Real &s = scratch(slot);
+                s.setWidth<typename std::decay<V>::type>() = (double)v;
+                return s;
+            }
+            else
+            {
+                if constexpr (!is_temp<T>::value)
+                    REAL_TRACK_INPUT(v);
+                return v;
+            }
+        }
+
+        template <typename T, typename V>
+        inline Real *temp(V &v)
+        {
+            if constexpr (is_temp<T>::value)
+                return &v;
+            else
+                return nullptr;
+        }
+
+        inline void recycle(Real *t, Real &res)
+        {
+            if (t != nullptr && t != &res)
+                RealPool<Real>::INSTANCE.put(t);
+        }
 
 #if KEEP_ORIGINAL
-#define SQRTBODY \
-    SQRT_R(res.shadow->shadowValue, r.shadow->shadowValue); \
-    res.shadow->originalValue = sqrt(r.shadow->originalValue);\
-    return std::move(res)
+        // the original program does not fuse: sp * (a*b) + sc * c, each operation at the width of its operands
+        inline double original(const ShadowState &a, const ShadowState &b, const ShadowState &c, double sp, double sc, bool &single)
+        {
+#if ORIGINAL_WIDTHS
+            single = a.single && b.single;
+            double p = NARROW(a.originalValue * b.originalValue, single);
+            single = single && c.single;
+            return NARROW(sp * p + sc * c.originalValue, single);
 #else
-#define EXPBODY \
-    SQRT_R(res.shadow->shadowValue, r.shadow->shadowValue); \
-    return std::move(res)
+            single = false;
+            return sp * (a.originalValue * b.originalValue) + sc * c.originalValue;
 #endif
-
-    real::Real &&RealSqrt(const real::Real &r)
-    {
-#if TRACK_ERROR
-        ERROR_STATE.updateSymbolicVarError(r.shadow->error);
+        }
 #endif
-        real::Real &res = *real::RealPool<real::Real>::INSTANCE.get();
-        SQRTBODY;
-    }
-    real::Real &&RealSqrt(real::Real &&r)
-    {
-        real::Real &res = r;
-        SQRTBODY;
-    }
-    real::Real &&RealSqrt(double dr)
-    {
-        real::Real &r = *real::RealPool<real::Real>::INSTANCE.get();
-        real::Real &res = r;
-        r = dr;
-        SQRTBODY;
-    }
-
-
-    
+    }; // namespace fused
 
+    // FUSED_BODY(port, sp, sc): computes a fused operation sp * (a*b) + sc * c into the first temporary
+    // operand (or a pooled real), without materializing the product. Originals are computed unfused.
 #if KEEP_ORIGINAL
-#define POWBODY \
-    POW_RR(res.shadow->shadowValue, a.shadow->shadowValue, b.shadow->shadowValue); \
-    res.shadow->originalValue = pow(a.shadow->originalValue, b.shadow->originalValue); \
-    return std::move(res)
-#define POWBODY2(x) \
-    POW_RR(res.shadow->shadowValue, a.shadow->shadowValue, b.shadow->shadowValue); \
-    res.shadow->originalValue = pow(a.shadow->originalValue, b.shadow->originalValue); \
-    real::RealPool<real::Real>::INSTANCE.put(&x); \
-    return std::move(res)
+#define FUSED_ORIGINAL(sp, sc) bool single; double o = fused::original(*ra.shadow, *rb.shadow, *rc.shadow, sp, sc, single)
+#define FUSED_SET_ORIGINAL res.shadow->originalValue = o; SET_SINGLE(*res.shadow, single)
 #else
-#define POWBODY \
-    POW_RR(res.shadow->shadowValue, a.shadow->shadowValue, b.shadow->shadowValue); \
+#define FUSED_ORIGINAL(sp, sc)
+#define FUSED_SET_ORIGINAL
+#endif
+#define FUSED_BODY(port, sp, sc) \
+    const real::Real &ra = fused::operand<A>(a, 0); \
+    const real::Real &rb = fused::operand<B>(b, 1); \
+    const real::Real &rc = fused::operand<C>(c, 2); \
+    real::Real *ta = fused::temp<A>(a), *tb = fused::temp<B>(b), *tc = fused::temp<C>(c); \
+    real::Real &res = ta ? *ta : tb ? *tb : tc ? *tc : *real::RealPool<real::Real>::INSTANCE.get(); \
+    FUSED_ORIGINAL(sp, sc); \
+    PROFILE_OP(); \
+    port(res.shadow->shadowValue, ra.shadow->shadowValue, rb.shadow->shadowValue, rc.shadow->shadowValue); \
+    FUSED_SET_ORIGINAL; \
+    fused::recycle(tb, res); \
+    fused::recycle(tc, res); \
     return std::move(res)
-#define POWBODY2(x) \
-    POW_RR(res.shadow->shadowValue, a.shadow->shadowValue, b.shadow->shadowValue); \
-    real::RealPool<real::Real>::INSTANCE.put(&x); \
-    return std::move(res)
-#endif
 
-    real::Real &&RealPow(const real::Real &a, const real::Real &b)
+    // a*b + c
+    template <typename A, typename B, typename C>
+    real::Real &&RealFma(A &&a, B &&b, C &&c)
     {
-#if TRACK_ERROR
-        ERROR_STATE.updateSymbolicVarError(a.shadow->error);
-        ERROR_STATE.updateSymbolicVarError(b.shadow->error);
-#endif
-        real::Real &res = *real::RealPool<real::Real>::INSTANCE.get();
-        POWBODY;
+        FUSED_BODY(FMA, 1, 1);
     }
-    real::Real &&RealPow(real::Real &&a, const real::Real &b)
-    {
-#if TRACK_ERROR
-        ERROR_STATE.updateSymbolicVarError(b.shadow->error);
-#endif
-        real::Real &res = a;
-        POWBODY;
-    }
-    real::Real &&RealPow(const real::Real &a, real::Real &&b)
-    {
-#if TRACK_ERROR
-        ERROR_STATE.updateSymbolicVarError(a.shadow->error);
-#endif
-        real::Real &res = b;
-        POWBODY;
-    }
-    real::Real &&RealPow(real::Real &&a, real::Real &&b)
-    {
-        real::Real &res = a;
-        POWBODY2(b);
-    }
-    real::Real &&RealPow(const real::Real &a, double db)
-    {
-#if TRACK_ERROR
-        ERROR_STATE.updateSymbolicVarError(a.shadow->error);
-#endif
-        real::Real &b = *real::RealPool<real::Real>::INSTANCE.get();
-        real::Real &res = b;
-        b = db;
-        POWBODY;
-    }
-    real::Real &&RealPow(double da, const real::Real &b)
-    {
-#if TRACK_ERROR
-        ERROR_STATE.updateSymbolicVarError(b.shadow->error);
-#endif
-        real::Real &a = *real::RealPool<real::Real>::INSTANCE.get();
-        real::Real &res = a;
-        a = da;
-        POWBODY;
-    }
-    real::Real &&RealPow(real::Real &&a, double db)
+
+    // a*b - c
+    template <typename A, typename B, typename C>
+    real::Real &&RealFms(A &&a, B &&b, C &&c)
     {
-        real::Real &res = a;
-        real::Real b(db);
-        POWBODY;
+        FUSED_BODY(FMS, 1, -1);
     }
-    real::Real &&RealPow(double da, real::Real &&b)
+
+    // c - a*b
+    template <typename A, typename B, typename C>
+    real::Real &&RealFnma(A &&a, B &&b, C &&c)
     {
-        real::Real a(da);
-        real::Real &res = b;
-        POWBODY;
+        FUSED_BODY(FNMA, -1, 1);
     }
 }; // namespace real
 
@@ -6,6 +6,13 @@
 #define MPFR_PORT 0
 #define DD_PORT 1
 #define QD_PORT 2
+#define COMPACT_PORT 3 // double plus a float error estimate, for screening runs
+#define DOUBLE_PORT 4 // plain double shadows, for float programs
+#define CONDITION_PORT 5 // no shadow value, local condition numbers only (CONDITION_NUMBER_MODE)
+#define STOCHASTIC_PORT 6 // 4 randomly rounded samples (CESTAC), significant digits from their agreement
+#define INTERVAL_PORT 7 // rigorous enclosures [lo, hi] of the exact values
+#define AFFINE_PORT 8 // rigorous affine forms with AFFINE_SYMBOLS noise symbols
+#define FLOAT128_PORT 9 // IEEE binary128 (__float128, link with -lquadmath)
 
 
 
@@ -14,6 +21,22 @@
 #define PORT_TYPE DD_PORT
 #endif
 
+/*
+    A flag for programs computing in float, or in float and double. Every original then carries its own width
+    (ShadowState::single) and is rounded to it as the program rounds:
+      - shadows of float variables are float, see Real::setWidth, and stores into a variable keep its width;
+      - an operation is float when its operands are, a double constant takes the width of the other operand;
+      - relative errors of float originals are also reported in float ulps.
+    Without the flag every original is a double. DOUBLE_PORT is the cheapest shadow for float programs.
+*/
+#ifndef ORIGINAL_WIDTHS
+#define ORIGINAL_WIDTHS false
+#endif
+
+#define ORIGINAL_ULP 2.220446049250313e-16 // 2^-52, of double originals
+#define ORIGINAL_ULP_EXPONENT -52
+#define FLOAT_ULP 1.1920928955078125e-07 // 2^-23
+
 /* 
     A flag that determines whether an original execution should be performed along with the shadow execution.
     This flag should be used for debugging.
@@ -26,6 +49,7 @@
 #define DEBUGING_MODE 1
 #define RANGE_ACTIVE_MODE 2
 #define FULL_ACTIVE_MODE 3
+#define CONDITION_NUMBER_MODE 4 // lightweight screening, see ConditionPort.hpp
 
 
 #ifndef TRANCKING_MODE
@@ -55,6 +79,11 @@
 #define TRACK_ERROR true
 #define ACTIVE_TRACK_ERROR true
 #define TRACKING_ON true
+#elif TRANCKING_MODE == CONDITION_NUMBER_MODE
+#define TRACK_ERROR false
+#define ACTIVE_TRACK_ERROR false
+#define TRACKING_ON false
+#define TRACK_CONDITION true
 #endif
 #endif
 
@@ -83,6 +112,44 @@
 #define KEEP_ORIGINAL true
 #endif
 
+/*
+    Per-PC condition numbers instead of shadow values. The mode selects CONDITION_PORT, whose shadows are
+    the original values, so that no separate original is kept. PCs whose maximal condition number reaches
+    2^CONDITION_FLAG_BITS are flagged in the report at exit.
+*/
+#ifndef TRACK_CONDITION
+#define TRACK_CONDITION false
+#endif
+#if TRACK_CONDITION
+#undef PORT_TYPE
+#define PORT_TYPE CONDITION_PORT
+#undef KEEP_ORIGINAL
+#define KEEP_ORIGINAL false
+#endif
+#ifndef CONDITION_FLAG_BITS
+#define CONDITION_FLAG_BITS 20
+#endif
+
+/*
+    Metric of the error estimates. RELATIVE_METRIC is |shadow - original| / |shadow|. ULP_METRIC is the distance of
+    the two in ulps of the original's width, from their bit patterns as integers and without a division, and is
+    reported as ulps * ORIGINAL_ULP (FLOAT_ULP for float originals) so that both read as relative errors. They agree within a factor of 2 while the error is
+    well below 1, i.e., while the two are within a binade or so. Beyond that they diverge: every binade between them
+    adds the ulps of a whole binade, 2^52 of double, regardless of the distance, e.g., 0 and 1 are about 2^62 ulps
+    of double apart.
+    With ERROR_HISTOGRAM the estimates of every PC are also counted in a log2 histogram of ulps of double,
+    see EAST_ERROR_HISTOGRAM.
+*/
+#define RELATIVE_METRIC 0
+#define ULP_METRIC 1
+
+#ifndef ERROR_METRIC
+#define ERROR_METRIC RELATIVE_METRIC
+#endif
+#ifndef ERROR_HISTOGRAM
+#define ERROR_HISTOGRAM (ERROR_METRIC == ULP_METRIC)
+#endif
+
 /* 
     A flag that determines whether real values are stored in pool.
 */
@@ -97,6 +164,136 @@
 
 #define CACHE_SIZE 0x8000
 
-#define __LITTLE_ENDIAN
+/*
+    Out-of-core shadows of heap arrays, see SpillStorage.hpp.
+    Shadow blocks of at least SPILL_THRESHOLD bytes are mapped from unlinked files under SPILL_DIR,
+    and at most SPILL_RESIDENT_LIMIT bytes of them are kept resident.
+*/
+#ifndef SHADOW_SPILL
+#define SHADOW_SPILL false
+#endif
+#ifndef SPILL_DIR
+#define SPILL_DIR "/tmp"
+#endif
+#ifndef SPILL_THRESHOLD
+#define SPILL_THRESHOLD (256UL << 20)
+#endif
+#ifndef SPILL_RESIDENT_LIMIT
+#define SPILL_RESIDENT_LIMIT (4UL << 30)
+#endif
+#ifndef SPILL_CHUNK_SHIFT
+#define SPILL_CHUNK_SHIFT 26
+#endif
+
+/*
+    JIT-compiled shadow kernels of EAST_JIT sites, see ShadowJit.hpp.
+    A site is interpreted until it has run SHADOW_JIT_THRESHOLD times, then a kernel is compiled
+    with LLVM ORC (link with `llvm-config --ldflags --libs orcjit native --system-libs`).
+*/
+#ifndef SHADOW_JIT
+#define SHADOW_JIT false
+#endif
+#ifndef SHADOW_JIT_THRESHOLD
+#define SHADOW_JIT_THRESHOLD 1000
+#endif
+
+/*
+    Per-PC execution counts (and, in instrumented builds, per-PC errors) written at exit to PC_PROFILE_FILE,
+    for turnFpArith -profile/-error-profile, see PcProfile.hpp.
+*/
+#ifndef PC_PROFILE
+#define PC_PROFILE false
+#endif
+#ifndef PC_PROFILE_FILE
+#define PC_PROFILE_FILE "east.profile"
+#endif
+
+/*
+    Per-PC ticks of shadow execution, written at exit to SHADOW_PROFILE_FILE, see CycleProfile.hpp.
+    On average every SHADOW_PROFILE_PERIOD-th statement is timed, at random.
+*/
+#ifndef SHADOW_PROFILE
+#define SHADOW_PROFILE false
+#endif
+#ifndef SHADOW_PROFILE_PERIOD
+#define SHADOW_PROFILE_PERIOD 1
+#endif
+#ifndef SHADOW_PROFILE_FILE
+#define SHADOW_PROFILE_FILE "east.cycles"
+#endif
+
+/*
+    Memory of the shadow runtime by kind and per PC, written in the Prometheus text format to SHADOW_MEMSTATS_FILE
+    every SHADOW_MEMSTATS_INTERVAL seconds and at exit, see MemStats.hpp.
+    With SHADOW_POOL_HIGH_WATER > 0, pools with more free values than that are trimmed at every dump.
+*/
+#ifndef SHADOW_MEMSTATS
+#define SHADOW_MEMSTATS false
+#endif
+#ifndef SHADOW_MEMSTATS_FILE
+#define SHADOW_MEMSTATS_FILE "east.memstats.prom"
+#endif
+#ifndef SHADOW_MEMSTATS_INTERVAL
+#define SHADOW_MEMSTATS_INTERVAL 1.0
+#endif
+#ifndef SHADOW_POOL_HIGH_WATER
+#define SHADOW_POOL_HIGH_WATER 0
+#endif
+
+/*
+    Error reports of EAST_DUMP_ERROR as "[ERROR]" text or as JSON lines, see AsyncReport.hpp.
+    With SHADOW_ASYNC_REPORT, EAST_DUMP_ERROR and EAST_DRAW_ERROR only queue a snapshot in a ring of
+    SHADOW_REPORT_CAPACITY records (a power of two), and a background thread writes them (link with -pthread).
+    Reports come from one thread, the thread of the first report.
+    While the ring is full only every Nth report is queued, N doubling up to SHADOW_REPORT_MAX_SAMPLING.
+*/
+#define REPORT_TEXT 0
+#define REPORT_JSON 1
+#ifndef SHADOW_REPORT_FORMAT
+#define SHADOW_REPORT_FORMAT REPORT_TEXT
+#endif
+#ifndef SHADOW_ASYNC_REPORT
+#define SHADOW_ASYNC_REPORT false
+#endif
+#ifndef SHADOW_REPORT_CAPACITY
+#define SHADOW_REPORT_CAPACITY 1024
+#endif
+#ifndef SHADOW_REPORT_MAX_SAMPLING
+#define SHADOW_REPORT_MAX_SAMPLING 1024
+#endif
+
+/*
+    Binary trace of the error estimates, provenance edges and control-flow divergences of a run, written in blocks
+    of SHADOW_TRACE_BLOCK records to SHADOW_TRACE_FILE, see ErrorTrace.hpp. Every SHADOW_TRACE_PERIOD-th estimate
+    and edge is recorded. Query the trace offline with bin/easttrace.
+*/
+#ifndef SHADOW_TRACE
+#define SHADOW_TRACE false
+#endif
+#ifndef SHADOW_TRACE_FILE
+#define SHADOW_TRACE_FILE "east.trace"
+#endif
+#ifndef SHADOW_TRACE_PERIOD
+#define SHADOW_TRACE_PERIOD 1
+#endif
+#ifndef SHADOW_TRACE_BLOCK
+#define SHADOW_TRACE_BLOCK 65536
+#endif
+
+/*
+    Per-PC tables of the SHADOW_PROVENANCE_K PCs that contributed the most error to a PC, in fixed memory per PC,
+    for EAST_EXPLAIN_ERROR, see Provenance.hpp.
+*/
+#ifndef SHADOW_PROVENANCE
+#define SHADOW_PROVENANCE false
+#endif
+#ifndef SHADOW_PROVENANCE_K
+#define SHADOW_PROVENANCE_K 8
+#endif
+
+// little-endian host for __HI/__LO (ShadowValue.hpp), with the value of glibc's <endian.h> so that both agree
+#ifndef __LITTLE_ENDIAN
+#define __LITTLE_ENDIAN 1234
+#endif
 
 #endif
\ No newline at end of file
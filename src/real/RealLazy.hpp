@@ -1,10 +1,22 @@
 #ifndef REAL_LAZY_HPP
-#define REAL_LAYZ_HPP
+#define REAL_LAZY_HPP
+#include <type_traits>
 #include "RealConfigure.h"
 #include "ShadowValue.hpp"
+#include "Real.hpp"
 
 /*
-The code is current out of date.
+Lazy evaluation interface (LEI), see Real.hpp.
+The operators of lazy reals build an expression tree whose shape is encoded in its type, and nothing
+is computed until the tree is assigned. Then the whole tree is evaluated in one inlined pass:
+  - leaves read the shadow states of the variables in place,
+  - inner results are locals of the evaluator instead of pooled temporaries,
+  - a*b+c, a*b-c and c-a*b become one FMA, FMS or FNMA of the port (TernaryOperator).
+Inner nodes and double operands are stored by value and only leaves by reference, so a tree stays
+valid as long as its leaves, e.g., the one cached in an ExpressionSlot.
+
+turnFpArith -lazy emits real::lazy::assign(target, tree) for arithmetic assignments, where the
+leaves are views (real::lazy::view) of the eager shadows.
 */
 
 namespace real
@@ -19,1165 +31,503 @@ namespace real
             MUL = 3,
             DIV = 4,
             FMA = 5,
-            FMS = 6
+            FMS = 6,
+            FNMA = 7,
+            NEG = 8
         };
+
+        static const int TEMP_PRECISION = 120; // as real::ShadowInitializer
+
         template <typename Derived>
-        struct RealBase;
+        struct RealBase
+        {
+            INLINE_FLAGS const Derived &derived() const { return *static_cast<const Derived *>(this); }
+        };
+
+        struct Real;
         template <Operator opCode, typename L, typename R>
         struct BinaryOperator;
         template <Operator opCode, typename L, typename M, typename R>
         struct TernaryOperator;
-        struct Real;
-
-        template <typename E>
-        struct ExpressionEvaluator
-        {
-            INLINE_FLAGS static void eval(const real::sval_ptr acc, const E &exp)
-            {
-                assert(false);
-            }
-            INLINE_FLAGS static const real::sval_ptr eval(const E &exp)
-            {
-                assert(false);
-                return nullptr;
-            }
-        };
+        template <Operator opCode, typename T>
+        struct UnaryOperator;
 
         template <typename T>
         struct trails
         {
-            static const bool isRealBase = false;
-            static const Operator opCode = Operator::NOP;
-            typedef T DerivedType;
-        };
-
-        template <>
-        struct trails<RealBase<Real>>
-        {
-            static const bool isRealBase = true;
+            static const bool isRealBase = std::is_base_of<RealBase<T>, T>::value;
             static const Operator opCode = Operator::NOP;
-            using DerivedType = Real;
-            using LType = void; // double or RealBase
-            using MType = void; // double or RealBase
-            using RType = void; // double or RealBase
+            // leaves are referenced, inner nodes and doubles are copied
+            using StorageType = typename std::conditional<std::is_same<T, Real>::value, const Real &,
+                                                          typename std::conditional<isRealBase, T, double>::type>::type;
+            using NodeType = typename std::conditional<isRealBase, T, double>::type;
         };
 
         template <Operator op, typename L, typename R>
-        struct trails<RealBase<BinaryOperator<op, L, R>>>
-        {
-            static const bool isRealBase = true;
-            static const Operator opCode = op;
-            using LType = L;    // double or RealBase
-            using MType = void; // double or RealBase
-            using RType = R;    // double or RealBase
-            using DerivedType = BinaryOperator<op, L, R>;
-        };
-
-        template <Operator op, typename L, typename M, typename R>
-        struct trails<RealBase<TernaryOperator<op, L, M, R>>>
+        struct trails<BinaryOperator<op, L, R>>
         {
             static const bool isRealBase = true;
             static const Operator opCode = op;
-            using LType = L; // double or RealBase
-            using MType = M; // double or RealBase
-            using RType = R; // double or RealBase
-            using DerivedType = TernaryOperator<op, L, M, R>;
+            using LType = L;
+            using RType = R;
+            using StorageType = BinaryOperator<op, L, R>;
+            using NodeType = BinaryOperator<op, L, R>;
         };
 
-        template <typename Derived>
-        struct RealBase
-        {
-            INLINE_FLAGS const Derived &derived() const { return *static_cast<const Derived *>(this); }
-
-            // FMA1
-            template <typename DerivedR>
-            INLINE_FLAGS friend std::enable_if_t<trails<RealBase<Derived>>::opCode == Operator::MUL && trails<typename trails<RealBase<Derived>>::LType>::isRealBase && trails<typename trails<RealBase<Derived>>::RType>::isRealBase,
-                                           TernaryOperator<Operator::FMA, typename trails<RealBase<Derived>>::LType, typename trails<RealBase<Derived>>::RType, RealBase<DerivedR>>>
-            operator+(const RealBase<Derived> &l, const RealBase<DerivedR> &r)
-            {
-                const BinaryOperator<Operator::MUL, typename trails<RealBase<Derived>>::LType, typename trails<RealBase<Derived>>::RType> &lop = l.derived();
-                return TernaryOperator<Operator::FMA, typename trails<RealBase<Derived>>::LType, typename trails<RealBase<Derived>>::RType, RealBase<DerivedR>>(lop.lhs, lop.rhs, r);
-            }
-
-            // FMA2
-            template <typename DerivedR>
-            INLINE_FLAGS friend std::enable_if_t<
-                !(trails<RealBase<Derived>>::opCode == Operator::MUL && trails<typename trails<RealBase<Derived>>::LType>::isRealBase && trails<typename trails<RealBase<Derived>>::RType>::isRealBase) && (trails<RealBase<DerivedR>>::opCode == Operator::MUL && trails<typename trails<RealBase<DerivedR>>::LType>::isRealBase && trails<typename trails<RealBase<DerivedR>>::RType>::isRealBase),
-                TernaryOperator<Operator::FMA, typename trails<RealBase<DerivedR>>::LType, typename trails<RealBase<DerivedR>>::RType, RealBase<Derived>>>
-            operator+(const RealBase<Derived> &l, const RealBase<DerivedR> &r)
-            {
-                const BinaryOperator<Operator::MUL, typename trails<RealBase<DerivedR>>::LType, typename trails<RealBase<DerivedR>>::RType> &rop = r.derived();
-                return TernaryOperator<Operator::FMA, typename trails<RealBase<DerivedR>>::LType, typename trails<RealBase<DerivedR>>::RType, RealBase<Derived>>(rop.lhs, rop.rhs, l);
-            }
-
-            template <typename DerivedR>
-            INLINE_FLAGS friend std::enable_if_t<
-                !(trails<RealBase<Derived>>::opCode == Operator::MUL && trails<typename trails<RealBase<Derived>>::LType>::isRealBase && trails<typename trails<RealBase<Derived>>::RType>::isRealBase) && !(trails<RealBase<DerivedR>>::opCode == Operator::MUL && trails<typename trails<RealBase<DerivedR>>::LType>::isRealBase && trails<typename trails<RealBase<DerivedR>>::RType>::isRealBase),
-                BinaryOperator<Operator::ADD, RealBase<Derived>, RealBase<DerivedR>>>
-            operator+(const RealBase<Derived> &l, const RealBase<DerivedR> &r)
-            {
-                return BinaryOperator<Operator::ADD, RealBase<Derived>, RealBase<DerivedR>>(l, r);
-            }
-
-            // FMS1
-            template <typename DerivedR>
-            INLINE_FLAGS friend std::enable_if_t<trails<RealBase<Derived>>::opCode == Operator::MUL && trails<typename trails<RealBase<Derived>>::LType>::isRealBase && trails<typename trails<RealBase<Derived>>::RType>::isRealBase,
-                                           TernaryOperator<Operator::FMS, typename trails<RealBase<Derived>>::LType, typename trails<RealBase<Derived>>::RType, RealBase<DerivedR>>>
-            operator-(const RealBase<Derived> &l, const RealBase<DerivedR> &r)
-            {
-                const BinaryOperator<Operator::MUL, typename trails<RealBase<Derived>>::LType, typename trails<RealBase<Derived>>::RType> &lop = l.derived();
-                return TernaryOperator<Operator::FMS, typename trails<RealBase<Derived>>::LType, typename trails<RealBase<Derived>>::RType, RealBase<DerivedR>>(lop.lhs, lop.rhs, r);
-            }
-
-            // FMS2
-            template <typename DerivedR>
-            INLINE_FLAGS friend std::enable_if_t<
-                !(trails<RealBase<Derived>>::opCode == Operator::MUL && trails<typename trails<RealBase<Derived>>::LType>::isRealBase && trails<typename trails<RealBase<Derived>>::RType>::isRealBase) && (trails<RealBase<DerivedR>>::opCode == Operator::MUL && trails<typename trails<RealBase<DerivedR>>::LType>::isRealBase && trails<typename trails<RealBase<DerivedR>>::RType>::isRealBase),
-                TernaryOperator<Operator::FMS, typename trails<RealBase<DerivedR>>::LType, typename trails<RealBase<DerivedR>>::RType, RealBase<Derived>>>
-            operator-(const RealBase<Derived> &l, const RealBase<DerivedR> &r)
-            {
-                const BinaryOperator<Operator::MUL, typename trails<RealBase<DerivedR>>::LType, typename trails<RealBase<DerivedR>>::RType> &rop = r.derived();
-                return TernaryOperator<Operator::FMS, typename trails<RealBase<DerivedR>>::LType, typename trails<RealBase<DerivedR>>::RType, RealBase<Derived>>(rop.lhs, rop.rhs, l);
-            }
-
-            template <typename DerivedR>
-            INLINE_FLAGS friend std::enable_if_t<
-                !(trails<RealBase<Derived>>::opCode == Operator::MUL && trails<typename trails<RealBase<Derived>>::LType>::isRealBase && trails<typename trails<RealBase<Derived>>::RType>::isRealBase) && !(trails<RealBase<DerivedR>>::opCode == Operator::MUL && trails<typename trails<RealBase<DerivedR>>::LType>::isRealBase && trails<typename trails<RealBase<DerivedR>>::RType>::isRealBase),
-                BinaryOperator<Operator::SUB, RealBase<Derived>, RealBase<DerivedR>>>
-            operator-(const RealBase<Derived> &l, const RealBase<DerivedR> &r)
-            {
-                return BinaryOperator<Operator::SUB, RealBase<Derived>, RealBase<DerivedR>>(l, r);
-            }
-
-            template <typename DerivedR>
-            INLINE_FLAGS friend BinaryOperator<Operator::MUL, RealBase<Derived>, RealBase<DerivedR>> operator*(const RealBase<Derived> &l, const RealBase<DerivedR> &r)
-            {
-                return BinaryOperator<Operator::MUL, RealBase<Derived>, RealBase<DerivedR>>(l, r);
-            }
-
-            template <typename DerivedR>
-            INLINE_FLAGS friend BinaryOperator<Operator::DIV, RealBase<Derived>, RealBase<DerivedR>> operator/(const RealBase<Derived> &l, const RealBase<DerivedR> &r)
-            {
-                return BinaryOperator<Operator::DIV, RealBase<Derived>, RealBase<DerivedR>>(l, r);
-            }
-
-            INLINE_FLAGS friend BinaryOperator<Operator::ADD, RealBase<Derived>, double> operator+(const RealBase<Derived> &l, const double &r)
-            {
-                return BinaryOperator<Operator::ADD, RealBase<Derived>, double>(l, r);
-            }
-            INLINE_FLAGS friend BinaryOperator<Operator::ADD, RealBase<Derived>, double> operator+(const double &r, const RealBase<Derived> &l)
-            {
-                return BinaryOperator<Operator::ADD, RealBase<Derived>, double>(l, r);
-            }
-
-            INLINE_FLAGS friend BinaryOperator<Operator::MUL, RealBase<Derived>, double> operator-(const RealBase<Derived> &l, const double &r)
-            {
-                return BinaryOperator<Operator::SUB, RealBase<Derived>, double>(l, r);
-            }
-
-            INLINE_FLAGS friend BinaryOperator<Operator::MUL, double, RealBase<Derived>> operator-(const double &r, const RealBase<Derived> &l)
-            {
-                return BinaryOperator<Operator::SUB, double, RealBase<Derived>>(r, l);
-            }
-
-            INLINE_FLAGS friend BinaryOperator<Operator::MUL, RealBase<Derived>, double> operator*(const double &r, const RealBase<Derived> &l)
-            {
-                return BinaryOperator<Operator::MUL, RealBase<Derived>, double>(l, r);
-            }
-
-            INLINE_FLAGS friend BinaryOperator<Operator::MUL, RealBase<Derived>, double> operator*(const RealBase<Derived> &l, const double &r)
-            {
-                return BinaryOperator<Operator::MUL, RealBase<Derived>, double>(l, r);
-            }
-
-            INLINE_FLAGS friend BinaryOperator<Operator::DIV, double, RealBase<Derived>> operator/(const double &r, const RealBase<Derived> &l)
-            {
-                return BinaryOperator<Operator::DIV, double, RealBase<Derived>>(r, l);
-            }
+        template <typename T>
+        using node_t = typename trails<T>::NodeType;
 
-            INLINE_FLAGS friend BinaryOperator<Operator::DIV, RealBase<Derived>, double> operator/(const RealBase<Derived> &l, const double &r)
-            {
-                return BinaryOperator<Operator::DIV, RealBase<Derived>, double>(l, r);
-            }
-        };
+        template <typename L, typename R>
+        using enable_operator_t = typename std::enable_if<
+            (trails<L>::isRealBase || trails<R>::isRealBase) &&
+                (trails<L>::isRealBase || std::is_arithmetic<L>::value) &&
+                (trails<R>::isRealBase || std::is_arithmetic<R>::value),
+            int>::type;
 
         template <Operator opCode, typename L, typename R>
         struct BinaryOperator : public RealBase<BinaryOperator<opCode, L, R>>
         {
-            const L &lhs;
-            const R &rhs;
+            typename trails<L>::StorageType lhs;
+            typename trails<R>::StorageType rhs;
             BinaryOperator(const L &l, const R &r) : lhs(l), rhs(r) {}
-            const Operator getOpCode() const { return opCode; }
+            Operator getOpCode() const { return opCode; }
         };
 
         template <Operator opCode, typename L, typename M, typename R>
         struct TernaryOperator : public RealBase<TernaryOperator<opCode, L, M, R>>
         {
-            const L &lhs;
-            const M &mhs;
-            const R &rhs;
+            typename trails<L>::StorageType lhs;
+            typename trails<M>::StorageType mhs;
+            typename trails<R>::StorageType rhs;
             TernaryOperator(const L &l, const M &m, const R &r) : lhs(l), mhs(m), rhs(r) {}
-            const Operator getOpCode() const { return opCode; }
+            Operator getOpCode() const { return opCode; }
         };
 
-        enum RealType
+        template <Operator opCode, typename T>
+        struct UnaryOperator : public RealBase<UnaryOperator<opCode, T>>
         {
-            formal,
-            actual
+            typename trails<T>::StorageType operand;
+            UnaryOperator(const T &t) : operand(t) {}
+            Operator getOpCode() const { return opCode; }
         };
-        struct Real : public RealBase<Real>
-        {
 
-            real::sval_ptr shadow;
-            RealType formal;
-            Real() : formal(RealType::actual)
-            {
-                shadow = ShadowPool::INSTANCE.get();
-            }
-            ~Real()
-            {
-                if (!formal && shadow != nullptr)
-                {
-                    ShadowPool::INSTANCE.put(shadow);
-                    shadow = nullptr;
-                }
-            }
-            Real(double v)
-            {
-                shadow = ShadowPool::INSTANCE.get();
-                ASSIGN_D(shadow->shadowValue, v);
-#if KEEP_ORIGINAL
-                shadow->originalValue = v;
-#endif
-                shadow->avgRelativeError = 0;
-            }
-            Real(const Real &r)
-            {
-                shadow = ShadowPool::INSTANCE.get();
-                ASSIGN(shadow->shadowValue, r.shadow->shadowValue);
-#if KEEP_ORIGINAL
-                shadow->originalValue = r.shadow->originalValue;
-#endif
-                shadow->avgRelativeError = 0;
-            }
-            Real(Real &&r) noexcept
-            {
-                this->shadow = r.shadow;
-                r.shadow = ShadowPool::INSTANCE.get();
-            }
-
-            template <typename Derived>
-            INLINE_FLAGS Real &operator=(const RealBase<Derived> &r)
-            {
-                ExpressionEvaluator<RealBase<Derived>>::eval(this->shadow, r);
-                return *this;
-            }
-
-            template <typename Derived>
-            INLINE_FLAGS Real &operator+=(const RealBase<Derived> &r)
-            {
-                *this = *this + r;
-                return *this;
-            }
+        // a*b + c, c + a*b
+        template <typename L, typename R, enable_operator_t<L, R> = 0>
+        INLINE_FLAGS auto operator+(const L &l, const R &r)
+        {
+            if constexpr (trails<L>::opCode == Operator::MUL)
+                return TernaryOperator<Operator::FMA, typename trails<L>::LType, typename trails<L>::RType, node_t<R>>(l.lhs, l.rhs, r);
+            else if constexpr (trails<R>::opCode == Operator::MUL)
+                return TernaryOperator<Operator::FMA, typename trails<R>::LType, typename trails<R>::RType, node_t<L>>(r.lhs, r.rhs, l);
+            else
+                return BinaryOperator<Operator::ADD, node_t<L>, node_t<R>>(l, r);
+        }
+
+        // a*b - c, c - a*b
+        template <typename L, typename R, enable_operator_t<L, R> = 0>
+        INLINE_FLAGS auto operator-(const L &l, const R &r)
+        {
+            if constexpr (trails<L>::opCode == Operator::MUL)
+                return TernaryOperator<Operator::FMS, typename trails<L>::LType, typename trails<L>::RType, node_t<R>>(l.lhs, l.rhs, r);
+            else if constexpr (trails<R>::opCode == Operator::MUL)
+                return TernaryOperator<Operator::FNMA, typename trails<R>::LType, typename trails<R>::RType, node_t<L>>(r.lhs, r.rhs, l);
+            else
+                return BinaryOperator<Operator::SUB, node_t<L>, node_t<R>>(l, r);
+        }
+
+        template <typename L, typename R, enable_operator_t<L, R> = 0>
+        INLINE_FLAGS BinaryOperator<Operator::MUL, node_t<L>, node_t<R>> operator*(const L &l, const R &r)
+        {
+            return BinaryOperator<Operator::MUL, node_t<L>, node_t<R>>(l, r);
+        }
 
-            template <typename Derived>
-            INLINE_FLAGS Real &operator-=(const RealBase<Derived> &r)
-            {
-                *this = *this - r;
-                return *this;
-            }
+        template <typename L, typename R, enable_operator_t<L, R> = 0>
+        INLINE_FLAGS BinaryOperator<Operator::DIV, node_t<L>, node_t<R>> operator/(const L &l, const R &r)
+        {
+            return BinaryOperator<Operator::DIV, node_t<L>, node_t<R>>(l, r);
+        }
 
-            template <typename Derived>
-            INLINE_FLAGS Real &operator*=(const RealBase<Derived> &r)
-            {
-                *this = *this * r;
-                return *this;
-            }
+        template <typename T, typename std::enable_if<trails<T>::isRealBase, int>::type = 0>
+        INLINE_FLAGS UnaryOperator<Operator::NEG, T> operator-(const T &t)
+        {
+            return UnaryOperator<Operator::NEG, T>(t);
+        }
 
-            template <typename Derived>
-            INLINE_FLAGS Real &operator/=(const RealBase<Derived> &r)
-            {
-                *this = *this / r;
-                return *this;
-            }
+        template <typename T, typename std::enable_if<trails<T>::isRealBase, int>::type = 0>
+        INLINE_FLAGS const T &operator+(const T &t)
+        {
+            return t;
+        }
 
-            INLINE_FLAGS Real &operator=(const double &r)
-            {
-                ASSIGN_D(this->shadow->shadowValue, r);
-#if KEEP_ORIGINAL
-                shadow->originalValue = r;
-#endif
-                return *this;
-            }
+        template <typename E>
+        struct ExpressionEvaluator;
+
+        // An evaluated operand: leaves are read in place, doubles are kept as they are,
+        // inner nodes are evaluated into a local. The locals are laid out as a ShadowState,
+        // the original before the value (see HP_ORIGINAL_OFFSET). single is the width of the
+        // original, a double constant takes the width of the other operand (see ORIGINAL_WIDTHS).
+        template <typename T, bool isNode = trails<T>::isRealBase>
+        struct Operand
+        {
+            static const bool isDouble = false;
+            double original;
+            HP_TYPE value;
+            bool single;
 
-            INLINE_FLAGS Real &operator+=(const double &r)
+            INLINE_FLAGS Operand(const T &node)
             {
-                ADD_RD(this->shadow->shadowValue, this->shadow->shadowValue, r);
-#if KEEP_ORIGINAL
-                shadow->originalValue += r;
+#ifdef HP_ORIGINAL_OFFSET
+                static_assert(offsetof(Operand, value) == offsetof(Operand, original) + HP_ORIGINAL_OFFSET, "layout of ShadowState");
 #endif
-                return *this;
+                INIT(value, TEMP_PRECISION);
+                ExpressionEvaluator<T>::eval(value, original, single, node);
             }
-            INLINE_FLAGS Real &operator-=(const double &r)
+            INLINE_FLAGS ~Operand()
             {
-                SUB_RD(this->shadow->shadowValue, this->shadow->shadowValue, r);
-#if KEEP_ORIGINAL
-                shadow->originalValue -= r;
-#endif
-                return *this;
-            }
-            INLINE_FLAGS Real &operator*=(const double &r)
-            {
-                MUL_RD(this->shadow->shadowValue, this->shadow->shadowValue, r);
-#if KEEP_ORIGINAL
-                shadow->originalValue *= r;
-#endif
-                return *this;
-            }
-            INLINE_FLAGS Real &operator/=(const double &r)
-            {
-                DIV_RD(this->shadow->shadowValue, this->shadow->shadowValue, r);
-#if KEEP_ORIGINAL
-                shadow->originalValue /= r;
-#endif
-                return *this;
+                CLEAR(value);
             }
+            INLINE_FLAGS const HP_TYPE &hp() const { return value; }
+        };
 
-        private:
-            void makeFormal()
-            {
-                if (formal != RealType::formal)
-                {
-                    formal = RealType::formal;
-                    ShadowPool::INSTANCE.put(shadow);
-                    shadow = nullptr;
-                }
-            }
-            template <int, int>
-            friend struct InitLoop;
+        template <typename T>
+        struct Operand<T, false>
+        {
+            static const bool isDouble = true;
+            static const bool single = true;
+            double d;
+            double original;
 
-            friend std::ostream &operator<<(std::ostream &os, const Real &c)
-            {
-                STREAM_OUT(os, c);
-                return os;
-            }
+            INLINE_FLAGS Operand(double v) : d(v), original(v) {}
         };
 
         template <>
-        struct ExpressionEvaluator<RealBase<Real>>
+        struct Operand<Real, true>
         {
-            INLINE_FLAGS static void eval(const real::sval_ptr acc, const RealBase<Real> &v)
-            {
-                ASSIGN(acc->shadowValue, v.derived().shadow->shadowValue);
-            }
+            static const bool isDouble = false;
+            ShadowState *state;
+#if KEEP_ORIGINAL
+            double original;
+#else
+            static constexpr double original = 0;
+#endif
+#if KEEP_ORIGINAL && ORIGINAL_WIDTHS
+            bool single;
+#else
+            static const bool single = false;
+#endif
 
-            INLINE_FLAGS static const real::sval_ptr eval(const RealBase<Real> &r)
-            {
-                return nullptr; // should not use
-            }
+            INLINE_FLAGS Operand(const Real &r);
+            INLINE_FLAGS const HP_TYPE &hp() const { return state->shadowValue; }
         };
 
-        template <Operator opCode, typename L, typename R>
-        struct ExpressionEvaluator<RealBase<BinaryOperator<opCode, L, R>>>
+        // doubles that take part in FMA-like operations are loaded into a high precision local
+        template <typename O, bool isDouble = O::isDouble>
+        struct Promoted
         {
-            INLINE_FLAGS static const real::sval_ptr eval(const RealBase<BinaryOperator<opCode, L, R>> &r)
-            {
-                sval_ptr tmp = ShadowPool::INSTANCE.get();
-                ExpressionEvaluator<RealBase<BinaryOperator<opCode, L, R>>>::eval(tmp, r);
-                return tmp;
-            }
+            const O &o;
+            INLINE_FLAGS Promoted(const O &v) : o(v) {}
+            INLINE_FLAGS const HP_TYPE &hp() const { return o.hp(); }
+        };
 
-            /**
-             * For addition, there are six cases 
-             */
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::ADD && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+        template <typename O>
+        struct Promoted<O, true>
+        {
+            double original;
+            HP_TYPE value;
+            INLINE_FLAGS Promoted(const O &v) : original(v.d)
             {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                const real::sval_ptr rr = r.derived().shadow;
-                ADD_RR(acc->shadowValue, ll->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = ll->originalValue + rr->originalValue;
+#ifdef HP_ORIGINAL_OFFSET
+                static_assert(offsetof(Promoted, value) == offsetof(Promoted, original) + HP_ORIGINAL_OFFSET, "layout of ShadowState");
 #endif
+                INIT(value, TEMP_PRECISION);
+                ASSIGN_D(value, v.d);
             }
-
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::ADD && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<R>::isRealBase == false, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            INLINE_FLAGS ~Promoted()
             {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const double &r = exp.derived().rhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                ADD_RD(acc->shadowValue, ll->shadowValue, r);
-#if KEEP_ORIGINAL
-                acc->originalValue = ll->originalValue + r;
-#endif
+                CLEAR(value);
             }
+            INLINE_FLAGS const HP_TYPE &hp() const { return value; }
+        };
 
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::ADD && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+        template <Operator opCode, typename L, typename R>
+        struct ExpressionEvaluator<BinaryOperator<opCode, L, R>>
+        {
+            INLINE_FLAGS static void eval(HP_TYPE &acc, double &original, bool &single, const BinaryOperator<opCode, L, R> &e)
             {
-                const RealBase<Real> &r = exp.derived().rhs;
-                const sval_ptr rr = r.derived().shadow;
-                if (real_likely(rr != acc))
+                const Operand<L> l(e.lhs);
+                const Operand<R> r(e.rhs);
+                PROFILE_OP();
+                if constexpr (opCode == Operator::ADD)
                 {
-                    ExpressionEvaluator<L>::eval(acc, exp.derived().lhs);
-                    ADD_RR(acc->shadowValue, acc->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = acc->originalValue + rr->originalValue;
-#endif
+                    if constexpr (Operand<L>::isDouble)
+                        ADD_RD(acc, r.hp(), l.d);
+                    else if constexpr (Operand<R>::isDouble)
+                        ADD_RD(acc, l.hp(), r.d);
+                    else
+                        ADD_RR(acc, l.hp(), r.hp());
+                    single = l.single && r.single;
+                    original = NARROW(l.original + r.original, single);
                 }
-                else
+                else if constexpr (opCode == Operator::SUB)
                 {
-                    sval_ptr tmp = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                    ADD_RR(acc->shadowValue, tmp->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = tmp->originalValue + rr->originalValue;
-#endif
-                    ShadowPool::INSTANCE.put(tmp);
+                    if constexpr (Operand<L>::isDouble)
+                        SUB_DR(acc, l.d, r.hp());
+                    else if constexpr (Operand<R>::isDouble)
+                        SUB_RD(acc, l.hp(), r.d);
+                    else
+                        SUB_RR(acc, l.hp(), r.hp());
+                    single = l.single && r.single;
+                    original = NARROW(l.original - r.original, single);
                 }
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::ADD && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<R>::isRealBase == false, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                ExpressionEvaluator<L>::eval(acc, exp.derived().lhs);
-                const double &r = exp.derived().rhs;
-                ADD_RD(acc->shadowValue, acc->shadowValue, r);
-#if KEEP_ORIGINAL
-                acc->originalValue = acc->originalValue + r;
-#endif
-            }
-
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::ADD && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const sval_ptr ll = l.derived().shadow;
-                if (real_likely(ll != acc))
+                else if constexpr (opCode == Operator::MUL)
                 {
-                    ExpressionEvaluator<R>::eval(acc, exp.derived().rhs);
-                    ADD_RR(acc->shadowValue, ll->shadowValue, acc->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = ll->originalValue + acc->originalValue;
-#endif
+                    if constexpr (Operand<L>::isDouble)
+                        MUL_RD(acc, r.hp(), l.d);
+                    else if constexpr (Operand<R>::isDouble)
+                        MUL_RD(acc, l.hp(), r.d);
+                    else
+                        MUL_RR(acc, l.hp(), r.hp());
+                    single = l.single && r.single;
+                    original = NARROW(l.original * r.original, single);
                 }
                 else
                 {
-                    sval_ptr tmp = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                    ADD_RR(acc->shadowValue, ll->shadowValue, tmp->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = ll->originalValue + tmp->originalValue;
-#endif
-                    ShadowPool::INSTANCE.put(tmp);
+                    if constexpr (Operand<L>::isDouble)
+                        DIV_DR(acc, l.d, r.hp());
+                    else if constexpr (Operand<R>::isDouble)
+                        DIV_RD(acc, l.hp(), r.d);
+                    else
+                        DIV_RR(acc, l.hp(), r.hp());
+                    single = l.single && r.single;
+                    original = NARROW(l.original / r.original, single);
                 }
             }
+        };
 
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::ADD && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                sval_ptr tmp1 = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                sval_ptr tmp2 = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                ADD_RR(acc->shadowValue, tmp1->shadowValue, tmp2->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = tmp1->originalValue + tmp2->originalValue;
-#endif
-                ShadowPool::INSTANCE.put(tmp2);
-                ShadowPool::INSTANCE.put(tmp1);
-            }
-
-            /**
-             * For multiplication, there are six cases 
-             */
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::MUL && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                const real::sval_ptr rr = r.derived().shadow;
-                MUL_RR(acc->shadowValue, ll->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = ll->originalValue * rr->originalValue;
-#endif
-            }
-
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::MUL && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<R>::isRealBase == false, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const double &r = exp.derived().rhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                MUL_RD(acc->shadowValue, ll->shadowValue, r);
-#if KEEP_ORIGINAL
-                acc->originalValue = ll->originalValue * r;
-#endif
-            }
-
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::MUL && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const RealBase<Real> &r = exp.derived().rhs;
-                const sval_ptr rr = r.derived().shadow;
-                if (real_likely(rr != acc))
+        template <Operator opCode, typename L, typename M, typename R>
+        struct ExpressionEvaluator<TernaryOperator<opCode, L, M, R>>
+        {
+            INLINE_FLAGS static void eval(HP_TYPE &acc, double &original, bool &single, const TernaryOperator<opCode, L, M, R> &e)
+            {
+                const Operand<L> l(e.lhs);
+                const Operand<M> m(e.mhs);
+                const Operand<R> r(e.rhs);
+                const Promoted<Operand<L>> pl(l);
+                const Promoted<Operand<M>> pm(m);
+                const Promoted<Operand<R>> pr(r);
+                PROFILE_OP();
+                // the original program does not fuse, the product has the width of l and m
+                const bool product = l.single && m.single;
+                single = product && r.single;
+                if constexpr (opCode == Operator::FMA)
                 {
-                    ExpressionEvaluator<L>::eval(acc, exp.derived().lhs);
-                    MUL_RR(acc->shadowValue, acc->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = acc->originalValue * rr->originalValue;
-#endif
+                    FMA(acc, pl.hp(), pm.hp(), pr.hp());
+                    original = NARROW(NARROW(l.original * m.original, product) + r.original, single);
                 }
-                else
+                else if constexpr (opCode == Operator::FMS)
                 {
-                    sval_ptr tmp = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                    MUL_RR(acc->shadowValue, tmp->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = tmp->originalValue * rr->originalValue;
-#endif
-                    ShadowPool::INSTANCE.put(tmp);
-                }
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::MUL && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<R>::isRealBase == false, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                ExpressionEvaluator<L>::eval(acc, exp.derived().lhs);
-                const double &r = exp.derived().rhs;
-                MUL_RD(acc->shadowValue, acc->shadowValue, r);
-#if KEEP_ORIGINAL
-                acc->originalValue = acc->originalValue * r;
-#endif
-            }
-
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::MUL && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const sval_ptr ll = l.derived().shadow;
-                if (real_likely(ll != acc))
-                {
-                    ExpressionEvaluator<R>::eval(acc, exp.derived().rhs);
-                    MUL_RR(acc->shadowValue, ll->shadowValue, acc->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = ll->originalValue * acc->originalValue;
-#endif
+                    FMS(acc, pl.hp(), pm.hp(), pr.hp());
+                    original = NARROW(NARROW(l.original * m.original, product) - r.original, single);
                 }
                 else
                 {
-                    sval_ptr tmp = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                    MUL_RR(acc->shadowValue, ll->shadowValue, tmp->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = ll->originalValue * tmp->originalValue;
-#endif
-                    ShadowPool::INSTANCE.put(tmp);
+                    FNMA(acc, pl.hp(), pm.hp(), pr.hp());
+                    original = NARROW(r.original - NARROW(l.original * m.original, product), single);
                 }
             }
+        };
 
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::MUL && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+        template <typename T>
+        struct ExpressionEvaluator<UnaryOperator<Operator::NEG, T>>
+        {
+            INLINE_FLAGS static void eval(HP_TYPE &acc, double &original, bool &single, const UnaryOperator<Operator::NEG, T> &e)
             {
-                sval_ptr tmp1 = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                sval_ptr tmp2 = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                MUL_RR(acc->shadowValue, tmp1->shadowValue, tmp2->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = tmp1->originalValue * tmp2->originalValue;
-#endif
-                ShadowPool::INSTANCE.put(tmp2);
-                ShadowPool::INSTANCE.put(tmp1);
+                const Operand<T> v(e.operand);
+                PROFILE_OP();
+                SUB_DR(acc, 0, v.hp());
+                single = v.single;
+                original = -v.original;
             }
+        };
 
-            /**
-             * For substraction, there are eight cases 
-             */
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::SUB && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                const real::sval_ptr rr = r.derived().shadow;
-                SUB_RR(acc->shadowValue, ll->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = ll->originalValue - rr->originalValue;
-#endif
-            }
+        template <>
+        struct ExpressionEvaluator<Real>
+        {
+            INLINE_FLAGS static void eval(HP_TYPE &acc, double &original, bool &single, const Real &e);
+        };
 
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::SUB && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<R>::isRealBase == false, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const double &r = exp.derived().rhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                SUB_RD(acc->shadowValue, ll->shadowValue, r);
+        // evaluates a tree into a shadow state, as the eager assignment of a temporary does
+        template <typename E>
+        INLINE_FLAGS void evaluate(ShadowState &target, const E &e)
+        {
+            double original;
+            bool single;
+            ExpressionEvaluator<E>::eval(target.shadowValue, original, single, e);
 #if KEEP_ORIGINAL
-                acc->originalValue = ll->originalValue - r;
+            target.originalValue = NARROW(original, target.single); // a store keeps the width of the target
 #endif
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::SUB && trails<L>::isRealBase == false && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const double &l = exp.derived().lhs;
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr rr = r.derived().shadow;
-                SUB_DR(acc->shadowValue, l, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = l - rr->originalValue;
+#if TRACK_ERROR && ACTIVE_TRACK_ERROR
+            real::Real::UpdError(target, target.originalValue);
 #endif
-            }
+        }
 
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::SUB && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const RealBase<Real> &r = exp.derived().rhs;
-                const sval_ptr rr = r.derived().shadow;
-                if (real_likely(rr != acc))
-                {
-                    ExpressionEvaluator<L>::eval(acc, exp.derived().lhs);
-                    SUB_RR(acc->shadowValue, acc->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = acc->originalValue - rr->originalValue;
-#endif
-                }
-                else
-                {
-                    sval_ptr tmp = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                    SUB_RR(acc->shadowValue, tmp->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = tmp->originalValue - rr->originalValue;
-#endif
-                    ShadowPool::INSTANCE.put(tmp);
-                }
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::SUB && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<R>::isRealBase == false, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                ExpressionEvaluator<L>::eval(acc, exp.derived().lhs);
-                const double &r = exp.derived().rhs;
-                SUB_RD(acc->shadowValue, acc->shadowValue, r);
-#if KEEP_ORIGINAL
-                acc->originalValue = acc->originalValue - r;
-#endif
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::SUB && trails<L>::isRealBase == false && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const double &l = exp.derived().lhs;
-                ExpressionEvaluator<R>::eval(acc, exp.derived().rhs);
-                SUB_DR(acc->shadowValue, l, acc->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = l - acc->originalValue;
-#endif
-            }
+        enum RealType
+        {
+            formal,
+            actual
+        };
 
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::SUB && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+        struct Real : public RealBase<Real>
+        {
+            real::sval_ptr shadow;
+            RealType formal;
+
+            Real() : formal(RealType::actual)
             {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const sval_ptr ll = l.derived().shadow;
-                if (real_likely(ll != acc))
-                {
-                    ExpressionEvaluator<R>::eval(acc, exp.derived().rhs);
-                    SUB_RR(acc->shadowValue, ll->shadowValue, acc->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = ll->originalValue - acc->originalValue;
-#endif
-                }
-                else
-                {
-                    sval_ptr tmp = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                    SUB_RR(acc->shadowValue, ll->shadowValue, tmp->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = ll->originalValue - tmp->originalValue;
-#endif
-                    ShadowPool::INSTANCE.put(tmp);
-                }
+                shadow = ShadowPool::INSTANCE.get();
+                SET_SINGLE(*shadow, false);
             }
-
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::SUB && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            Real(double v) : formal(RealType::actual)
             {
-                sval_ptr tmp1 = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                sval_ptr tmp2 = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                SUB_RR(acc->shadowValue, tmp1->shadowValue, tmp2->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = tmp1->originalValue - tmp2->originalValue;
-#endif
-                ShadowPool::INSTANCE.put(tmp2);
-                ShadowPool::INSTANCE.put(tmp1);
+                shadow = ShadowPool::INSTANCE.get();
+                SET_SINGLE(*shadow, false);
+                *this = v;
             }
-
-            /**
-             * For division, there are eight cases 
-             */
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::DIV && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            Real(const Real &r) : formal(RealType::actual)
             {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                const real::sval_ptr rr = r.derived().shadow;
-                DIV_RR(acc->shadowValue, ll->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = ll->originalValue / rr->originalValue;
-#endif
+                shadow = ShadowPool::INSTANCE.get();
+                SET_SINGLE(*shadow, r.shadow->single);
+                *this = r;
             }
-
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::DIV && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<R>::isRealBase == false, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            Real(Real &&r) noexcept : formal(r.formal)
             {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const double &r = exp.derived().rhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                DIV_RD(acc->shadowValue, ll->shadowValue, r);
-#if KEEP_ORIGINAL
-                acc->originalValue = ll->originalValue / r;
-#endif
+                shadow = r.shadow;
+                r.formal = RealType::formal;
             }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::DIV && trails<L>::isRealBase == false && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            // a view of an eager shadow
+            explicit Real(const real::Real &r) : formal(RealType::formal)
             {
-                const double &l = exp.derived().lhs;
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr rr = r.derived().shadow;
-                DIV_DR(acc->shadowValue, l, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = l / rr->originalValue;
-#endif
+                shadow = r.shadow;
             }
-
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::DIV && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            ~Real()
             {
-                const RealBase<Real> &r = exp.derived().rhs;
-                const sval_ptr rr = r.derived().shadow;
-                if (real_likely(rr != acc))
+                if (formal == RealType::actual && shadow != nullptr)
                 {
-                    ExpressionEvaluator<L>::eval(acc, exp.derived().lhs);
-                    DIV_RR(acc->shadowValue, acc->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = acc->originalValue / rr->originalValue;
-#endif
-                }
-                else
-                {
-                    sval_ptr tmp = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                    DIV_RR(acc->shadowValue, tmp->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = tmp->originalValue / rr->originalValue;
-#endif
-                    ShadowPool::INSTANCE.put(tmp);
+                    ShadowPool::INSTANCE.put(shadow);
+                    shadow = nullptr;
                 }
             }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::DIV && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<R>::isRealBase == false, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                ExpressionEvaluator<L>::eval(acc, exp.derived().lhs);
-                const double &r = exp.derived().rhs;
-                DIV_RD(acc->shadowValue, acc->shadowValue, r);
-#if KEEP_ORIGINAL
-                acc->originalValue = acc->originalValue / r;
-#endif
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::DIV && trails<L>::isRealBase == false && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+
+            template <typename Derived>
+            INLINE_FLAGS Real &operator=(const RealBase<Derived> &r)
             {
-                const double &l = exp.derived().lhs;
-                ExpressionEvaluator<R>::eval(acc, exp.derived().rhs);
-                DIV_DR(acc->shadowValue, l, acc->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = l / acc->originalValue;
-#endif
+                evaluate(*shadow, r.derived());
+                return *this;
             }
 
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::DIV && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            INLINE_FLAGS Real &operator=(const Real &r)
             {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const sval_ptr ll = l.derived().shadow;
-                if (ll != acc)
-                {
-                    ExpressionEvaluator<R>::eval(acc, exp.derived().rhs);
-                    DIV_RR(acc->shadowValue, ll->shadowValue, acc->shadowValue);
-#if KEEP_ORIGINAL
-                    acc->originalValue = ll->originalValue / acc->originalValue;
+#if TRACK_ERROR
+                ERROR_STATE.updateSymbolicVarError(r.shadow->error);
 #endif
-                }
-                else
-                {
-                    sval_ptr tmp = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                    DIV_RR(acc->shadowValue, ll->shadowValue, tmp->shadowValue);
+                ASSIGN(shadow->shadowValue, r.shadow->shadowValue);
 #if KEEP_ORIGINAL
-                    acc->originalValue = ll->originalValue / tmp->originalValue;
+                shadow->originalValue = r.shadow->originalValue;
 #endif
-                    ShadowPool::INSTANCE.put(tmp);
-                }
-            }
-
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<BinaryOperator<opCode, L, R>>>::value && opCode == Operator::DIV && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP, void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                sval_ptr tmp1 = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                sval_ptr tmp2 = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                DIV_RR(acc->shadowValue, tmp1->shadowValue, tmp2->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = tmp1->originalValue / tmp2->originalValue;
+                NARROW_R(*shadow, *shadow);
+#if TRACK_ERROR && ACTIVE_TRACK_ERROR
+                real::Real::UpdError(*shadow, shadow->originalValue);
 #endif
-                ShadowPool::INSTANCE.put(tmp2);
-                ShadowPool::INSTANCE.put(tmp1);
-            }
-        };
-
-        template <Operator opCode, typename L, typename M, typename R>
-        struct ExpressionEvaluator<RealBase<TernaryOperator<opCode, L, M, R>>>
-        {
-            INLINE_FLAGS static const real::sval_ptr eval(const RealBase<TernaryOperator<opCode, L, M, R>> &r)
-            {
-                sval_ptr tmp = ShadowPool::INSTANCE.get();
-                ExpressionEvaluator<RealBase<TernaryOperator<opCode, L, M, R>>>::eval(tmp, r);
-                return tmp;
+                return *this;
             }
 
-            /**
-             * For FMA, there are eight cases 
-             */
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMA && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<M>::isRealBase && trails<M>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            INLINE_FLAGS Real &operator=(const double r)
             {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const RealBase<Real> &m = exp.derived().mhs;
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                const real::sval_ptr mm = m.derived().shadow;
-                const real::sval_ptr rr = r.derived().shadow;
-                FMA(acc->shadowValue, ll->shadowValue, mm->shadowValue, rr->shadowValue);
+                ASSIGN_D(shadow->shadowValue, r);
 #if KEEP_ORIGINAL
-                acc->originalValue = fma(ll->originalValue, mm->originalValue, rr->originalValue);
+                shadow->originalValue = r;
 #endif
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMA && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<M>::isRealBase && trails<M>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const sval_ptr tmpL = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                const RealBase<Real> &m = exp.derived().mhs;
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr mm = m.derived().shadow;
-                const real::sval_ptr rr = r.derived().shadow;
-                FMA(acc->shadowValue, tmpL->shadowValue, mm->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(tmpL->originalValue, mm->originalValue, rr->originalValue);
+                NARROW_R(*shadow, *shadow);
+#if TRACK_ERROR
+                ERROR_STATE.setError(shadow->error, 0);
 #endif
-                ShadowPool::INSTANCE.put(tmpL);
+                return *this;
             }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMA && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<M>::isRealBase && trails<M>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const sval_ptr tmpM = ExpressionEvaluator<M>::eval(exp.derived().mhs);
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                const real::sval_ptr rr = r.derived().shadow;
 
-                FMA(acc->shadowValue, ll->shadowValue, tmpM->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(ll->originalValue, tmpM->originalValue, rr->originalValue);
-#endif
-                ShadowPool::INSTANCE.put(tmpM);
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMA && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<M>::isRealBase && trails<M>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            template <typename T>
+            INLINE_FLAGS Real &operator+=(const T &r)
             {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const RealBase<Real> &m = exp.derived().mhs;
-                const sval_ptr tmpR = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                const real::sval_ptr ll = l.derived().shadow;
-                const real::sval_ptr mm = m.derived().shadow;
-                FMA(acc->shadowValue, ll->shadowValue, mm->shadowValue, tmpR->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(ll->originalValue, mm->originalValue, tmpR->originalValue);
-#endif
-                ShadowPool::INSTANCE.put(tmpR);
+                return *this = *this + r;
             }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMA && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<M>::isRealBase && trails<M>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            template <typename T>
+            INLINE_FLAGS Real &operator-=(const T &r)
             {
-                const sval_ptr tmpL = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                const sval_ptr tmpM = ExpressionEvaluator<M>::eval(exp.derived().mhs);
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr rr = r.derived().shadow;
-                FMA(acc->shadowValue, tmpL->shadowValue, tmpM->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(tmpL->originalValue, tmpM->originalValue, rr->originalValue);
-#endif
-                ShadowPool::INSTANCE.put(tmpM);
-                ShadowPool::INSTANCE.put(tmpL);
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMA && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<M>::isRealBase && trails<M>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const sval_ptr tmpL = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                const RealBase<Real> &m = exp.derived().mhs;
-                const sval_ptr tmpR = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                const real::sval_ptr mm = m.derived().shadow;
-                FMA(acc->shadowValue, tmpL->shadowValue, mm->shadowValue, tmpR->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(tmpL->originalValue, mm->originalValue, tmpR->originalValue);
-#endif
-                ShadowPool::INSTANCE.put(tmpR);
-                ShadowPool::INSTANCE.put(tmpL);
+                return *this = *this - r;
             }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMA && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<M>::isRealBase && trails<M>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            template <typename T>
+            INLINE_FLAGS Real &operator*=(const T &r)
             {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const sval_ptr tmpM = ExpressionEvaluator<M>::eval(exp.derived().mhs);
-                const sval_ptr tmpR = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                const real::sval_ptr ll = l.derived().shadow;
-                FMA(acc->shadowValue, ll->shadowValue, tmpM->shadowValue, tmpR->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(ll->originalValue, tmpM->originalValue, tmpR->originalValue);
-#endif
-                ShadowPool::INSTANCE.put(tmpR);
-                ShadowPool::INSTANCE.put(tmpM);
+                return *this = *this * r;
             }
-
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMA && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<M>::isRealBase && trails<M>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            template <typename T>
+            INLINE_FLAGS Real &operator/=(const T &r)
             {
-                const sval_ptr tmpL = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                const sval_ptr tmpM = ExpressionEvaluator<M>::eval(exp.derived().mhs);
-                const sval_ptr tmpR = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                FMA(acc->shadowValue, tmpL->shadowValue, tmpM->shadowValue, tmpR->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(tmpL->originalValue, tmpM->originalValue, tmpR->originalValue);
-#endif
-                ShadowPool::INSTANCE.put(tmpR);
-                ShadowPool::INSTANCE.put(tmpM);
-                ShadowPool::INSTANCE.put(tmpL);
+                return *this = *this / r;
             }
 
-            /**
-             * For FMS, there are eight cases 
-             */
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMS && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<M>::isRealBase && trails<M>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+        private:
+            void makeFormal()
             {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const RealBase<Real> &m = exp.derived().mhs;
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                const real::sval_ptr mm = m.derived().shadow;
-                const real::sval_ptr rr = r.derived().shadow;
-                FMS(acc->shadowValue, ll->shadowValue, mm->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(ll->originalValue, mm->originalValue, -rr->originalValue);
-#endif
+                if (formal != RealType::formal)
+                {
+                    formal = RealType::formal;
+                    ShadowPool::INSTANCE.put(shadow);
+                    shadow = nullptr;
+                }
             }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMS && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<M>::isRealBase && trails<M>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const sval_ptr tmpL = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                const RealBase<Real> &m = exp.derived().mhs;
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr mm = m.derived().shadow;
-                const real::sval_ptr rr = r.derived().shadow;
-                FMS(acc->shadowValue, tmpL->shadowValue, mm->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(tmpL->originalValue, mm->originalValue, -rr->originalValue);
-#endif
+            template <int, int>
+            friend struct InitLoop;
 
-                ShadowPool::INSTANCE.put(tmpL);
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMS && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<M>::isRealBase && trails<M>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
+            friend std::ostream &operator<<(std::ostream &os, const Real &c)
             {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const sval_ptr tmpM = ExpressionEvaluator<M>::eval(exp.derived().mhs);
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                const real::sval_ptr rr = r.derived().shadow;
-                FMS(acc->shadowValue, ll->shadowValue, tmpM->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(ll->originalValue, tmpM->originalValue, -rr->originalValue);
-#endif
-
-                ShadowPool::INSTANCE.put(tmpM);
+                STREAM_OUT(os, c);
+                return os;
             }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMS && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<M>::isRealBase && trails<M>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const RealBase<Real> &m = exp.derived().mhs;
-                const real::sval_ptr ll = l.derived().shadow;
-                const real::sval_ptr mm = m.derived().shadow;
-                const sval_ptr tmpR = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                FMS(acc->shadowValue, ll->shadowValue, mm->shadowValue, tmpR->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(ll->originalValue, mm->originalValue, -tmpR->originalValue);
-#endif
+        };
 
-                ShadowPool::INSTANCE.put(tmpR);
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMS && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<M>::isRealBase && trails<M>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode == Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const sval_ptr tmpL = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                const sval_ptr tmpM = ExpressionEvaluator<M>::eval(exp.derived().mhs);
-                const RealBase<Real> &r = exp.derived().rhs;
-                const real::sval_ptr rr = r.derived().shadow;
-                FMS(acc->shadowValue, tmpL->shadowValue, tmpM->shadowValue, rr->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(tmpL->originalValue, tmpM->originalValue, -rr->originalValue);
+        INLINE_FLAGS Operand<Real, true>::Operand(const Real &r) : state(r.shadow)
+        {
+#if TRACK_ERROR
+            ERROR_STATE.updateSymbolicVarError(state->error);
 #endif
-                ShadowPool::INSTANCE.put(tmpM);
-                ShadowPool::INSTANCE.put(tmpL);
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMS && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<M>::isRealBase && trails<M>::opCode == Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const sval_ptr tmpL = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                const RealBase<Real> &m = exp.derived().mhs;
-                const sval_ptr tmpR = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                const real::sval_ptr mm = m.derived().shadow;
-                FMS(acc->shadowValue, tmpL->shadowValue, mm->shadowValue, tmpR->shadowValue);
 #if KEEP_ORIGINAL
-                acc->originalValue = fma(tmpL->originalValue, mm->originalValue, -tmpR->originalValue);
+            original = state->originalValue;
 #endif
-                ShadowPool::INSTANCE.put(tmpR);
-                ShadowPool::INSTANCE.put(tmpL);
-            }
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMS && trails<L>::isRealBase && trails<L>::opCode == Operator::NOP && trails<M>::isRealBase && trails<M>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const RealBase<Real> &l = exp.derived().lhs;
-                const sval_ptr tmpM = ExpressionEvaluator<M>::eval(exp.derived().mhs);
-                const sval_ptr tmpR = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                const real::sval_ptr ll = l.derived().shadow;
-                FMS(acc->shadowValue, ll->shadowValue, tmpM->shadowValue, tmpR->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(ll->originalValue, tmpM->originalValue, -tmpR->originalValue);
+#if KEEP_ORIGINAL && ORIGINAL_WIDTHS
+            single = state->single;
 #endif
-                ShadowPool::INSTANCE.put(tmpR);
-                ShadowPool::INSTANCE.put(tmpM);
-            }
+        }
 
-            template <typename EXP>
-            INLINE_FLAGS static std::enable_if_t<
-                std::is_same<EXP, RealBase<TernaryOperator<opCode, L, M, R>>>::value && opCode == Operator::FMS && trails<L>::isRealBase && trails<L>::opCode != Operator::NOP && trails<M>::isRealBase && trails<M>::opCode != Operator::NOP && trails<R>::isRealBase && trails<R>::opCode != Operator::NOP,
-                void>
-            eval(const real::sval_ptr acc, const EXP &exp)
-            {
-                const sval_ptr tmpL = ExpressionEvaluator<L>::eval(exp.derived().lhs);
-                const sval_ptr tmpM = ExpressionEvaluator<M>::eval(exp.derived().mhs);
-                const sval_ptr tmpR = ExpressionEvaluator<R>::eval(exp.derived().rhs);
-                FMS(acc->shadowValue, tmpL->shadowValue, tmpM->shadowValue, tmpR->shadowValue);
-#if KEEP_ORIGINAL
-                acc->originalValue = fma(tmpL->originalValue, tmpM->originalValue, -tmpR->originalValue);
-#endif
-                ShadowPool::INSTANCE.put(tmpR);
-                ShadowPool::INSTANCE.put(tmpM);
-                ShadowPool::INSTANCE.put(tmpL);
-            }
-        };
+        INLINE_FLAGS void ExpressionEvaluator<Real>::eval(HP_TYPE &acc, double &original, bool &single, const Real &e)
+        {
+            const Operand<Real> v(e);
+            ASSIGN(acc, v.hp());
+            original = v.original;
+            single = v.single;
+        }
+
+        INLINE_FLAGS Real view(const real::Real &r)
+        {
+            return Real(r);
+        }
+
+        // eager target = lazy tree
+        template <typename Derived>
+        INLINE_FLAGS real::Real &assign(real::Real &target, const RealBase<Derived> &e)
+        {
+            evaluate(*target.shadow, e.derived());
+            return target;
+        }
 
         template <typename T>
         struct builder_trails
@@ -1208,6 +558,11 @@ namespace real
             INLINE_FLAGS static void run(Real (&arguments)[size]) {}
         };
 
+        /**
+         * Caches an expression tree built by a lambda over place-holders, e.g.,
+         *   static ExpressionSlot slot([](const Real (&a)[3]) { return a[0] * a[1] + a[2]; });
+         *   assign(x, slot(y, z, w));
+         */
         template <typename BuilderType,
                   typename _Fp = decltype(&BuilderType::operator()),
                   int argSize = builder_trails<_Fp>::argSize,
@@ -1222,8 +577,8 @@ namespace real
                 InitLoop<argSize>::run(arguments);
             }
 
-            template <int start = 0, typename... Args>
-            INLINE_FLAGS const T &operator()(const Real &first, const Args &... rest)
+            template <int start = 0, typename First, typename... Args>
+            INLINE_FLAGS const T &operator()(const First &first, const Args &... rest)
             {
                 static_assert(start < argSize);
                 substitute(arguments[start], first);
@@ -1242,6 +597,10 @@ namespace real
             {
                 formal.shadow = actual.shadow;
             }
+            INLINE_FLAGS void substitute(Real &formal, const real::Real &actual)
+            {
+                formal.shadow = actual.shadow;
+            }
         };
     }; // namespace lazy
 };     // namespace real
@@ -6,21 +6,30 @@
 #include <list>
 #include <stack>
 #include <unordered_map>
+#include <map>
+#include <algorithm>
+#include <new>
+#include <string.h>
 #include <sys/time.h>
 #include <iostream>
 #include <assert.h>
 #include "RealConfigure.h"
+#include "SpillStorage.hpp"
 
 #define real_likely(x) __builtin_expect((x), 1)
 #define real_unlikely(x) __builtin_expect((x), 0)
 typedef unsigned long uint64;
+#include "MemStats.hpp"
 
 #define PUSH_HEAD(nh, h) \
     nh->next = h;        \
     h = nh;
 #define POP_HEAD(h) h = h->next;
 
-#define KEY_SHIFT(k) (((uint64)k) >> 3)
+// variables are keyed by address >> 2, floats are 4-byte aligned. The cache index folds in address >> 3,
+// so that 8-byte aligned doubles still spread over all slots.
+#define KEY_SHIFT(k) (((uint64)k) >> 2)
+#define CACHE_INDEX(k) (KEY_SHIFT(k) ^ (((uint64)k) >> 3))
 
 namespace real
 {
@@ -37,7 +46,7 @@ namespace real
         };
 
         template <typename V, int batchSize = 128, typename _Alloc = SlotValueInitializer<V>>
-        class ValuePool
+        class ValuePool : public PoolAccount
         {
         public:
             typedef V *value_ptr;
@@ -56,6 +65,8 @@ namespace real
             Slot *usedHead;
             Slot *memoryHead;
 
+            static const uint64 BATCH_BYTES = batchSize * sizeof(V) + (batchSize + 1) * sizeof(Slot);
+
             void expand()
             {
                 value_ptr m = new V[batchSize];
@@ -71,6 +82,21 @@ namespace real
                     Slot *fh = new Slot(&m[i]);
                     PUSH_HEAD(fh, availableHead)
                 }
+                MEMSTATS_ALLOC(MEM_POOL, BATCH_BYTES);
+            }
+
+            void release(Slot *batch)
+            {
+                if (std::is_same<decltype(initializer), SlotValueInitializer<V>>::value == false)
+                {
+                    for (int i = 0; i < batchSize; i++)
+                    {
+                        initializer.destruct((batch->value)[i]);
+                    }
+                }
+                delete[] batch->value;
+                delete batch;
+                MEMSTATS_FREE(MEM_POOL, BATCH_BYTES);
             }
 
         public:
@@ -93,6 +119,7 @@ namespace real
                 if (real_unlikely(usedHead == nullptr))
                 {
                     slot = new Slot(pt);
+                    MEMSTATS_ALLOC(MEM_POOL, sizeof(Slot));
                 }
                 else
                 {
@@ -102,12 +129,102 @@ namespace real
                 }
                 PUSH_HEAD(slot, availableHead)
             }
+
+            std::string poolName() const override
+            {
+                return typeName(typeid(V));
+            }
+
+            uint64 poolCapacity() const override
+            {
+                uint64 n = 0;
+                for (Slot *b = memoryHead; b != nullptr; b = b->next)
+                    n += batchSize;
+                return n;
+            }
+
+            uint64 poolFree() const override
+            {
+                uint64 n = 0;
+                for (Slot *s = availableHead; s != nullptr; s = s->next)
+                    n++;
+                return n;
+            }
+
+            // releases the batches whose values are all free while more than keep values stay free,
+            // and the spare slots of put, returns the bytes released
+            uint64 trim(uint64 keep) override
+            {
+                std::vector<std::pair<value_ptr, uint64>> batches; // start, free values
+                for (Slot *b = memoryHead; b != nullptr; b = b->next)
+                    batches.push_back({b->value, 0});
+                std::sort(batches.begin(), batches.end());
+                auto batchOf = [&batches](value_ptr v) -> std::pair<value_ptr, uint64> * {
+                    auto it = std::upper_bound(batches.begin(), batches.end(), std::make_pair(v, ~0UL));
+                    if (it == batches.begin() || v >= (it - 1)->first + batchSize)
+                        return nullptr; // not from this pool
+                    return &*(it - 1);
+                };
+                uint64 available = 0;
+                for (Slot *s = availableHead; s != nullptr; s = s->next, available++)
+                {
+                    auto *b = batchOf(s->value);
+                    if (b != nullptr)
+                        b->second++;
+                }
+                for (auto &b : batches)
+                {
+                    if (b.second == batchSize && available >= keep + batchSize)
+                        available -= batchSize;
+                    else
+                        b.second = 0; // kept
+                }
+
+                uint64 bytes = 0;
+                for (Slot **s = &availableHead; *s != nullptr;)
+                {
+                    auto *b = batchOf((*s)->value);
+                    if (b != nullptr && b->second == batchSize)
+                    {
+                        Slot *n = *s;
+                        *s = n->next;
+                        delete n;
+                    }
+                    else
+                        s = &(*s)->next;
+                }
+                for (Slot **s = &memoryHead; *s != nullptr;)
+                {
+                    auto *b = batchOf((*s)->value);
+                    if (b != nullptr && b->second == batchSize)
+                    {
+                        Slot *n = *s;
+                        *s = n->next;
+                        release(n);
+                        bytes += BATCH_BYTES;
+                    }
+                    else
+                        s = &(*s)->next;
+                }
+                while (usedHead != nullptr)
+                {
+                    Slot *n = usedHead;
+                    POP_HEAD(usedHead)
+                    delete n;
+                    bytes += sizeof(Slot);
+                    MEMSTATS_FREE(MEM_POOL, sizeof(Slot));
+                }
+                return bytes;
+            }
+
             ValuePool() : availableHead(nullptr), usedHead(nullptr), memoryHead(nullptr)
             {
+                MemStats::INSTANCE.registerPool(this);
                 expand();
             }
             ~ValuePool()
             {
+                MemStats::INSTANCE.unregisterPool(this);
                 while (availableHead != nullptr)
                 {
                     Slot *n = availableHead;
@@ -124,15 +241,7 @@ namespace real
                 {
                     Slot *n = memoryHead;
                     POP_HEAD(memoryHead)
-                    if (std::is_same<decltype(initializer), SlotValueInitializer<V>>::value == false)
-                    {
-                        for (int i = 0; i < batchSize; i++)
-                        {
-                            initializer.destruct((n->value)[i]);
-                        }
-                    }
-                    delete[] n->value;
-                    delete n;
+                    release(n);
                 }
             }
         };
@@ -142,6 +251,18 @@ namespace real
         template <typename RealType>
         using RealPool = util::ValuePool<RealType>;
 
+        // element of a shadow range, specialized for shadow types that keep their state out of line
+        template <typename RealType>
+        struct RangeCell
+        {
+            RealType value;
+
+            template <typename VT>
+            inline void init(VT &original) { new (&value) RealType(original); }
+            inline void destroy() { value.~RealType(); }
+            inline void relocate() {}
+        };
+
         static int missedCount = 0;
         static int arrayMissed = 0;
 
@@ -158,7 +279,10 @@ namespace real
             static VariableMap<Key, RealType, cacheSize, mask> INSTANCE;
 
         private:
-            std::unordered_map<uint64, __value_type> map;
+            template <typename V, int kind>
+            using HashMap = std::unordered_map<uint64, V, std::hash<uint64>, std::equal_to<uint64>, TrackedAllocator<std::pair<const uint64, V>, kind>>;
+
+            HashMap<__value_type, MEM_VARIABLES> map;
 
             struct RealCache
             {
@@ -188,9 +312,15 @@ namespace real
                 ArraySlot(Key address, uint size) : address(address), length(size)
                 {
                     array_ptr = new __value_ptr[size];
+                    MEMSTATS_ALLOC(MEM_ARRAYS, size * sizeof(__value_ptr));
                 }
                 ArraySlot &operator=(ArraySlot &&r)
                 {
+                    if(array_ptr)
+                    {
+                        delete[] array_ptr;
+                        MEMSTATS_FREE(MEM_ARRAYS, length * sizeof(__value_ptr));
+                    }
                     address = r.address;
                     length = r.length;
                     array_ptr = r.array_ptr;
@@ -200,7 +330,10 @@ namespace real
                 ~ArraySlot()
                 {
                     if(array_ptr)
+                    {
                         delete[] array_ptr;
+                        MEMSTATS_FREE(MEM_ARRAYS, length * sizeof(__value_ptr));
+                    }
                     array_ptr = nullptr;
                 }
 
@@ -217,8 +350,176 @@ namespace real
                 ArraySlotCache() : address(nullptr), slot(nullptr) {}
             };
 
-            std::unordered_map<uint64, ArraySlot> arrayMap;
+            HashMap<ArraySlot, MEM_ARRAYS> arrayMap;
             ArraySlotCache arrayCache[cacheSize];
+
+            // heap arrays are shadowed by one contiguous block per allocation,
+            // elements are constructed from the original on first access
+            struct RangeSlot
+            {
+                using Cell = RangeCell<RealType>;
+                char *start;
+                uint64 length;
+                uint elemSize;
+                Cell *block;
+                uint64 *inited; // one bit per element
+                SpillRegion *spill; // non-null when the block lives in a spill file
+
+                RangeSlot() : start(nullptr), length(0), elemSize(0), block(nullptr), inited(nullptr), spill(nullptr) {}
+                RangeSlot(char *s, uint64 len, uint es) : start(s), length(len), elemSize(es)
+                {
+                    // pages of the block are only touched when the elements are used
+                    block = (Cell *)RangeStorage::allocate(len * sizeof(Cell), spill);
+                    inited = (uint64 *)calloc((len >> 6) + 1, sizeof(uint64));
+                    MEMSTATS_ALLOC(MEM_RANGES, bytes(len));
+                }
+
+                static inline uint64 bytes(uint64 len)
+                {
+                    return len * sizeof(Cell) + ((len >> 6) + 1) * sizeof(uint64);
+                }
+
+                inline bool contains(const void *address) const
+                {
+                    return (const char *)address >= start && (const char *)address < start + length * elemSize;
+                }
+
+                template<typename VT>
+                inline RealType &at(VT *address)
+                {
+                    uint64 id = ((char *)address - start) / elemSize;
+                    if (real_unlikely(spill != nullptr))
+                        spill->touch(id * sizeof(Cell));
+                    if (real_unlikely(((inited[id >> 6] >> (id & 63)) & 1) == 0))
+                    {
+                        block[id].init(*address);
+                        inited[id >> 6] |= 1UL << (id & 63);
+                    }
+                    return block[id].value;
+                }
+
+                template<typename F>
+                void forEachInited(uint64 from, F f)
+                {
+                    for (uint64 w = from >> 6, words = (length >> 6) + 1; w < words; w++)
+                    {
+                        uint64 bits = inited[w];
+                        if (w == (from >> 6))
+                            bits &= ~0UL << (from & 63);
+                        while (bits)
+                        {
+                            f((w << 6) + __builtin_ctzl(bits));
+                            bits &= bits - 1;
+                        }
+                    }
+                }
+
+                void destroy(uint64 from)
+                {
+                    forEachInited(from, [this](uint64 id) { block[id].destroy(); });
+                    for (uint64 w = from >> 6, words = (length >> 6) + 1; w < words; w++)
+                    {
+                        inited[w] &= (w == (from >> 6)) ? ~(~0UL << (from & 63)) : 0;
+                    }
+                }
+
+                void resize(uint64 len)
+                {
+                    if (len < length)
+                        destroy(len);
+                    uint64 oldWords = (length >> 6) + 1, words = (len >> 6) + 1;
+                    block = (Cell *)RangeStorage::reallocate(block, length * sizeof(Cell), len * sizeof(Cell), spill);
+                    inited = (uint64 *)realloc(inited, words * sizeof(uint64));
+                    if (words > oldWords)
+                        memset(inited + oldWords, 0, (words - oldWords) * sizeof(uint64));
+                    MEMSTATS_FREE(MEM_RANGES, bytes(length));
+                    MEMSTATS_ALLOC(MEM_RANGES, bytes(len));
+                    length = len;
+                    forEachInited(0, [this](uint64 id) { block[id].relocate(); });
+                }
+
+                void release()
+                {
+                    destroy(0);
+                    RangeStorage::release(block, spill);
+                    free(inited);
+                    MEMSTATS_FREE(MEM_RANGES, bytes(length));
+                    block = nullptr;
+                    inited = nullptr;
+                }
+            };
+
+            struct RangeSlotCache
+            {
+                Key address;
+                RangeSlot *slot;
+                RangeSlotCache() : address(nullptr), slot(nullptr) {}
+            };
+
+            std::map<uint64, RangeSlot, std::less<uint64>, TrackedAllocator<std::pair<const uint64, RangeSlot>, MEM_RANGES>> rangeMap; // keyed by the start address
+            RangeSlotCache rangeCache[cacheSize];
+
+            // ranges over each page, hashed: scalars on pages without a range skip the ordered lookup
+            static const int rangePageShift = 12;
+            static const uint64 rangePageMask = (1 << 16) - 1;
+            uint rangePages[rangePageMask + 1] = {};
+
+            void markRange(const RangeSlot &range, int delta)
+            {
+                if (range.length == 0)
+                    return;
+                uint64 first = (uint64)range.start >> rangePageShift;
+                uint64 pages = (((uint64)range.start + range.length * range.elemSize - 1) >> rangePageShift) - first + 1;
+                pages = std::min(pages, rangePageMask + 1);
+                for (uint64 i = 0; i < pages; i++)
+                {
+                    rangePages[(first + i) & rangePageMask] += delta;
+                }
+            }
+
+            RangeSlot *findRange(const void *address)
+            {
+                if (rangePages[((uint64)address >> rangePageShift) & rangePageMask] == 0)
+                    return nullptr;
+                auto it = rangeMap.upper_bound((uint64)address);
+                if (it == rangeMap.begin())
+                    return nullptr;
+                --it;
+                return it->second.contains(address) ? &it->second : nullptr;
+            }
+
+            void invalidateCaches(const RangeSlot &range)
+            {
+                for (int i = 0; i < cacheSize; i++)
+                {
+                    if (range.contains(cache[i].address))
+                    {
+                        cache[i].address = nullptr;
+                        cache[i].real_ptr = nullptr;
+                    }
+                    if (range.contains(rangeCache[i].address))
+                    {
+                        rangeCache[i].address = nullptr;
+                        rangeCache[i].slot = nullptr;
+                    }
+                }
+            }
+
+#if SHADOW_SPILL
+            static void dropSpilled(const char *begin, const char *end)
+            {
+                for (int i = 0; i < cacheSize; i++)
+                {
+                    const char *p = (const char *)INSTANCE.cache[i].real_ptr;
+                    if (p >= begin && p < end)
+                    {
+                        INSTANCE.cache[i].address = nullptr;
+                        INSTANCE.cache[i].real_ptr = nullptr;
+                    }
+                }
+            }
+#endif
+
         public:
             void dumpCache(int rows)
             {
@@ -246,24 +547,36 @@ namespace real
             template<typename VT>
             RealType &getOrInit(VT *address)
             {
-                int index = KEY_SHIFT(address) & mask;
+                int index = CACHE_INDEX(address) & mask;
                 RealCache &c = cache[index];
                 if (c.address != address)
                 {
                     missedCount++;
+                    RangeSlot *range = findRange(address);
+                    if (range != nullptr)
+                    {
+#if SHADOW_SPILL
+                        // hits of the cache do not touch the spilled chunk, its eviction drops them
+                        if (real_unlikely(range->spill != nullptr))
+                            SpillManager::evicted = &dropSpilled;
+#endif
+                        c.address = address;
+                        c.real_ptr = &range->at(address);
+                        return *c.real_ptr;
+                    }
 #if DELEGATE_TO_POOL
                     RealType *&ptr = map[KEY_SHIFT(address)];
                     if(ptr==nullptr)
                     {
                         ptr = RealPool<RealType>::INSTANCE.get();
-                        *ptr = *address; // init
+                        ptr->template setWidth<VT>() = *address; // init
                     }
 #else
                     auto it = map.find(KEY_SHIFT(address));
                     RealType *ptr = nullptr;
                     if(it==map.end())
                     {
-                        ptr = &(map[KEY_SHIFT(address)] = *address); // init
+                        ptr = &(map[KEY_SHIFT(address)].template setWidth<VT>() = *address); // init
                     }
                     else ptr = &it->second;
 #endif
@@ -275,7 +588,7 @@ namespace real
 
             RealType &operator[](Key address)
             {
-                int index = KEY_SHIFT(address) & mask;
+                int index = CACHE_INDEX(address) & mask;
                 RealCache &c = cache[index];
                 if (c.address != address)
                 {
@@ -293,7 +606,9 @@ namespace real
                 }
                 return *c.real_ptr;
             }
-            RealType &def(Key address)
+            // the shadow of a variable of type VT, it keeps the width of VT
+            template<typename VT>
+            RealType &def(VT *address)
             {
                 RealType *ptr = nullptr;
 #if DELEGATE_TO_POOL
@@ -303,7 +618,7 @@ namespace real
 #else
                 ptr = &map[KEY_SHIFT(address)]; // create a real with default constructor
 #endif
-                return *ptr;
+                return ptr->template setWidth<VT>();
             }
 
             template<typename VT>
@@ -320,7 +635,7 @@ namespace real
 
             void undef(Key address)
             {
-                int index = KEY_SHIFT(address) & mask;
+                int index = CACHE_INDEX(address) & mask;
                 RealCache &c = cache[index];
                 if (c.address == address)
                 {
@@ -353,6 +668,54 @@ namespace real
                 arrayMap.erase(it);
             }
 
+            template<typename VT>
+            void defRange(VT *address, uint64 length)
+            {
+                auto it = rangeMap.find((uint64)address);
+                if(it!=rangeMap.end())
+                {
+                    invalidateCaches(it->second);
+                    markRange(it->second, -1);
+                    it->second.release();
+                }
+                RangeSlot &range = rangeMap[(uint64)address] = RangeSlot((char *)address, length, sizeof(VT));
+                markRange(range, 1);
+            }
+
+            template<typename VT>
+            void undefRange(VT *address)
+            {
+                auto it = rangeMap.find((uint64)address);
+                if(it==rangeMap.end())
+                {
+                    return; // not shadowed, e.g. free(NULL)
+                }
+                invalidateCaches(it->second);
+                markRange(it->second, -1);
+                it->second.release();
+                rangeMap.erase(it);
+            }
+
+            // shadows follow the data moved by realloc
+            template<typename VT>
+            void redefRange(VT *oldAddress, VT *address, uint64 length)
+            {
+                auto it = oldAddress == nullptr ? rangeMap.end() : rangeMap.find((uint64)oldAddress);
+                if(it==rangeMap.end())
+                {
+                    defRange(address, length);
+                    return;
+                }
+                RangeSlot range = it->second;
+                invalidateCaches(range);
+                markRange(range, -1);
+                rangeMap.erase(it);
+                range.start = (char *)address;
+                range.resize(length);
+                rangeMap[(uint64)address] = range;
+                markRange(range, 1);
+            }
+
             template<typename VT>
             inline RealType& getFromArray(VT* address, uint id)
             {
@@ -366,7 +729,18 @@ namespace real
                     auto it = arrayMap.find(index);
                     if(it==arrayMap.end())
                     {
-                        return (*this)[&address[id]]; // slow path
+                        RangeSlotCache &rc = rangeCache[cacheIndex];
+                        if(rc.address!=address)
+                        {
+                            RangeSlot *range = findRange(address);
+                            if(range==nullptr)
+                            {
+                                return (*this)[&address[id]]; // slow path
+                            }
+                            rc.address = address;
+                            rc.slot = range;
+                        }
+                        return rc.slot->at(&address[id]);
                     }
                     else
                     {
@@ -3,8 +3,11 @@
 /*
 Low level instructions for instrumentation
 */
+#include <type_traits>
 #include "RealConfigure.h"
 #include "Real.hpp"
+#include "RealLazy.hpp"
+#include "ShadowJit.hpp"
 
 using Addr = void*;
 using SVal = real::Real;
@@ -16,21 +19,28 @@ struct ShadowStackFrame
     SVal **realArgs;
     SVal *realRet;
     ShadowStackFrame* prev;
-    ShadowStackFrame(int maxArg=0)
+    int argCount;
+    ShadowStackFrame(int maxArg=0) : argCount(maxArg)
     {
         if(maxArg==0) realArgs = nullptr;
-        else realArgs = new SVal*[maxArg] {nullptr};
+        else
+        {
+            realArgs = new SVal*[maxArg] {nullptr};
+            MEMSTATS_ALLOC(real::MEM_CALLS, maxArg * sizeof(SVal*));
+        }
         realRet = nullptr;
         prev = nullptr;
     }
     ~ShadowStackFrame()
     {
+        if(realArgs) MEMSTATS_FREE(real::MEM_CALLS, argCount * sizeof(SVal*));
         delete[] realArgs;
     }
 
     inline ShadowStackFrame* pushCall(int maxArg)
     {
         ShadowStackFrame* nf = new ShadowStackFrame(maxArg);
+        MEMSTATS_ALLOC(real::MEM_CALLS, sizeof(ShadowStackFrame));
         nf->prev = this;
         return nf;
     }
@@ -58,6 +68,7 @@ struct ShadowStackFrame
     {
         auto t = this->prev;
         delete this;
+        MEMSTATS_FREE(real::MEM_CALLS, sizeof(ShadowStackFrame));
         return t;
     }
     inline void popRet(int id, SVal& svar, double ovar)
@@ -98,6 +109,11 @@ void ARRDEF(double* arr, uint size)
     VARMAP.defArray(arr, size);
 }
 
+void ARRDEF(float* arr, uint size)
+{
+    VARMAP.defArray(arr, size);
+}
+
 void ARRUNDEF(double* arr, uint size)
 {
     // for(int i=0;i<size;i++)
@@ -107,29 +123,172 @@ void ARRUNDEF(double* arr, uint size)
     VARMAP.undefArray(arr);
 }
 
-std::unordered_map<Addr, uint> dynArrSize;
+void ARRUNDEF(float* arr, uint size)
+{
+    VARMAP.undefArray(arr);
+}
+
+// EMBEDDED SHADOW FIELDS
+// turnFpStruct -embedded-shadow appends one EmbeddedSVal per fp field to the record,
+// so a member access reaches its shadow at a constant offset instead of through VARMAP.
+// The slot remembers the field it was bound to: records that are malloc'ed, memcpy'ed or
+// aggregate-initialized never run a constructor, and their slots are (re)bound from the
+// original value on first use. A record freed without its destructor leaves a bound slot
+// behind, so with KEEP_ORIGINAL a slot whose original no longer matches its field, after a
+// native write or in a reused allocation, is reseeded from the field.
+struct EmbeddedSVal
+{
+    Addr owner;
+    alignas(SVal) char storage[sizeof(SVal)];
+
+    EmbeddedSVal() : owner(nullptr) {}
+
+    // the field of a copy is at the same offset from its slot
+    EmbeddedSVal(const EmbeddedSVal &o) : owner(nullptr)
+    {
+        if(o.owner != nullptr)
+        {
+            new (storage) SVal(o.sval());
+            owner = (char *)o.owner + ((char *)this - (char *)&o);
+        }
+    }
+
+    // a slot that is not bound to the copied field may be garbage of an unconstructed record,
+    // it is overwritten and never destroyed; an unbound source leaves it to the check of get()
+    EmbeddedSVal &operator=(const EmbeddedSVal &o)
+    {
+        if(this == &o || o.owner == nullptr) return *this;
+        Addr field = (char *)o.owner + ((char *)this - (char *)&o);
+        if(owner == field)
+        {
+            sval() = o.sval();
+        }
+        else
+        {
+            new (storage) SVal(o.sval());
+            owner = field;
+        }
+        return *this;
+    }
+
+    template<typename VT>
+    inline SVal &get(VT &field)
+    {
+        if(real_unlikely(owner != (Addr)&field))
+        {
+            new (storage) SVal(field);
+            sval().setWidth<VT>();
+            owner = (Addr)&field;
+        }
+#if KEEP_ORIGINAL
+        else if(real_unlikely((std::is_floating_point<VT>::value) && stale(field)))
+        {
+            sval() = field;
+        }
+#endif
+        return sval();
+    }
+
+    template<typename VT>
+    inline void release(VT &field)
+    {
+        if(owner == (Addr)&field)
+        {
+            sval().~SVal();
+            owner = nullptr;
+        }
+    }
 
-double* DYNDEF(uint size)
+private:
+    inline SVal &sval() { return *(SVal *)storage; }
+    inline const SVal &sval() const { return *(const SVal *)storage; }
+
+#if KEEP_ORIGINAL
+    // two nans are the same original
+    template<typename VT>
+    inline bool stale(VT field) const
+    {
+        double o = sval().shadow->originalValue;
+        return o != field && (o == o || field == field);
+    }
+#endif
+};
+
+#define EMBEDDED_SVAL(f) EmbeddedSVal __SHADOW_##f
+#define EMBEDDED_ARR_SVAL(f, size) EmbeddedSVal __SHADOW_##f[size]
+// the record and the index are evaluated once, they may be calls or have side effects
+#define FIELD_SVAR(obj, f) ([](auto &&__o) -> SVal & { return __o.__SHADOW_##f.get(__o.f); }(obj))
+#define FIELD_ARR_SVAR(obj, f, idx) \
+    ([](auto &&__o, size_t __i) -> SVal & { return __o.__SHADOW_##f[__i].get(__o.f[__i]); }(obj, idx))
+#define FIELD_UNDEF(f) __SHADOW_##f.release(f)
+#define FIELD_ARRUNDEF(f, size) for(uint __i = 0; __i < (size); __i++) __SHADOW_##f[__i].release(f[__i])
+
+// heap arrays: one shadow range per allocation, new[] and malloc sites both end up here
+template<typename T = double>
+T* DYNDEF(size_t size)
 {
-    double *res = new double[size];
-    // dynArrSize[(Addr)KEY_SHIFT(res)] = size;
-    ARRDEF(res, size);
+    T *res = (T *)malloc(size * sizeof(T));
+    VARMAP.defRange(res, size);
     return res;
 }
 
-void DYNUNDEF(double * res)
+template<typename T = double>
+T* DYNREDEF(T *old, size_t size)
 {
-    // uint size = dynArrSize[(Addr)KEY_SHIFT(res)];
-    ARRUNDEF(res, 0);
-    delete res;
+    T *res = (T *)realloc(old, size * sizeof(T));
+    if(res == nullptr)
+    {
+        if(size == 0) VARMAP.undefRange(old); // realloc(p, 0) freed p
+        return res; // on failure the old block is still valid
+    }
+    VARMAP.redefRange(old, res, size);
+    return res;
 }
 
-#if TRACK_ERROR
-#define PC(id) ERROR_STATE.moveTo(id)
+template<typename T>
+void DYNUNDEF(T * res)
+{
+    VARMAP.undefRange(res);
+    free(res);
+}
+
+#if PC_PROFILE
+#include "PcProfile.hpp"
+#define PROFILE_PC(id) real::PcProfile::INSTANCE.hit(id)
+#else
+#define PROFILE_PC(id) (void)0
+#endif
+
+#if SHADOW_PROFILE
+#define PROFILE_CYCLES(id) real::CycleProfile::INSTANCE.enter(id)
 #else
-#define PC(id) 
+#define PROFILE_CYCLES(id) (void)0
 #endif
 
+#if SHADOW_MEMSTATS
+#define PROFILE_MEMORY(id) real::MemStats::INSTANCE.enter(id)
+#else
+#define PROFILE_MEMORY(id) (void)0
+#endif
+
+#if SHADOW_TRACE
+#define TRACE_PC(id) real::ErrorTrace::INSTANCE.enter(id)
+#else
+#define TRACE_PC(id) (void)0
+#endif
+
+#if TRACK_ERROR || TRACK_CONDITION
+#define PC(id) (PROFILE_PC(id), PROFILE_CYCLES(id), PROFILE_MEMORY(id), TRACE_PC(id), ERROR_STATE.moveTo(id))
+#else
+#define PC(id) (PROFILE_PC(id), PROFILE_CYCLES(id), PROFILE_MEMORY(id), TRACE_PC(id))
+#endif
+
+// reseeds a shadow from its original, e.g., after statements left native by turnFpArith -profile
+inline void EAST_SYNC(SVal &sv, double v)
+{
+    sv = v;
+}
+
 #define CALCERR(svar, ovar) real::Real::CalcError(svar, ovar)
 
 #if TRACK_ERROR
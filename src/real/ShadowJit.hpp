@@ -0,0 +1,624 @@
+#ifndef SHADOW_JIT_HPP
+#define SHADOW_JIT_HPP
+/*
+Shadow kernels of hot statements (turnFpArith -jit).
+
+The instrumentation records the expression DAG of an arithmetic assignment as a postfix program,
+  l<i>: the i-th shadowed leaf, d<i>: the i-th double operand, + - * /: binary operators, n: negation,
+and emits EAST_JIT(target, "program", JIT_LEAVES(...), JIT_DOUBLES(...)). Leaves that print the same
+are passed once, so the shadow lookup of a variable used several times is done once.
+
+A site interprets its program with the port macros. With SHADOW_JIT, once a site has run
+SHADOW_JIT_THRESHOLD times, its program is compiled with LLVM ORC (LLJIT, in process and offline) into
+  double kernel(ShadowState **leaves, const double *doubles, ShadowState *target)
+which does the double-double arithmetic of qd (the same algorithms, so shadows do not change), the
+original computation and the relative error of the target in straight-line code. Kernels are only
+generated for DD_PORT with double originals.
+
+SHADOW_JIT builds take the flags of `llvm-config --cxxflags`, followed by -std=c++17 since LLVM asks for
+C++14, and link `llvm-config --ldflags --libs --system-libs`; `make jitcheck` is such a build.
+*/
+#include <array>
+#include <vector>
+#include <string>
+#include <stdlib.h>
+#include <stddef.h>
+#include "RealConfigure.h"
+#include "Real.hpp"
+
+#if SHADOW_JIT
+#if PORT_TYPE != DD_PORT || ORIGINAL_WIDTHS || !KEEP_ORIGINAL
+#error "SHADOW_JIT needs DD_PORT and double originals"
+#endif
+#include <memory>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/TargetSelect.h>
+#endif
+
+namespace real
+{
+    namespace jit
+    {
+        struct Instruction
+        {
+            char op; // 'l', 'd', '+', '-', '*', '/', 'n'
+            int index;
+        };
+
+        typedef double (*Kernel)(ShadowState **leaves, const double *doubles, ShadowState *target);
+
+#if SHADOW_JIT
+        class KernelCompiler
+        {
+        public:
+            static KernelCompiler INSTANCE;
+
+            KernelCompiler() : broken(false), kernels(0) {}
+
+            Kernel compile(const std::vector<Instruction> &code);
+
+        private:
+            std::unique_ptr<llvm::orc::LLJIT> jit;
+            bool broken;
+            uint64 kernels;
+
+            bool init()
+            {
+                if (jit != nullptr)
+                    return true;
+                if (broken)
+                    return false;
+                llvm::InitializeNativeTarget();
+                llvm::InitializeNativeTargetAsmPrinter();
+                auto created = llvm::orc::LLJITBuilder().create();
+                if (!created)
+                {
+                    std::cout << "Warning! Failed to create the shadow JIT: " << llvm::toString(created.takeError()) << "\n";
+                    broken = true;
+                    return false;
+                }
+                jit = std::move(*created);
+                return true;
+            }
+        };
+        KernelCompiler KernelCompiler::INSTANCE;
+
+        // emits the qd algorithms (dd_inline.h, sloppy add and div) for one kernel
+        struct KernelBuilder
+        {
+            struct DD
+            {
+                llvm::Value *hi;
+                llvm::Value *lo;
+                llvm::Value *original;
+                bool isDouble; // lo is unused
+            };
+
+            llvm::IRBuilder<> &b;
+            llvm::Function *fma;
+            llvm::Function *fabs;
+
+            KernelBuilder(llvm::IRBuilder<> &builder, llvm::Module *module) : b(builder)
+            {
+                fma = llvm::Intrinsic::getDeclaration(module, llvm::Intrinsic::fma, {b.getDoubleTy()});
+                fabs = llvm::Intrinsic::getDeclaration(module, llvm::Intrinsic::fabs, {b.getDoubleTy()});
+            }
+
+            llvm::Value *twoSum(llvm::Value *a, llvm::Value *c, llvm::Value *&err)
+            {
+                llvm::Value *s = b.CreateFAdd(a, c);
+                llvm::Value *bb = b.CreateFSub(s, a);
+                err = b.CreateFAdd(b.CreateFSub(a, b.CreateFSub(s, bb)), b.CreateFSub(c, bb));
+                return s;
+            }
+
+            llvm::Value *twoDiff(llvm::Value *a, llvm::Value *c, llvm::Value *&err)
+            {
+                llvm::Value *s = b.CreateFSub(a, c);
+                llvm::Value *bb = b.CreateFSub(s, a);
+                err = b.CreateFSub(b.CreateFSub(a, b.CreateFSub(s, bb)), b.CreateFAdd(c, bb));
+                return s;
+            }
+
+            llvm::Value *quickTwoSum(llvm::Value *a, llvm::Value *c, llvm::Value *&err)
+            {
+                llvm::Value *s = b.CreateFAdd(a, c);
+                err = b.CreateFSub(c, b.CreateFSub(s, a));
+                return s;
+            }
+
+            // exact as split() of qd
+            llvm::Value *twoProd(llvm::Value *a, llvm::Value *c, llvm::Value *&err)
+            {
+                llvm::Value *p = b.CreateFMul(a, c);
+                err = b.CreateCall(fma, {a, c, b.CreateFNeg(p)});
+                return p;
+            }
+
+            DD add(const DD &l, const DD &r)
+            {
+                DD t{nullptr, nullptr, b.CreateFAdd(l.original, r.original), false};
+                llvm::Value *e;
+                if (l.isDouble || r.isDouble)
+                {
+                    const DD &a = l.isDouble ? r : l;
+                    llvm::Value *d = l.isDouble ? l.hi : r.hi;
+                    llvm::Value *s = twoSum(a.hi, d, e);
+                    t.hi = quickTwoSum(s, b.CreateFAdd(e, a.lo), t.lo);
+                    return t;
+                }
+                llvm::Value *s = twoSum(l.hi, r.hi, e);
+                e = b.CreateFAdd(e, b.CreateFAdd(l.lo, r.lo));
+                t.hi = quickTwoSum(s, e, t.lo);
+                return t;
+            }
+
+            DD sub(const DD &l, const DD &r)
+            {
+                DD t{nullptr, nullptr, b.CreateFSub(l.original, r.original), false};
+                llvm::Value *e;
+                if (l.isDouble)
+                {
+                    llvm::Value *s = twoDiff(l.hi, r.hi, e);
+                    t.hi = quickTwoSum(s, b.CreateFSub(e, r.lo), t.lo);
+                    return t;
+                }
+                if (r.isDouble)
+                {
+                    llvm::Value *s = twoDiff(l.hi, r.hi, e);
+                    t.hi = quickTwoSum(s, b.CreateFAdd(e, l.lo), t.lo);
+                    return t;
+                }
+                llvm::Value *s = twoDiff(l.hi, r.hi, e);
+                e = b.CreateFSub(b.CreateFAdd(e, l.lo), r.lo);
+                t.hi = quickTwoSum(s, e, t.lo);
+                return t;
+            }
+
+            DD mul(const DD &l, const DD &r)
+            {
+                DD t{nullptr, nullptr, b.CreateFMul(l.original, r.original), false};
+                llvm::Value *e;
+                if (l.isDouble || r.isDouble)
+                {
+                    const DD &a = l.isDouble ? r : l;
+                    llvm::Value *d = l.isDouble ? l.hi : r.hi;
+                    llvm::Value *p = twoProd(a.hi, d, e);
+                    t.hi = quickTwoSum(p, b.CreateFAdd(e, b.CreateFMul(a.lo, d)), t.lo);
+                    return t;
+                }
+                llvm::Value *p = twoProd(l.hi, r.hi, e);
+                e = b.CreateFAdd(e, b.CreateFAdd(b.CreateFMul(l.hi, r.lo), b.CreateFMul(l.lo, r.hi)));
+                t.hi = quickTwoSum(p, e, t.lo);
+                return t;
+            }
+
+            DD div(const DD &l, const DD &r)
+            {
+                DD t{nullptr, nullptr, b.CreateFDiv(l.original, r.original), false};
+                llvm::Value *e, *p2;
+                llvm::Value *lo = l.isDouble ? llvm::ConstantFP::get(b.getDoubleTy(), 0.0) : l.lo;
+                llvm::Value *q1 = b.CreateFDiv(l.hi, r.hi);
+                if (r.isDouble)
+                {
+                    llvm::Value *p1 = twoProd(q1, r.hi, p2);
+                    llvm::Value *s = twoDiff(l.hi, p1, e);
+                    e = b.CreateFSub(b.CreateFAdd(e, lo), p2);
+                    llvm::Value *q2 = b.CreateFDiv(b.CreateFAdd(s, e), r.hi);
+                    t.hi = quickTwoSum(q1, q2, t.lo);
+                    return t;
+                }
+                // r = b * q1
+                llvm::Value *p1 = twoProd(r.hi, q1, p2);
+                p2 = b.CreateFAdd(p2, b.CreateFMul(r.lo, q1));
+                llvm::Value *r1, *r0 = quickTwoSum(p1, p2, r1);
+                llvm::Value *s2, *s1 = twoDiff(l.hi, r0, s2);
+                s2 = b.CreateFAdd(b.CreateFSub(s2, r1), lo);
+                llvm::Value *q2 = b.CreateFDiv(b.CreateFAdd(s1, s2), r.hi);
+                t.hi = quickTwoSum(q1, q2, t.lo);
+                return t;
+            }
+
+            DD neg(const DD &v)
+            {
+                DD zero{llvm::ConstantFP::get(b.getDoubleTy(), 0.0), nullptr, llvm::ConstantFP::get(b.getDoubleTy(), 0.0), true};
+                DD t = sub(zero, v);
+                t.original = b.CreateFNeg(v.original);
+                return t;
+            }
+
+            // Real::CalcError
+            llvm::Value *relativeError(llvm::Value *shadow, llvm::Value *original)
+            {
+#if ERROR_METRIC == ULP_METRIC
+                llvm::Value *s = orderedBits(shadow), *o = orderedBits(original);
+                llvm::Value *ulps = b.CreateSelect(b.CreateICmpSGT(s, o), b.CreateSub(s, o), b.CreateSub(o, s));
+                return b.CreateFMul(b.CreateUIToFP(ulps, b.getDoubleTy()), llvm::ConstantFP::get(b.getDoubleTy(), ORIGINAL_ULP));
+#else
+                llvm::Value *zero = llvm::ConstantFP::get(b.getDoubleTy(), 0.0);
+                llvm::Value *shadowZero = b.CreateFCmpOEQ(shadow, zero);
+                llvm::Value *bothZero = b.CreateAnd(shadowZero, b.CreateFCmpOEQ(original, zero));
+                llvm::Value *dsv = b.CreateSelect(shadowZero, llvm::ConstantFP::get(b.getDoubleTy(), 1.1E-16), shadow);
+                llvm::Value *re = b.CreateCall(fabs, {b.CreateFDiv(b.CreateFSub(dsv, original), dsv)});
+                return b.CreateSelect(bothZero, zero, re);
+#endif
+            }
+
+            // the bits of a double as an integer ordered like the double, see ulpDistance
+            llvm::Value *orderedBits(llvm::Value *v)
+            {
+                llvm::Value *bits = b.CreateBitCast(v, b.getInt64Ty());
+                llvm::Value *sign = b.CreateAShr(bits, 63);
+                return b.CreateSub(b.CreateXor(bits, b.CreateAnd(sign, b.getInt64(INT64_MAX))), sign);
+            }
+        };
+
+        Kernel KernelCompiler::compile(const std::vector<Instruction> &code)
+        {
+            if (!init())
+                return nullptr;
+            std::string name = "east_kernel_" + std::to_string(kernels++);
+            auto context = std::make_unique<llvm::LLVMContext>();
+            auto module = std::make_unique<llvm::Module>(name, *context);
+            llvm::IRBuilder<> b(*context);
+
+            llvm::Type *dbl = b.getDoubleTy();
+            llvm::Type *byte = b.getInt8Ty();
+            llvm::PointerType *state = b.getInt8PtrTy();
+            llvm::FunctionType *type = llvm::FunctionType::get(dbl, {llvm::PointerType::getUnqual(state), llvm::PointerType::getUnqual(dbl), state}, false);
+            llvm::Function *f = llvm::Function::Create(type, llvm::Function::ExternalLinkage, name, module.get());
+            b.SetInsertPoint(llvm::BasicBlock::Create(*context, "entry", f));
+            llvm::Value *leaves = f->getArg(0);
+            llvm::Value *doubles = f->getArg(1);
+            llvm::Value *target = f->getArg(2);
+
+            const uint64 shadowOffset = offsetof(ShadowState, shadowValue);
+            const uint64 originalOffset = offsetof(ShadowState, originalValue);
+            auto field = [&](llvm::Value *s, uint64 offset) {
+                return b.CreateBitCast(b.CreateConstGEP1_64(byte, s, offset), llvm::PointerType::getUnqual(dbl));
+            };
+
+            KernelBuilder k(b, module.get());
+            std::vector<KernelBuilder::DD> stack;
+            std::vector<KernelBuilder::DD> loaded;
+            for (const Instruction &i : code)
+            {
+                if (i.op == 'l')
+                {
+                    if ((int)loaded.size() <= i.index)
+                        loaded.resize(i.index + 1, {nullptr, nullptr, nullptr, false});
+                    if (loaded[i.index].hi == nullptr)
+                    {
+                        llvm::Value *s = b.CreateLoad(state, b.CreateConstGEP1_64(state, leaves, i.index));
+                        llvm::Value *hi = b.CreateLoad(dbl, field(s, shadowOffset));
+                        llvm::Value *lo = b.CreateLoad(dbl, field(s, shadowOffset + sizeof(double)));
+                        llvm::Value *o = b.CreateLoad(dbl, field(s, originalOffset));
+                        loaded[i.index] = {hi, lo, o, false};
+                    }
+                    stack.push_back(loaded[i.index]);
+                    continue;
+                }
+                if (i.op == 'd')
+                {
+                    llvm::Value *d = b.CreateLoad(dbl, b.CreateConstGEP1_64(dbl, doubles, i.index));
+                    stack.push_back({d, nullptr, d, true});
+                    continue;
+                }
+                if (i.op == 'n')
+                {
+                    KernelBuilder::DD v = stack.back();
+                    stack.back() = v.isDouble ? KernelBuilder::DD{b.CreateFNeg(v.hi), nullptr, b.CreateFNeg(v.hi), true} : k.neg(v);
+                    continue;
+                }
+                KernelBuilder::DD r = stack.back();
+                stack.pop_back();
+                KernelBuilder::DD l = stack.back();
+                if (l.isDouble && r.isDouble)
+                {
+                    // computed natively, as in the program
+                    llvm::Value *v = i.op == '+' ? b.CreateFAdd(l.hi, r.hi) : i.op == '-' ? b.CreateFSub(l.hi, r.hi) : i.op == '*' ? b.CreateFMul(l.hi, r.hi) : b.CreateFDiv(l.hi, r.hi);
+                    stack.back() = {v, nullptr, v, true};
+                    continue;
+                }
+                stack.back() = i.op == '+' ? k.add(l, r) : i.op == '-' ? k.sub(l, r) : i.op == '*' ? k.mul(l, r) : k.div(l, r);
+            }
+
+            KernelBuilder::DD result = stack.back();
+            llvm::Value *lo = result.isDouble ? llvm::ConstantFP::get(dbl, 0.0) : result.lo;
+            b.CreateStore(result.hi, field(target, shadowOffset));
+            b.CreateStore(lo, field(target, shadowOffset + sizeof(double)));
+            b.CreateStore(result.original, field(target, originalOffset));
+            b.CreateRet(k.relativeError(result.hi, result.original));
+
+            if (auto err = jit->addIRModule(llvm::orc::ThreadSafeModule(std::move(module), std::move(context))))
+            {
+                std::cout << "Warning! Failed to add a shadow kernel: " << llvm::toString(std::move(err)) << "\n";
+                return nullptr;
+            }
+            auto symbol = jit->lookup(name);
+            if (!symbol)
+            {
+                std::cout << "Warning! Failed to compile a shadow kernel: " << llvm::toString(symbol.takeError()) << "\n";
+                return nullptr;
+            }
+            return (Kernel)symbol->getAddress();
+        }
+#endif
+
+        class Site
+        {
+        public:
+            Site(const char *program) : dag(program), shadowOps(0), count(0), kernel(nullptr), compiled(false)
+            {
+                int depth = 0, maxDepth = 0;
+                std::vector<bool> isDouble; // of the operands on the stack, operations of doubles only are native
+                for (const char *p = program; *p != 0;)
+                {
+                    while (*p == ' ')
+                        p++;
+                    if (*p == 0)
+                        break;
+                    Instruction i{*p++, 0};
+                    if (i.op == 'l' || i.op == 'd')
+                    {
+                        i.index = (int)strtol(p, (char **)&p, 10);
+                        depth++;
+                        if (i.op == 'l')
+                            leafUses.push_back(i.index);
+                        isDouble.push_back(i.op == 'd');
+                    }
+                    else if (i.op != 'n')
+                    {
+                        depth--;
+                        bool r = isDouble.back();
+                        isDouble.pop_back();
+                        shadowOps += !(isDouble.back() && r);
+                        isDouble.back() = isDouble.back() && r;
+                    }
+                    else
+                    {
+                        shadowOps += !isDouble.back();
+                    }
+                    code.push_back(i);
+                    if (depth > maxDepth)
+                        maxDepth = depth;
+                }
+                for (int i = 0; i < maxDepth; i++)
+                    scratch.push_back(ShadowPool::INSTANCE.get());
+                stack.resize(maxDepth);
+            }
+
+            template <size_t N, size_t M>
+            INLINE_FLAGS real::Real &run(real::Real &target, const std::array<ShadowState *, N> &leaves, const std::array<double, M> &doubles)
+            {
+                run(*target.shadow, (ShadowState **)leaves.data(), doubles.data());
+                return target;
+            }
+
+            void run(ShadowState &target, ShadowState **leaves, const double *doubles)
+            {
+#if SHADOW_JIT
+                if (__builtin_expect(!compiled, 0) && ++count >= SHADOW_JIT_THRESHOLD)
+                {
+                    compiled = true;
+                    kernel = KernelCompiler::INSTANCE.compile(code);
+                }
+                if (kernel != nullptr)
+                {
+#if TRACK_ERROR
+                    for (int i : leafUses)
+                        ERROR_STATE.updateSymbolicVarError(leaves[i]->error);
+#endif
+                    double re = kernel(leaves, doubles, &target);
+                    for (int i = 0; i < shadowOps; i++)
+                        PROFILE_OP(); // as interpret() counts them
+#if TRACK_ERROR && ACTIVE_TRACK_ERROR
+                    ERROR_STATE.updateError(target.error, re);
+#endif
+                    return;
+                }
+#endif
+                interpret(target, leaves, doubles);
+            }
+
+        private:
+            struct Slot
+            {
+                ShadowState *state;
+                double d;
+                bool isDouble;
+            };
+
+            const char *dag;
+            std::vector<Instruction> code;
+            std::vector<int> leafUses;
+            int shadowOps; // the shadow operations of a run, as PROFILE_OP counts them
+            std::vector<ShadowState *> scratch;
+            std::vector<Slot> stack;
+            uint64 count;
+            Kernel kernel;
+            bool compiled;
+
+// without originals nothing of them is computed, JIT_ORIGINAL is then left undefined
+#if KEEP_ORIGINAL
+#define JIT_ORIGINAL(s) ((s).isDouble ? (s).d : (s).state->originalValue)
+#define JIT_ORIGINAL_OP(o, e) double o = e
+#define JIT_SET_ORIGINAL(t, v) (t).originalValue = v
+#else
+#define JIT_ORIGINAL_OP(o, e)
+#define JIT_SET_ORIGINAL(t, v)
+#endif
+
+            static void apply(char op, ShadowState &t, const Slot &l, const Slot &r)
+            {
+                PROFILE_OP();
+                // the original first, t may be the state of an operand
+                switch (op)
+                {
+                case '+':
+                {
+                    JIT_ORIGINAL_OP(o, JIT_ORIGINAL(l) + JIT_ORIGINAL(r));
+                    if (l.isDouble)
+                        ADD_RD(t.shadowValue, r.state->shadowValue, l.d);
+                    else if (r.isDouble)
+                        ADD_RD(t.shadowValue, l.state->shadowValue, r.d);
+                    else
+                        ADD_RR(t.shadowValue, l.state->shadowValue, r.state->shadowValue);
+                    JIT_SET_ORIGINAL(t, o);
+                    break;
+                }
+                case '-':
+                {
+                    JIT_ORIGINAL_OP(o, JIT_ORIGINAL(l) - JIT_ORIGINAL(r));
+                    if (l.isDouble)
+                        SUB_DR(t.shadowValue, l.d, r.state->shadowValue);
+                    else if (r.isDouble)
+                        SUB_RD(t.shadowValue, l.state->shadowValue, r.d);
+                    else
+                        SUB_RR(t.shadowValue, l.state->shadowValue, r.state->shadowValue);
+                    JIT_SET_ORIGINAL(t, o);
+                    break;
+                }
+                case '*':
+                {
+                    JIT_ORIGINAL_OP(o, JIT_ORIGINAL(l) * JIT_ORIGINAL(r));
+                    if (l.isDouble)
+                        MUL_RD(t.shadowValue, r.state->shadowValue, l.d);
+                    else if (r.isDouble)
+                        MUL_RD(t.shadowValue, l.state->shadowValue, r.d);
+                    else
+                        MUL_RR(t.shadowValue, l.state->shadowValue, r.state->shadowValue);
+                    JIT_SET_ORIGINAL(t, o);
+                    break;
+                }
+                default:
+                {
+                    JIT_ORIGINAL_OP(o, JIT_ORIGINAL(l) / JIT_ORIGINAL(r));
+                    if (l.isDouble)
+                        DIV_DR(t.shadowValue, l.d, r.state->shadowValue);
+                    else if (r.isDouble)
+                        DIV_RD(t.shadowValue, l.state->shadowValue, r.d);
+                    else
+                        DIV_RR(t.shadowValue, l.state->shadowValue, r.state->shadowValue);
+                    JIT_SET_ORIGINAL(t, o);
+                    break;
+                }
+                }
+            }
+
+            static double native(char op, double l, double r)
+            {
+                switch (op)
+                {
+                case '+':
+                    return l + r;
+                case '-':
+                    return l - r;
+                case '*':
+                    return l * r;
+                default:
+                    return l / r;
+                }
+            }
+
+            void interpret(ShadowState &target, ShadowState **leaves, const double *doubles)
+            {
+                int sp = 0;
+                for (size_t pc = 0, last = code.size() - 1; pc <= last; pc++)
+                {
+                    const Instruction &i = code[pc];
+                    // the last operation writes the target, its operands are read before
+                    auto result = [&](int pos) -> ShadowState & { return pc == last ? target : *scratch[pos]; };
+                    switch (i.op)
+                    {
+                    case 'l':
+#if TRACK_ERROR
+                        ERROR_STATE.updateSymbolicVarError(leaves[i.index]->error);
+#endif
+                        stack[sp++] = {leaves[i.index], 0, false};
+                        break;
+                    case 'd':
+                        stack[sp++] = {nullptr, doubles[i.index], true};
+                        break;
+                    case 'n':
+                        if (stack[sp - 1].isDouble)
+                        {
+                            stack[sp - 1].d = -stack[sp - 1].d;
+                            break;
+                        }
+                        {
+                            ShadowState &t = result(sp - 1);
+                            PROFILE_OP();
+                            JIT_ORIGINAL_OP(o, -JIT_ORIGINAL(stack[sp - 1]));
+                            SUB_DR(t.shadowValue, 0, stack[sp - 1].state->shadowValue);
+                            JIT_SET_ORIGINAL(t, o);
+                            stack[sp - 1] = {&t, 0, false};
+                        }
+                        break;
+                    default:
+                        sp--;
+                        if (stack[sp - 1].isDouble && stack[sp].isDouble)
+                        {
+                            stack[sp - 1].d = native(i.op, stack[sp - 1].d, stack[sp].d);
+                            break;
+                        }
+                        {
+                            ShadowState &t = result(sp - 1);
+                            apply(i.op, t, stack[sp - 1], stack[sp]);
+                            stack[sp - 1] = {&t, 0, false};
+                        }
+                        break;
+                    }
+                }
+
+                const Slot &root = stack[0];
+                if (root.isDouble)
+                {
+                    ASSIGN_D(target.shadowValue, root.d);
+                    JIT_SET_ORIGINAL(target, root.d);
+#if TRACK_ERROR
+                    ERROR_STATE.setError(target.error, 0);
+#endif
+                    return;
+                }
+                if (root.state != &target)
+                {
+                    ASSIGN(target.shadowValue, root.state->shadowValue);
+                    JIT_SET_ORIGINAL(target, JIT_ORIGINAL(root));
+                }
+#if TRACK_ERROR && ACTIVE_TRACK_ERROR
+                real::Real::UpdError(target, target.originalValue);
+#endif
+            }
+#undef JIT_ORIGINAL
+#undef JIT_ORIGINAL_OP
+#undef JIT_SET_ORIGINAL
+        };
+
+        template <typename... Args>
+        INLINE_FLAGS std::array<ShadowState *, sizeof...(Args)> leaves(const Args &... r)
+        {
+            return {r.shadow...};
+        }
+
+        template <typename... Args>
+        INLINE_FLAGS std::array<double, sizeof...(Args)> doubles(const Args &... d)
+        {
+            return {(double)d...};
+        }
+    }; // namespace jit
+};     // namespace real
+
+#define JIT_LEAVES(...) real::jit::leaves(__VA_ARGS__)
+#define JIT_DOUBLES(...) real::jit::doubles(__VA_ARGS__)
+#define EAST_JIT(target, dag, leaves, doubles) ([&]() -> real::Real & { \
+    static real::jit::Site __jit_site(dag);                           \
+    return __jit_site.run(target, leaves, doubles);                   \
+}())
+
+#endif
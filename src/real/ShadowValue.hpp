@@ -1,5 +1,6 @@
 #ifndef SHADOW_VALUE_HPP
 #define SHADOW_VALUE_HPP
+#include <stddef.h>
 
 #ifdef __LITTLE_ENDIAN
 #define __HI(x) *(1+(int*)&x)
@@ -15,6 +16,20 @@
 
 #if  PORT_TYPE == DD_PORT
 #include "DDPort.hpp"
+#elif PORT_TYPE == COMPACT_PORT
+#include "CompactPort.hpp"
+#elif PORT_TYPE == DOUBLE_PORT
+#include "DoublePort.hpp"
+#elif PORT_TYPE == CONDITION_PORT
+#include "ConditionPort.hpp"
+#elif PORT_TYPE == STOCHASTIC_PORT
+#include "StochasticPort.hpp"
+#elif PORT_TYPE == INTERVAL_PORT
+#include "IntervalPort.hpp"
+#elif PORT_TYPE == AFFINE_PORT
+#include "AffinePort.hpp"
+#elif PORT_TYPE == FLOAT128_PORT
+#include "Float128Port.hpp"
 #else
 #include "MPFRPort.hpp"
 #endif
@@ -22,6 +37,11 @@
 #include "RealUtil.hpp"
 #include "ErrorState.hpp"
 
+// bytes a shadow value allocates out of line at precision p
+#ifndef HP_HEAP_BYTES
+#define HP_HEAP_BYTES(p) 0
+#endif
+
 
 namespace real
 {
@@ -33,26 +53,50 @@ namespace real
         HP_TYPE shadowValue;
 #if TRACK_ERROR
         SymbolicVarError error;
+#endif
+#if KEEP_ORIGINAL && ORIGINAL_WIDTHS
+        bool single; // the original is a float, see ORIGINAL_WIDTHS
 #endif
     };
     typedef ShadowState *sval_ptr;
 
+#if KEEP_ORIGINAL && ORIGINAL_WIDTHS
+    // +, -, *, / and sqrt of floats computed in double and rounded to float give the float result (53 >= 2 * 24 + 2)
+#define NARROW(v, single) ((single) ? (double)(float)(v) : (v))
+#define ORIGINAL_ULP_OF(s) ((s).single ? FLOAT_ULP : ORIGINAL_ULP)
+#else
+#define NARROW(v, single) (v)
+#define ORIGINAL_ULP_OF(s) ORIGINAL_ULP
+#endif
+#ifdef HP_ORIGINAL_OFFSET
+    static_assert(offsetof(ShadowState, shadowValue) == offsetof(ShadowState, originalValue) + HP_ORIGINAL_OFFSET,
+                  "the shadow value reads its original HP_ORIGINAL_OFFSET bytes before it");
+#endif
+
     template <int p>
     struct ShadowSlotInitializer
     {
         inline void construct(ShadowState &v)
         {
             INIT(v.shadowValue, p);
+            if (HP_HEAP_BYTES(p) > 0)
+                MEMSTATS_ALLOC(MEM_LIMBS, HP_HEAP_BYTES(p));
 #if TRACK_ERROR
             v.error = {0,0,0,0};
+#endif
+#if KEEP_ORIGINAL && ORIGINAL_WIDTHS
+            v.single = false;
 #endif
         }
         inline void destruct(ShadowState &v)
         {
             CLEAR(v.shadowValue);
+            if (HP_HEAP_BYTES(p) > 0)
+                MEMSTATS_FREE(MEM_LIMBS, HP_HEAP_BYTES(p));
         }
     };
-    using ShadowPool = util::ValuePool<ShadowState, 128, ShadowSlotInitializer<120>>;
+    using ShadowInitializer = ShadowSlotInitializer<120>;
+    using ShadowPool = util::ValuePool<ShadowState, 128, ShadowInitializer>;
 
 
 };
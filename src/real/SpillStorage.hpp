@@ -0,0 +1,264 @@
+#ifndef SPILL_STORAGE_HPP
+#define SPILL_STORAGE_HPP
+/*
+Storage behind the shadow blocks of heap arrays (see VariableMap::RangeSlot).
+
+Small blocks live on the heap. With SHADOW_SPILL, blocks of at least SPILL_THRESHOLD bytes are
+placed in unlinked temporary files under SPILL_DIR and mapped with mmap(MAP_SHARED), so the OS
+can write cold shadow data back to disk instead of the run dying from OOM. The mappings are
+read ahead sequentially, and the resident part of all spilled blocks is bounded by
+SPILL_RESIDENT_LIMIT: they are tracked in chunks of 2^SPILL_CHUNK_SHIFT bytes on an LRU list,
+and the least recently used chunks are paged out once the limit is exceeded.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <list>
+#include <vector>
+#include <iostream>
+#include "RealConfigure.h"
+
+#if SHADOW_SPILL
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
+namespace real
+{
+    namespace util
+    {
+#if SHADOW_SPILL
+        class SpillRegion;
+
+        class SpillManager
+        {
+        public:
+            static SpillManager INSTANCE;
+
+            struct Chunk
+            {
+                SpillRegion *region;
+                size_t id;
+            };
+            std::list<Chunk> lru; // most recently used first
+            size_t residentBytes;
+            size_t spilledBytes;
+            // gets the bytes of every evicted chunk, caches that skip touch() drop their pointers into it
+            static void (*evicted)(const char *begin, const char *end);
+
+            SpillManager() : residentBytes(0), spilledBytes(0) {}
+
+            inline void touch(SpillRegion *region, size_t chunk);
+            inline void forget(SpillRegion *region);
+
+        private:
+            void evict(const Chunk &c);
+        };
+        SpillManager SpillManager::INSTANCE;
+        void (*SpillManager::evicted)(const char *, const char *) = nullptr;
+
+        class SpillRegion
+        {
+        public:
+            int fd;
+            char *base;
+            size_t bytes;
+            size_t lastChunk;
+            std::vector<std::list<SpillManager::Chunk>::iterator> chunks;
+            std::vector<bool> resident;
+
+            static size_t chunkCount(size_t bytes)
+            {
+                return (bytes >> SPILL_CHUNK_SHIFT) + 1;
+            }
+
+            static SpillRegion *create(size_t bytes)
+            {
+                char path[4096];
+                snprintf(path, sizeof(path), "%s/east-shadow-XXXXXX", SPILL_DIR);
+                int fd = mkstemp(path);
+                if (fd < 0)
+                    return nullptr;
+                unlink(path); // the file disappears with the last mapping
+                if (ftruncate(fd, bytes) != 0)
+                {
+                    close(fd);
+                    return nullptr;
+                }
+                void *m = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (m == MAP_FAILED)
+                {
+                    close(fd);
+                    return nullptr;
+                }
+                madvise(m, bytes, MADV_SEQUENTIAL);
+
+                SpillRegion *r = new SpillRegion();
+                r->fd = fd;
+                r->base = (char *)m;
+                r->bytes = bytes;
+                r->lastChunk = (size_t)-1;
+                r->chunks.resize(chunkCount(bytes));
+                r->resident.resize(chunkCount(bytes), false);
+                SpillManager::INSTANCE.spilledBytes += bytes;
+                return r;
+            }
+
+            bool resize(size_t newBytes)
+            {
+                if (ftruncate(fd, newBytes) != 0)
+                    return false;
+                void *m = mremap(base, bytes, newBytes, MREMAP_MAYMOVE);
+                if (m == MAP_FAILED)
+                    return false;
+                madvise(m, newBytes, MADV_SEQUENTIAL);
+                SpillManager::INSTANCE.forget(this);
+                SpillManager::INSTANCE.spilledBytes += newBytes - bytes;
+                base = (char *)m;
+                bytes = newBytes;
+                lastChunk = (size_t)-1;
+                chunks.clear();
+                chunks.resize(chunkCount(newBytes));
+                resident.assign(chunkCount(newBytes), false);
+                return true;
+            }
+
+            void release()
+            {
+                SpillManager::INSTANCE.forget(this);
+                SpillManager::INSTANCE.spilledBytes -= bytes;
+                munmap(base, bytes);
+                close(fd);
+                delete this;
+            }
+
+            inline void touch(size_t offset)
+            {
+                size_t chunk = offset >> SPILL_CHUNK_SHIFT;
+                if (__builtin_expect(chunk != lastChunk, 0))
+                {
+                    lastChunk = chunk;
+                    SpillManager::INSTANCE.touch(this, chunk);
+                }
+            }
+        };
+
+        inline void SpillManager::touch(SpillRegion *region, size_t chunk)
+        {
+            if (region->resident[chunk])
+            {
+                lru.splice(lru.begin(), lru, region->chunks[chunk]);
+                return;
+            }
+            lru.push_front({region, chunk});
+            region->chunks[chunk] = lru.begin();
+            region->resident[chunk] = true;
+            residentBytes += (size_t)1 << SPILL_CHUNK_SHIFT;
+            while (residentBytes > SPILL_RESIDENT_LIMIT && lru.size() > 1)
+            {
+                Chunk victim = lru.back();
+                lru.pop_back();
+                evict(victim);
+            }
+        }
+
+        inline void SpillManager::forget(SpillRegion *region)
+        {
+            for (size_t i = 0; i < region->resident.size(); i++)
+            {
+                if (region->resident[i])
+                {
+                    lru.erase(region->chunks[i]);
+                    region->resident[i] = false;
+                    residentBytes -= (size_t)1 << SPILL_CHUNK_SHIFT;
+                }
+            }
+        }
+
+        void SpillManager::evict(const Chunk &c)
+        {
+            SpillRegion *r = c.region;
+            r->resident[c.id] = false;
+            if (r->lastChunk == c.id)
+                r->lastChunk = (size_t)-1;
+            residentBytes -= (size_t)1 << SPILL_CHUNK_SHIFT;
+
+            size_t offset = c.id << SPILL_CHUNK_SHIFT;
+            size_t len = r->bytes - offset < ((size_t)1 << SPILL_CHUNK_SHIFT) ? r->bytes - offset : ((size_t)1 << SPILL_CHUNK_SHIFT);
+            char *addr = r->base + offset;
+            if (evicted != nullptr)
+                evicted(addr, addr + len);
+#ifdef MADV_PAGEOUT
+            if (madvise(addr, len, MADV_PAGEOUT) == 0)
+                return;
+#endif
+            // write the dirty pages back, then drop them from the mapping and the page cache
+            msync(addr, len, MS_SYNC);
+            madvise(addr, len, MADV_DONTNEED);
+            posix_fadvise(r->fd, offset, len, POSIX_FADV_DONTNEED);
+        }
+#else
+        class SpillRegion
+        {
+        public:
+            inline void touch(size_t) {}
+            void release() {}
+        };
+#endif
+
+        struct RangeStorage
+        {
+            static void *allocate(size_t bytes, SpillRegion *&region)
+            {
+                region = nullptr;
+#if SHADOW_SPILL
+                if (bytes >= SPILL_THRESHOLD)
+                {
+                    region = SpillRegion::create(bytes);
+                    if (region != nullptr)
+                        return region->base;
+                    std::cout << "Warning! Failed to spill a shadow block of " << bytes << " bytes, using the heap.\n";
+                }
+#endif
+                return malloc(bytes == 0 ? 1 : bytes);
+            }
+
+            static void *reallocate(void *p, size_t oldBytes, size_t bytes, SpillRegion *&region)
+            {
+#if SHADOW_SPILL
+                if (region != nullptr && region->resize(bytes))
+                    return region->base;
+                if (region != nullptr || bytes >= SPILL_THRESHOLD)
+                {
+                    // moving between the heap and a spill file
+                    SpillRegion *newRegion;
+                    void *n = allocate(bytes, newRegion);
+                    memcpy(n, p, oldBytes < bytes ? oldBytes : bytes);
+                    release(p, region);
+                    region = newRegion;
+                    return n;
+                }
+#else
+                (void)oldBytes, (void)region;
+#endif
+                return realloc(p, bytes == 0 ? 1 : bytes);
+            }
+
+            static void release(void *p, SpillRegion *&region)
+            {
+                if (region != nullptr)
+                {
+                    region->release();
+                    region = nullptr;
+                }
+                else
+                {
+                    free(p);
+                }
+            }
+        };
+    }; // namespace util
+};     // namespace real
+
+#endif
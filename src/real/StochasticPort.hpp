@@ -0,0 +1,325 @@
+#ifndef STOCHASTIC_PORT_HPP
+#define STOCHASTIC_PORT_HPP
+/*
+Stochastic arithmetic port (CESTAC). A shadow value is SAMPLES = 4 samples of the original
+computation, each rounded at random towards -inf or +inf in every operation. The samples are processed
+as one vector of 4 doubles (a ymm register with -mavx2 -mfma, two xmm registers and libm fma otherwise,
+about twice as slow).
+  - +, -, *, / and sqrt round each sample in a random direction, exactly, using the sign of the rounding
+    error from error-free transformations.
+  - The other functions perturb each sample by an ulp, up or down at random, since the sign of their
+    rounding error is unknown.
+The shadow value (TO_DOUBLE) is the mean of the samples, and the number of significant digits of the
+result is estimated from the agreement of the samples, see significantDigits. The samples are stored
+unaligned, because shadows may be embedded in user structures.
+*/
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+
+#ifndef STOCHASTIC_SEED
+#define STOCHASTIC_SEED 0x9E3779B97F4A7C15ULL
+#endif
+
+// the vectors only pass between inline functions, the ABI change without -mavx does not matter
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+namespace real
+{
+    namespace stochastic
+    {
+        static const int SAMPLES = 4;
+
+        typedef double v4d __attribute__((vector_size(32)));
+        typedef long long v4i __attribute__((vector_size(32)));
+
+        struct StochasticReal
+        {
+            double x[SAMPLES];
+        };
+
+        // random lane masks, 4 bits of a xorshift64* draw per mask
+        struct Random
+        {
+            uint64_t state;
+            uint64_t bits;
+            int left;
+
+            static Random INSTANCE;
+
+            inline v4i lanes()
+            {
+                if (left == 0)
+                {
+                    state ^= state >> 12;
+                    state ^= state << 25;
+                    state ^= state >> 27;
+                    bits = state * 0x2545F4914F6CDD1DULL;
+                    left = 16;
+                }
+                long long b = (long long)bits;
+                bits >>= 4;
+                left--;
+                v4i m = {b & 1, (b >> 1) & 1, (b >> 2) & 1, (b >> 3) & 1};
+                return -m;
+            }
+        };
+        Random Random::INSTANCE = {STOCHASTIC_SEED, 0, 0};
+
+        inline v4d load(const StochasticReal &r)
+        {
+            v4d v;
+            std::memcpy(&v, r.x, sizeof(v));
+            return v;
+        }
+
+        inline void store(StochasticReal &t, const v4d &v)
+        {
+            std::memcpy(t.x, &v, sizeof(v));
+        }
+
+        inline v4d broadcast(double d)
+        {
+            v4d v = {d, d, d, d};
+            return v;
+        }
+
+        // moves the samples selected by away one ulp towards +inf (up) or -inf, finite non-zero samples only
+        inline v4d step(const v4d &s, const v4i &away, const v4i &up)
+        {
+            v4i bits = (v4i)s;
+            v4i moved = away & (s != 0) & (s - s == 0);
+            v4i larger = (bits < 0) ^ up; // up on a positive sample or down on a negative one
+            return (v4d)(bits + (moved & ((larger & 2) - 1)));
+        }
+
+        // s rounded to nearest, with the exact error e of s: random rounding towards -inf or +inf
+        inline v4d round(const v4d &s, const v4d &e)
+        {
+            v4i up = Random::INSTANCE.lanes();
+            v4i away = ((e > 0) & up) | ((e < 0) & ~up);
+            return step(s, away, up);
+        }
+
+        // rounding error unknown: one ulp up or down at random, or none
+        inline v4d perturb(const v4d &s)
+        {
+            return step(s, Random::INSTANCE.lanes(), Random::INSTANCE.lanes());
+        }
+
+        inline void assign(StochasticReal &t, double d)
+        {
+            store(t, broadcast(d));
+        }
+
+        inline void add(StochasticReal &t, const v4d &a, const v4d &b)
+        {
+            v4d s = a + b;
+            v4d bb = s - a;
+            v4d err = (a - (s - bb)) + (b - bb); // two-sum
+            store(t, round(s, err));
+        }
+
+        inline void mul(StochasticReal &t, const v4d &a, const v4d &b)
+        {
+            v4d p = a * b;
+            v4d err;
+            for (int i = 0; i < SAMPLES; i++)
+                err[i] = std::fma(a[i], b[i], -p[i]); // two-prod
+            store(t, round(p, err));
+        }
+
+        inline void div(StochasticReal &t, const v4d &a, const v4d &b)
+        {
+            v4d q = a / b;
+            v4d err;
+            for (int i = 0; i < SAMPLES; i++)
+                err[i] = std::fma(-q[i], b[i], a[i]) / b[i]; // exact remainder, error a/b - q has its sign
+            store(t, round(q, err));
+        }
+
+        inline void sqrt(StochasticReal &t, const v4d &a)
+        {
+            v4d s, err;
+            for (int i = 0; i < SAMPLES; i++)
+            {
+                s[i] = std::sqrt(a[i]);
+                err[i] = std::fma(-s[i], s[i], a[i]);
+            }
+            store(t, round(s, err));
+        }
+
+        // two random roundings, as in the original program without fma
+        inline void fma(StochasticReal &t, const v4d &l, const v4d &m, const v4d &r)
+        {
+            StochasticReal p;
+            mul(p, l, m);
+            add(t, load(p), r);
+        }
+
+        template <typename F>
+        inline void apply(StochasticReal &t, const v4d &a, F f, bool exact)
+        {
+            v4d s;
+            for (int i = 0; i < SAMPLES; i++)
+                s[i] = f(a[i]);
+            store(t, exact ? s : perturb(s));
+        }
+
+        template <typename F>
+        inline void apply(StochasticReal &t, const v4d &a, const v4d &b, F f, bool exact)
+        {
+            v4d s;
+            for (int i = 0; i < SAMPLES; i++)
+                s[i] = f(a[i], b[i]);
+            store(t, exact ? s : perturb(s));
+        }
+
+        inline double mean(const StochasticReal &r)
+        {
+            return ((r.x[0] + r.x[1]) + (r.x[2] + r.x[3])) / SAMPLES;
+        }
+
+        // CESTAC estimate of the number of significant decimal digits of the mean, at 95% confidence
+        inline double significantDigits(const StochasticReal &r)
+        {
+            static const double TAU = 3.182; // Student's t, 3 degrees of freedom
+            static const double MAX_DIGITS = 15.95; // log10(2^53)
+            double m = mean(r);
+            double var = 0;
+            for (int i = 0; i < SAMPLES; i++)
+                var += (r.x[i] - m) * (r.x[i] - m);
+            double sigma = std::sqrt(var / (SAMPLES - 1));
+            if (sigma == 0)
+                return MAX_DIGITS;
+            if (m == 0)
+                return 0; // computational zero
+            double digits = std::log10(std::sqrt((double)SAMPLES) * std::fabs(m) / (sigma * TAU));
+            return digits < 0 ? 0 : (digits > MAX_DIGITS ? MAX_DIGITS : digits);
+        }
+
+        inline void copyExp(StochasticReal &r, double d)
+        {
+            for (int i = 0; i < SAMPLES; i++)
+                __HI(r.x[i]) = __HI(d);
+        }
+
+        inline void clearLows(StochasticReal &r)
+        {
+            for (int i = 0; i < SAMPLES; i++)
+                __LO(r.x[i]) = 0;
+        }
+    }; // namespace stochastic
+};     // namespace real
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#define HP_TYPE real::stochastic::StochasticReal
+
+#define SR_V(r) real::stochastic::load(r)
+#define SR_D(d) real::stochastic::broadcast(d)
+
+#define ADD_RR(t, l, r) real::stochastic::add(t, SR_V(l), SR_V(r))
+#define SUB_RR(t, l, r) real::stochastic::add(t, SR_V(l), -SR_V(r))
+#define MUL_RR(t, l, r) real::stochastic::mul(t, SR_V(l), SR_V(r))
+#define DIV_RR(t, l, r) real::stochastic::div(t, SR_V(l), SR_V(r))
+
+#define ADD_RD(t, l, r) real::stochastic::add(t, SR_V(l), SR_D(r))
+#define SUB_RD(t, l, r) real::stochastic::add(t, SR_V(l), -SR_D(r))
+#define SUB_DR(t, l, r) real::stochastic::add(t, SR_D(l), -SR_V(r))
+#define MUL_RD(t, l, r) real::stochastic::mul(t, SR_V(l), SR_D(r))
+#define DIV_RD(t, l, r) real::stochastic::div(t, SR_V(l), SR_D(r))
+#define DIV_DR(t, l, r) real::stochastic::div(t, SR_D(l), SR_V(r))
+
+#define ASSIGN(l,r) l = r
+#define ASSIGN_D(l,r) real::stochastic::assign(l, r)
+#define SWAP(l,r) l = r
+
+#define INIT(r, p) /*DO NOTHING*/
+#define CLEAR(r) /*DO NOTHING*/
+
+#define TO_DOUBLE(r) real::stochastic::mean(r)
+
+#define FMA(t, l, m, r) real::stochastic::fma(t, SR_V(l), SR_V(m), SR_V(r))
+#define FMS(t, l, m, r) real::stochastic::fma(t, SR_V(l), SR_V(m), -SR_V(r))
+#define FNMA(t, l, m, r) real::stochastic::fma(t, -SR_V(l), SR_V(m), SR_V(r))
+
+#if KEEP_ORIGINAL
+#define STREAM_OUT(os, r)  {\
+    std::ios_base::fmtflags old_flags = os.flags(); \
+    std::streamsize old_prec = os.precision(19); \
+    os << std::scientific; \
+    os << "[ " << std::setw(27) << TO_DOUBLE(r.shadow->shadowValue) << " ]"; \
+    os.precision(3); \
+    os << std::fixed << " (" << real::stochastic::significantDigits(r.shadow->shadowValue) << " digits)"; \
+    os.precision(19); \
+    os << std::scientific << " (original = " << r.shadow->originalValue <<")"; \
+    os.precision(old_prec); \
+    os.flags(old_flags); \
+}
+#else
+#define STREAM_OUT(os, r)  {\
+    std::ios_base::fmtflags old_flags = os.flags(); \
+    std::streamsize old_prec = os.precision(19); \
+    os << std::scientific; \
+    os << "[ " << std::setw(27) << TO_DOUBLE(r.shadow->shadowValue) << " ]"; \
+    os.precision(3); \
+    os << std::fixed << " (" << real::stochastic::significantDigits(r.shadow->shadowValue) << " digits)"; \
+    os.precision(old_prec); \
+    os.flags(old_flags); \
+}
+#endif
+
+#define LESS_RR(l,r) (TO_DOUBLE(l) < TO_DOUBLE(r))
+#define LESSEQ_RR(l,r) (TO_DOUBLE(l) <= TO_DOUBLE(r))
+#define EQUAL_RR(l,r) (TO_DOUBLE(l) == TO_DOUBLE(r))
+#define GREATER_RR(l,r) (TO_DOUBLE(l) > TO_DOUBLE(r))
+#define GREATEREQ_RR(l,r) (TO_DOUBLE(l) >= TO_DOUBLE(r))
+
+#define SR_F1(res, r, f, exact) real::stochastic::apply(res, SR_V(r), [](double a) { return f(a); }, exact)
+#define SR_F2(res, a, b, f, exact) real::stochastic::apply(res, SR_V(a), SR_V(b), [](double x, double y) { return f(x, y); }, exact)
+
+#define EXP_R(res, r) SR_F1(res, r, std::exp, false)
+#define POW_RR(res, a, b) SR_F2(res, a, b, std::pow, false)
+#define SQRT_R(res, r) real::stochastic::sqrt(res, SR_V(r))
+
+// <math.h>
+#define LOG_R(res, r) SR_F1(res, r, std::log, false)
+#define LOG10_R(res, r) SR_F1(res, r, std::log10, false)
+#define LOG2_R(res, r) SR_F1(res, r, std::log2, false)
+#define LOG1P_R(res, r) SR_F1(res, r, std::log1p, false)
+#define EXPM1_R(res, r) SR_F1(res, r, std::expm1, false)
+#define SIN_R(res, r) SR_F1(res, r, std::sin, false)
+#define COS_R(res, r) SR_F1(res, r, std::cos, false)
+#define TAN_R(res, r) SR_F1(res, r, std::tan, false)
+#define ASIN_R(res, r) SR_F1(res, r, std::asin, false)
+#define ACOS_R(res, r) SR_F1(res, r, std::acos, false)
+#define ATAN_R(res, r) SR_F1(res, r, std::atan, false)
+#define SINH_R(res, r) SR_F1(res, r, std::sinh, false)
+#define COSH_R(res, r) SR_F1(res, r, std::cosh, false)
+#define TANH_R(res, r) SR_F1(res, r, std::tanh, false)
+#define ASINH_R(res, r) SR_F1(res, r, std::asinh, false)
+#define ACOSH_R(res, r) SR_F1(res, r, std::acosh, false)
+#define ATANH_R(res, r) SR_F1(res, r, std::atanh, false)
+#define FABS_R(res, r) SR_F1(res, r, std::fabs, true)
+#define FLOOR_R(res, r) SR_F1(res, r, std::floor, true)
+#define CEIL_R(res, r) SR_F1(res, r, std::ceil, true)
+#define TRUNC_R(res, r) SR_F1(res, r, std::trunc, true)
+#define ROUND_R(res, r) SR_F1(res, r, std::round, true)
+#define CBRT_R(res, r) SR_F1(res, r, std::cbrt, false)
+#define ERF_R(res, r) SR_F1(res, r, std::erf, false)
+#define ERFC_R(res, r) SR_F1(res, r, std::erfc, false)
+#define ATAN2_RR(res, a, b) SR_F2(res, a, b, std::atan2, false)
+#define FMOD_RR(res, a, b) SR_F2(res, a, b, std::fmod, true)
+#define FMIN_RR(res, a, b) SR_F2(res, a, b, std::fmin, true)
+#define FMAX_RR(res, a, b) SR_F2(res, a, b, std::fmax, true)
+#define HYPOT_RR(res, a, b) SR_F2(res, a, b, std::hypot, false)
+
+#define COPY_EXP_D(res, d) real::stochastic::copyExp(res, d)
+#define CLEAR_LOWS(res) real::stochastic::clearLows(res)
+#endif
@@ -0,0 +1,103 @@
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+/*
+Binary error trace, written by the runtime with SHADOW_TRACE (ErrorTrace.hpp) and read by bin/easttrace
+(src/tracetool/easttrace.cpp).
+
+A trace is a FileHeader followed by blocks. A block is a BlockHeader and its payload, padded to 8 bytes, and holds
+the records of one kind column by column:
+    SAMPLES      error estimates of PCs          errors (float), seqs, pcs
+    EDGES        provenance, pc <- causing pc     errors (float), seqs, pcs, causes
+    DIVERGENCES  EAST_CONDITION mismatches        seqs, pcs
+    LOCATIONS    source location of every PC      one string per PC, written last
+The float column comes first so that it is aligned in a mapped file. The other columns are LEB128 varints, seqs
+as deltas from the previous record of the block (seqs never decrease: a seq is the number of PCs executed so far).
+A block header carries the seq and PC ranges and the largest error of its block, so that readers skip blocks, and
+blocks are self-describing: a reader walks them from header to header, and the trace of a crashed run is read up
+to its last complete block. All numbers are little endian.
+*/
+#include <stdint.h>
+#include <string.h>
+
+namespace real
+{
+    namespace trace
+    {
+        const uint32_t VERSION = 1;
+        const char FILE_MAGIC[8] = {'E', 'A', 'S', 'T', 'T', 'R', 'C', '\0'};
+        const uint32_t BLOCK_MAGIC = 0x4B4C4245; // "EBLK"
+
+        enum Kind : uint32_t
+        {
+            SAMPLES = 1,
+            EDGES = 2,
+            DIVERGENCES = 3,
+            LOCATIONS = 4
+        };
+
+        struct FileHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t headerBytes; // sizeof(FileHeader), the first block starts there
+            uint64_t startTime;   // of the run, nanoseconds since the epoch
+            uint64_t period;      // every period-th error estimate and edge is recorded
+            uint64_t reserved[4];
+        };
+        static_assert(sizeof(FileHeader) == 64, "FileHeader is 64 bytes");
+
+        struct BlockHeader
+        {
+            uint32_t magic;
+            uint32_t kind;
+            uint32_t count;        // records
+            uint32_t payloadBytes; // without the padding
+            uint64_t firstSeq;
+            uint64_t lastSeq;
+            uint64_t time;           // nanoseconds since startTime when the block was written
+            uint32_t columnBytes[4]; // in the order of the columns of the kind, unused ones are 0
+            uint32_t minPc;
+            uint32_t maxPc;
+            double maxError;
+        };
+        static_assert(sizeof(BlockHeader) == 72, "BlockHeader is 72 bytes, payloads stay 8-byte aligned");
+
+        inline uint64_t padded(uint64_t bytes)
+        {
+            return (bytes + 7) & ~(uint64_t)7;
+        }
+
+        // LEB128, at most 10 bytes
+        inline uint8_t *putVarint(uint8_t *p, uint64_t v)
+        {
+            while (v >= 0x80)
+            {
+                *p++ = (uint8_t)(v | 0x80);
+                v >>= 7;
+            }
+            *p++ = (uint8_t)v;
+            return p;
+        }
+
+        // returns nullptr past end
+        inline const uint8_t *getVarint(const uint8_t *p, const uint8_t *end, uint64_t &v)
+        {
+            v = 0;
+            for (int shift = 0; p < end && shift < 64; shift += 7)
+            {
+                uint8_t b = *p++;
+                v |= (uint64_t)(b & 0x7F) << shift;
+                if ((b & 0x80) == 0)
+                    return p;
+            }
+            return nullptr;
+        }
+
+        inline bool validHeader(const FileHeader &h)
+        {
+            return memcmp(h.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 && h.version == VERSION && h.headerBytes >= sizeof(FileHeader);
+        }
+    }; // namespace trace
+};     // namespace real
+
+#endif
@@ -0,0 +1,411 @@
+/*
+Offline queries of the binary error traces written with SHADOW_TRACE, see src/real/TraceFormat.h.
+
+    easttrace info TRACE
+    easttrace top TRACE [-k K] [-f SEQ] [-t SEQ]
+    easttrace chain TRACE [-p PC] [-d DEPTH] [-f SEQ] [-t SEQ]
+    easttrace series TRACE -p PC [-n BUCKETS] [-f SEQ] [-t SEQ]
+    easttrace divergences TRACE [-k K]
+
+top lists the K PCs (10 by default) with the largest errors, with their number of samples and mean error.
+chain follows the provenance edges from PC (the PC with the largest error by default): each step goes to the
+cause that contributed the largest total error, up to DEPTH steps (20 by default) or a PC already on the chain.
+series prints the samples of PC in BUCKETS (50 by default) equal ranges of seqs. -f and -t restrict a query to
+the seqs in [from, to], a seq being the number of PCs executed before a record.
+The trace is mapped, and blocks outside the seq range or, for series, the PC range are skipped without decoding,
+so that multi-GB traces are queried in seconds. Locations come from the last block of the trace; the trace of a
+crashed run has none, and its PCs are printed as numbers.
+*/
+#include <real/TraceFormat.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace real;
+
+struct Record
+{
+    uint64_t seq;
+    uint64_t pc;
+    uint64_t cause;
+    double error;
+};
+
+struct Trace
+{
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    const trace::FileHeader *header = nullptr;
+    std::vector<const trace::BlockHeader *> blocks;
+    std::vector<std::string> locations;
+    bool truncated = false;
+
+    ~Trace()
+    {
+        if (data != nullptr)
+            munmap((void *)data, size);
+    }
+
+    bool open(const char *file)
+    {
+        int fd = ::open(file, O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0)
+        {
+            std::cerr << "cannot open " << file << "\n";
+            return false;
+        }
+        size = st.st_size;
+        if (size < sizeof(trace::FileHeader))
+        {
+            std::cerr << file << " is not an error trace\n";
+            close(fd);
+            return false;
+        }
+        void *p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED)
+        {
+            std::cerr << "cannot map " << file << "\n";
+            return false;
+        }
+        data = (const uint8_t *)p;
+        madvise(p, size, MADV_SEQUENTIAL);
+        header = (const trace::FileHeader *)data;
+        if (!trace::validHeader(*header))
+        {
+            std::cerr << file << " is not an error trace of version " << trace::VERSION << "\n";
+            return false;
+        }
+        // walks the block headers, the payloads are only touched by queries
+        size_t offset = header->headerBytes;
+        while (offset + sizeof(trace::BlockHeader) <= size)
+        {
+            const trace::BlockHeader *h = (const trace::BlockHeader *)(data + offset);
+            size_t next = offset + sizeof(trace::BlockHeader) + trace::padded(h->payloadBytes);
+            if (h->magic != trace::BLOCK_MAGIC || next > size)
+                break;
+            if (h->kind == trace::LOCATIONS)
+                readLocations(h);
+            else
+                blocks.push_back(h);
+            offset = next;
+        }
+        truncated = offset != size;
+        return true;
+    }
+
+    const uint8_t *payload(const trace::BlockHeader *h) const
+    {
+        return (const uint8_t *)(h + 1);
+    }
+
+    // calls f(record) for the records of the block in [from, to]
+    template <typename F>
+    void decode(const trace::BlockHeader *h, uint64_t from, uint64_t to, F f) const
+    {
+        const uint8_t *p = payload(h);
+        const float *errors = nullptr;
+        int c = 0;
+        if (h->kind != trace::DIVERGENCES)
+        {
+            errors = (const float *)p;
+            p += h->columnBytes[c++];
+        }
+        const uint8_t *seqs = p, *seqsEnd = seqs + h->columnBytes[c++];
+        const uint8_t *pcs = seqsEnd, *pcsEnd = pcs + h->columnBytes[c++];
+        const uint8_t *causes = pcsEnd, *causesEnd = causes + (h->kind == trace::EDGES ? h->columnBytes[c++] : 0);
+        Record r = {0, 0, 0, 0};
+        for (uint32_t i = 0; i < h->count; i++)
+        {
+            uint64_t delta;
+            seqs = trace::getVarint(seqs, seqsEnd, delta);
+            pcs = trace::getVarint(pcs, pcsEnd, r.pc);
+            if (seqs == nullptr || pcs == nullptr)
+                return; // corrupt block
+            if (h->kind == trace::EDGES && (causes = trace::getVarint(causes, causesEnd, r.cause)) == nullptr)
+                return;
+            r.seq += delta;
+            r.error = errors != nullptr ? errors[i] : 0;
+            if (r.seq > to)
+                return;
+            if (r.seq >= from)
+                f(r);
+        }
+    }
+
+    // calls f(record) for the records of kind in [from, to], skipping blocks by their headers
+    template <typename F>
+    void scan(uint32_t kind, uint64_t from, uint64_t to, F f, uint64_t pc = ~(uint64_t)0) const
+    {
+        for (const trace::BlockHeader *h : blocks)
+        {
+            if (h->kind != kind || h->lastSeq < from || h->firstSeq > to)
+                continue;
+            if (pc != ~(uint64_t)0 && (pc < h->minPc || pc > h->maxPc))
+                continue;
+            decode(h, from, to, f);
+        }
+    }
+
+    std::string location(uint64_t pc) const
+    {
+        std::string s = "PC " + std::to_string(pc);
+        if (pc < locations.size() && !locations[pc].empty())
+            s += "\t" + locations[pc];
+        return s;
+    }
+
+private:
+    void readLocations(const trace::BlockHeader *h)
+    {
+        const uint8_t *p = payload(h), *end = p + h->payloadBytes;
+        locations.clear();
+        for (uint32_t i = 0; i < h->count && p != nullptr; i++)
+        {
+            uint64_t n;
+            p = trace::getVarint(p, end, n);
+            if (p == nullptr || n > (uint64_t)(end - p))
+                break;
+            locations.emplace_back((const char *)p, n);
+            p += n;
+        }
+    }
+};
+
+struct Options
+{
+    uint64_t k = 10;
+    uint64_t pc = ~(uint64_t)0;
+    uint64_t depth = 20;
+    uint64_t buckets = 50;
+    uint64_t from = 0;
+    uint64_t to = ~(uint64_t)0;
+};
+
+struct Stat
+{
+    uint64_t count = 0;
+    double sum = 0;
+    double max = 0;
+
+    void add(double e)
+    {
+        count++;
+        sum += e;
+        if (max < e)
+            max = e;
+    }
+};
+
+static const char *KIND_NAMES[] = {"", "samples", "edges", "divergences", "locations"};
+
+static int info(const Trace &t)
+{
+    uint64_t blocks[4] = {0}, records[4] = {0}, bytes[4] = {0};
+    uint64_t firstSeq = ~(uint64_t)0, lastSeq = 0, lastTime = 0;
+    double maxError = 0;
+    for (const trace::BlockHeader *h : t.blocks)
+    {
+        if (h->kind >= 4)
+            continue;
+        blocks[h->kind]++;
+        records[h->kind] += h->count;
+        bytes[h->kind] += sizeof(*h) + trace::padded(h->payloadBytes);
+        firstSeq = std::min<uint64_t>(firstSeq, h->firstSeq);
+        lastSeq = std::max<uint64_t>(lastSeq, h->lastSeq);
+        lastTime = std::max<uint64_t>(lastTime, h->time);
+        maxError = std::max(maxError, h->maxError);
+    }
+    std::cout << "version\t" << t.header->version << "\n"
+              << "bytes\t" << t.size << "\n"
+              << "period\t" << t.header->period << "\n"
+              << "duration\t" << lastTime / 1e9 << " s\n";
+    if (firstSeq <= lastSeq)
+        std::cout << "seqs\t" << firstSeq << " - " << lastSeq << "\n";
+    std::cout << "max error\t" << maxError << "\n"
+              << "locations\t" << t.locations.size() << "\n";
+    for (uint32_t k = trace::SAMPLES; k <= trace::DIVERGENCES; k++)
+        std::cout << KIND_NAMES[k] << "\t" << records[k] << " in " << blocks[k] << " blocks, " << bytes[k] << " bytes\n";
+    if (t.truncated)
+        std::cout << "the trace is truncated after its last complete block\n";
+    return 0;
+}
+
+static int top(const Trace &t, const Options &o)
+{
+    std::vector<Stat> stats;
+    t.scan(trace::SAMPLES, o.from, o.to, [&](const Record &r) {
+        if (r.pc >= stats.size())
+            stats.resize(r.pc + 1);
+        stats[r.pc].add(r.error);
+    });
+    std::vector<uint64_t> pcs;
+    for (uint64_t pc = 0; pc < stats.size(); pc++)
+    {
+        if (stats[pc].count != 0)
+            pcs.push_back(pc);
+    }
+    uint64_t k = std::min<uint64_t>(o.k, pcs.size());
+    std::partial_sort(pcs.begin(), pcs.begin() + k, pcs.end(), [&](uint64_t a, uint64_t b) {
+        return stats[a].max > stats[b].max;
+    });
+    std::cout << "max error\tmean error\tsamples\tsite\n";
+    for (uint64_t i = 0; i < k; i++)
+    {
+        const Stat &s = stats[pcs[i]];
+        std::cout << s.max << "\t" << s.sum / s.count << "\t" << s.count << "\t" << t.location(pcs[i]) << "\n";
+    }
+    return 0;
+}
+
+static int chain(const Trace &t, const Options &o)
+{
+    std::map<std::pair<uint64_t, uint64_t>, Stat> edges; // (pc, cause)
+    t.scan(trace::EDGES, o.from, o.to, [&](const Record &r) {
+        if (r.pc != r.cause)
+            edges[std::make_pair(r.pc, r.cause)].add(r.error);
+    });
+    uint64_t pc = o.pc;
+    if (pc == ~(uint64_t)0)
+    {
+        // the PC with the largest error
+        double max = -1;
+        t.scan(trace::SAMPLES, o.from, o.to, [&](const Record &r) {
+            if (max < r.error)
+            {
+                max = r.error;
+                pc = r.pc;
+            }
+        });
+        if (pc == ~(uint64_t)0)
+        {
+            std::cout << "no samples\n";
+            return 0;
+        }
+    }
+    std::set<uint64_t> visited = {pc};
+    std::cout << t.location(pc) << "\n";
+    for (uint64_t d = 0; d < o.depth; d++)
+    {
+        auto it = edges.lower_bound(std::make_pair(pc, (uint64_t)0));
+        auto best = edges.end();
+        for (; it != edges.end() && it->first.first == pc; ++it)
+        {
+            if (visited.count(it->first.second) == 0 && (best == edges.end() || best->second.sum < it->second.sum))
+                best = it;
+        }
+        if (best == edges.end())
+            break;
+        const Stat &s = best->second;
+        pc = best->first.second;
+        visited.insert(pc);
+        std::cout << "  <- " << t.location(pc) << "\t(max " << s.max << ", mean " << s.sum / s.count << ", " << s.count << " edges)\n";
+    }
+    return 0;
+}
+
+static int series(const Trace &t, const Options &o)
+{
+    if (o.pc == ~(uint64_t)0)
+    {
+        std::cerr << "series needs -p PC\n";
+        return 1;
+    }
+    uint64_t from = o.from, to = o.to;
+    if (to == ~(uint64_t)0)
+    {
+        to = 0;
+        for (const trace::BlockHeader *h : t.blocks)
+            to = std::max<uint64_t>(to, h->lastSeq);
+    }
+    if (to < from || o.buckets == 0)
+        return 0;
+    uint64_t width = (to - from) / o.buckets + 1;
+    std::vector<Stat> buckets(o.buckets);
+    t.scan(trace::SAMPLES, from, to, [&](const Record &r) {
+        if (r.pc == o.pc)
+            buckets[(r.seq - from) / width].add(r.error);
+    }, o.pc);
+    std::cout << t.location(o.pc) << "\n"
+              << "first seq\tsamples\tmean error\tmax error\n";
+    for (uint64_t i = 0; i < o.buckets; i++)
+    {
+        const Stat &s = buckets[i];
+        std::cout << from + i * width << "\t" << s.count << "\t" << (s.count ? s.sum / s.count : 0) << "\t" << s.max << "\n";
+    }
+    return 0;
+}
+
+static int divergences(const Trace &t, const Options &o)
+{
+    std::map<uint64_t, std::pair<uint64_t, uint64_t>> sites; // pc -> (count, first seq)
+    t.scan(trace::DIVERGENCES, o.from, o.to, [&](const Record &r) {
+        auto it = sites.emplace(r.pc, std::make_pair((uint64_t)0, r.seq)).first;
+        it->second.first++;
+    });
+    std::vector<std::pair<uint64_t, uint64_t>> order; // (count, pc)
+    for (auto &s : sites)
+        order.emplace_back(s.second.first, s.first);
+    std::sort(order.rbegin(), order.rend());
+    std::cout << "divergences\tfirst seq\tsite (the last PC before the branch)\n";
+    for (uint64_t i = 0; i < order.size() && i < o.k; i++)
+        std::cout << order[i].first << "\t" << sites[order[i].second].second << "\t" << t.location(order[i].second) << "\n";
+    return 0;
+}
+
+static int usage()
+{
+    std::cerr << "usage: easttrace info|top|chain|series|divergences TRACE [-k K] [-p PC] [-d DEPTH] [-n BUCKETS] [-f SEQ] [-t SEQ]\n";
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+        return usage();
+    std::string command = argv[1];
+    Options o;
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        std::string opt = argv[i];
+        uint64_t v = strtoull(argv[i + 1], nullptr, 0);
+        if (opt == "-k")
+            o.k = v;
+        else if (opt == "-p")
+            o.pc = v;
+        else if (opt == "-d")
+            o.depth = v;
+        else if (opt == "-n")
+            o.buckets = v;
+        else if (opt == "-f")
+            o.from = v;
+        else if (opt == "-t")
+            o.to = v;
+        else
+            return usage();
+    }
+
+    Trace t;
+    if (!t.open(argv[2]))
+        return 1;
+    if (command == "info")
+        return info(t);
+    if (command == "top")
+        return top(t, o);
+    if (command == "chain")
+        return chain(t, o);
+    if (command == "series")
+        return series(t, o);
+    if (command == "divergences")
+        return divergences(t, o);
+    return usage();
+}
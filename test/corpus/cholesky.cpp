@@ -0,0 +1,48 @@
+// Cholesky factorization of a symmetric positive definite matrix
+#include <stdio.h>
+#include <math.h>
+
+#define N 80
+
+double A[N][N];
+double L[N][N];
+
+int main(int argc, char *argv[])
+{
+	double trace = 0.0;
+	for (int rep = 0; rep < 8; rep++)
+	{
+		for (int i = 0; i < N; i++)
+		{
+			for (int j = 0; j < N; j++)
+			{
+				A[i][j] = exp(-fabs(i - j) * 0.5) + (i == j ? 1e-3 * (rep + 1) : 0.0);
+				L[i][j] = 0.0;
+			}
+		}
+		for (int j = 0; j < N; j++)
+		{
+			double s = A[j][j];
+			for (int k = 0; k < j; k++)
+			{
+				s = s - L[j][k] * L[j][k];
+			}
+			L[j][j] = sqrt(s);
+			for (int i = j + 1; i < N; i++)
+			{
+				double t = A[i][j];
+				for (int k = 0; k < j; k++)
+				{
+					t = t - L[i][k] * L[j][k];
+				}
+				L[i][j] = t / L[j][j];
+			}
+		}
+		for (int i = 0; i < N; i++)
+		{
+			trace = trace + L[i][i];
+		}
+	}
+	printf("%.17g\n", trace);
+	return 0;
+}
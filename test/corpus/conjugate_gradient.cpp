@@ -0,0 +1,66 @@
+// conjugate gradients on the 1D Poisson matrix tridiag(-1, 2, -1)
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define N 400
+
+void apply(const double *x, double *y)
+{
+	for (int i = 0; i < N; i++)
+	{
+		double l = i > 0 ? x[i - 1] : 0.0;
+		double r = i < N - 1 ? x[i + 1] : 0.0;
+		y[i] = 2.0 * x[i] - l - r;
+	}
+}
+
+double dot(const double *x, const double *y)
+{
+	double s = 0.0;
+	for (int i = 0; i < N; i++)
+	{
+		s = s + x[i] * y[i];
+	}
+	return s;
+}
+
+int main(int argc, char *argv[])
+{
+	double *x = (double *)malloc(N * sizeof(double));
+	double *r = (double *)malloc(N * sizeof(double));
+	double *p = (double *)malloc(N * sizeof(double));
+	double *q = (double *)malloc(N * sizeof(double));
+	for (int i = 0; i < N; i++)
+	{
+		x[i] = 0.0;
+		r[i] = 1.0;
+		p[i] = 1.0;
+	}
+	double rr = dot(r, r);
+	int it = 0;
+	while (it < N && rr > 1e-20)
+	{
+		apply(p, q);
+		double alpha = rr / dot(p, q);
+		for (int i = 0; i < N; i++)
+		{
+			x[i] = x[i] + alpha * p[i];
+			r[i] = r[i] - alpha * q[i];
+		}
+		double rr2 = dot(r, r);
+		double beta = rr2 / rr;
+		for (int i = 0; i < N; i++)
+		{
+			p[i] = r[i] + beta * p[i];
+		}
+		rr = rr2;
+		it++;
+	}
+	printf("%d %.17g\n", it, x[N / 2]);
+	free(x);
+	free(r);
+	free(p);
+	free(q);
+	return 0;
+}
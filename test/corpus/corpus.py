@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""
+End-to-end overhead of shadow execution over the kernels in test/corpus, see `make corpus`.
+
+Each kernel goes through the same pipeline as `make testins` (clang-tidy, sourceAnnotation, the
+normalization passes, turnFpArith/turnFpStruct and passClean) into test/derived/corpus/<kernel>/.
+The original and the instrumented sources are built at -O2 and run, and the report gives the
+slowdown, the peak RSS of both runs and the shadow memory (their difference).
+
+    corpus.py [options] [kernel.cpp ...] -- <flags of the clang tools, EXTRA_FLAGS of the makefile>
+
+A kernel regresses when its slowdown or its shadow memory exceeds the baseline (--baseline,
+test/corpus/baseline.csv by default) by more than the tolerance, and the exit status is 1. A missing
+baseline, or a kernel without a row in it, fails the same way, since nothing would be checked.
+--update-baseline records the results instead, see `make corpus-baseline`.
+"""
+import argparse
+import csv
+import glob
+import os
+import shutil
+import subprocess
+import sys
+import time
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+ANNOTATIONS = ["sourceAnnotation"]
+PASSES = ["passZero", "passOne", "passTwo", "passThree", "passClean"]
+TRANSFORMERS = ["turnFpArith", "turnFpStruct"]
+FIELDS = ["kernel", "port", "mode", "native_s", "shadow_s", "slowdown", "native_rss_kb", "shadow_rss_kb", "shadow_kb"]
+
+
+def run(cmd, cwd=None, quiet=True):
+    out = subprocess.DEVNULL if quiet else None
+    try:
+        res = subprocess.run(cmd, cwd=cwd, stdout=out, stderr=out)
+    except OSError as e:
+        raise RuntimeError("%s: %s" % (cmd[0], e.strerror))
+    if res.returncode != 0:
+        raise RuntimeError("failed: " + " ".join(cmd))
+
+
+def instrument(args, kernel, work, tool_flags):
+    """the steps of `make testnorm testins` on one kernel, returns the instrumented source"""
+    src = os.path.join(work, os.path.basename(kernel))
+    shutil.copy(kernel, src)
+    run([args.clang_tidy, src, "-fix", "-checks=readability-braces-around-statements"] + tool_flags)
+    for n in ANNOTATIONS:
+        run([os.path.join(args.tools, n), src] + tool_flags, cwd=work)  # writes RunConfigure.h into work
+    for n in PASSES:
+        run([os.path.join(args.tools, n), src] + tool_flags)
+    for n in TRANSFORMERS:
+        run([os.path.join(args.tools, n)] + args.trans_opts.split() + [src] + tool_flags)
+    run([os.path.join(args.tools, "passClean"), src] + tool_flags)
+    return src
+
+
+def build(args, kernel, instrumented, work):
+    native = os.path.join(work, "native")
+    shadow = os.path.join(work, "shadow")
+    run([args.cxx, "-O2", "-w", "-std=c++17", kernel, "-o", native, "-lm"])
+    flags = ["-O2", "-w", "-std=c++17", "-I" + work, "-I" + os.path.join(ROOT, "src"),
+             "-I" + os.path.join(ROOT, "src/qd/include"),
+             "-DPORT_TYPE=%d" % args.port, "-DTRANCKING_MODE=%d" % args.mode]
+    libs = ["-lquadmath"] + (["-lmpfr", "-lgmp"] if args.port == 0 else [])
+    run([args.cxx] + flags + [instrumented] + args.qd_objects + ["-o", shadow] + libs)
+    return native, shadow
+
+
+def measure(binary, repeats):
+    """best wall time in seconds and largest peak RSS in KB of `repeats` runs
+    (the RSS of a forked child starts at that of this script, about 10 MB, shadow_kb cancels it out)"""
+    best, rss = None, 0
+    for _ in range(repeats):
+        t0 = time.perf_counter()
+        proc = subprocess.Popen([binary], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        _, status, usage = os.wait4(proc.pid, 0)
+        t = time.perf_counter() - t0
+        if status != 0:
+            raise RuntimeError("%s exited with %d" % (binary, status))
+        best = t if best is None else min(best, t)
+        maxrss = usage.ru_maxrss // 1024 if sys.platform == "darwin" else usage.ru_maxrss  # bytes on macOS
+        rss = max(rss, maxrss)
+    return best, rss
+
+
+def compare(args, results):
+    if not os.path.exists(args.baseline):
+        print("[CORPUS]\tno baseline %s, make corpus-baseline records one" % args.baseline)
+        return 1
+    with open(args.baseline) as f:
+        baseline = {(r["kernel"], r["port"], r["mode"]): r for r in csv.DictReader(f)}
+    regressions = 0
+    for r in results:
+        b = baseline.get((r["kernel"], str(r["port"]), str(r["mode"])))
+        if b is None:
+            print("[CORPUS]\tno baseline of %s on port %s, mode %s" % (r["kernel"], r["port"], r["mode"]))
+            regressions += 1
+            continue
+        checks = [("slowdown", r["slowdown"], float(b["slowdown"]), args.tolerance),
+                  ("shadow memory", r["shadow_kb"], float(b["shadow_kb"]), args.memory_tolerance)]
+        for what, now, was, tolerance in checks:
+            if was > 0 and now > was * (1 + tolerance):
+                print("[CORPUS]\tREGRESSION %s: %s %.4g, baseline %.4g (+%.1f%%)"
+                      % (r["kernel"], what, now, was, (now / was - 1) * 100))
+                regressions += 1
+    return regressions
+
+
+def write(file, results):
+    with open(file, "w", newline="") as f:
+        w = csv.DictWriter(f, fieldnames=FIELDS)
+        w.writeheader()
+        w.writerows(results)
+
+
+def update(file, results):
+    """replaces the rows of the measured kernel, port and mode combinations"""
+    rows = []
+    if os.path.exists(file):
+        with open(file) as f:
+            rows = list(csv.DictReader(f))
+    measured = {(r["kernel"], str(r["port"]), str(r["mode"])) for r in results}
+    rows = [r for r in rows if (r["kernel"], r["port"], r["mode"]) not in measured]
+    write(file, rows + results)
+
+
+def main():
+    argv = sys.argv[1:]
+    tool_flags = []
+    if "--" in argv:
+        i = argv.index("--")
+        argv, tool_flags = argv[:i], argv[i:]  # the clang tools take "file -- flags"
+        # sourceAnnotation runs in the work directory, so that it does not overwrite ./RunConfigure.h
+        tool_flags = ["-I" + os.path.abspath(f[2:]) if f.startswith("-I") else f for f in tool_flags]
+    p = argparse.ArgumentParser(description="shadow execution overhead over a kernel corpus")
+    p.add_argument("kernels", nargs="*")
+    p.add_argument("--tools", default=os.path.join(ROOT, "bin"), help="directory of the pass binaries")
+    p.add_argument("--clang-tidy", default="clang-tidy")
+    p.add_argument("--trans-opts", default="", help="extra options of the instrumentation tools")
+    p.add_argument("--cxx", default="clang++")
+    p.add_argument("--qd-objects", nargs="*", default=[], help="objects of the qd library, for DD_PORT")
+    p.add_argument("--port", type=int, default=1)
+    p.add_argument("--mode", type=int, default=3)
+    p.add_argument("--repeats", type=int, default=3)
+    p.add_argument("--work", default=os.path.join(ROOT, "test/derived/corpus"))
+    p.add_argument("--baseline", default=os.path.join(ROOT, "test/corpus/baseline.csv"))
+    p.add_argument("--update-baseline", action="store_true")
+    p.add_argument("--tolerance", type=float, default=0.25, help="of the slowdown")
+    p.add_argument("--memory-tolerance", type=float, default=0.25, help="of the shadow memory")
+    args = p.parse_args(argv)
+
+    kernels = [os.path.abspath(k) for k in args.kernels] or sorted(glob.glob(os.path.join(ROOT, "test/corpus/*.cpp")))
+    results, failures = [], 0
+    print("%-24s %10s %10s %9s %12s %12s" % ("kernel", "native s", "shadow s", "slowdown", "native KB", "shadow KB"))
+    for kernel in kernels:
+        name = os.path.splitext(os.path.basename(kernel))[0]
+        work = os.path.join(args.work, name)
+        shutil.rmtree(work, ignore_errors=True)
+        os.makedirs(work)
+        try:
+            instrumented = instrument(args, kernel, work, tool_flags)
+            native, shadow = build(args, kernel, instrumented, work)
+            nt, nrss = measure(native, args.repeats)
+            st, srss = measure(shadow, args.repeats)
+        except RuntimeError as e:
+            print("%-24s %s" % (name, e))
+            failures += 1
+            continue
+        r = {"kernel": name, "port": args.port, "mode": args.mode, "native_s": round(nt, 6),
+             "shadow_s": round(st, 6), "slowdown": round(st / nt, 3), "native_rss_kb": nrss,
+             "shadow_rss_kb": srss, "shadow_kb": max(srss - nrss, 0)}
+        results.append(r)
+        print("%-24s %10.4f %10.4f %8.1fx %12d %12d" % (name, nt, st, r["slowdown"], nrss, srss))
+
+    write(os.path.join(args.work, "results.csv"), results)
+    if args.update_baseline:
+        update(args.baseline, results)
+        return 1 if failures else 0
+    regressions = compare(args, results)
+    return 1 if failures or regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,36 @@
+// dot products of nearly orthogonal vectors, where cancellation dominates
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+double dot(const double *x, const double *y, int n)
+{
+	double s = 0.0;
+	for (int i = 0; i < n; i++)
+	{
+		s = s + x[i] * y[i];
+	}
+	return s;
+}
+
+int main(int argc, char *argv[])
+{
+	int n = 4096;
+	double *x = (double *)malloc(n * sizeof(double));
+	double *y = (double *)malloc(n * sizeof(double));
+	for (int i = 0; i < n; i++)
+	{
+		x[i] = cos(i * 0.01) + 1e-9 * i;
+		y[i] = (i % 2 == 0 ? 1.0 : -1.0) * cos(i * 0.01);
+	}
+	double sum = 0.0;
+	for (int r = 0; r < 50; r++)
+	{
+		sum = sum + dot(x, y, n);
+		x[r] = x[r] + 1e-12;
+	}
+	printf("%.17g\n", sum);
+	free(x);
+	free(y);
+	return 0;
+}
@@ -0,0 +1,17 @@
+// exp(x) - 1 and log(1 + x) near zero, naive formulas against expm1 and log1p
+#include <stdio.h>
+#include <math.h>
+
+int main(int argc, char *argv[])
+{
+	double e1 = 0.0;
+	double e2 = 0.0;
+	for (int i = 1; i <= 100000; i++)
+	{
+		double x = i * 1e-12;
+		e1 = e1 + fabs((exp(x) - 1.0) - expm1(x)) / expm1(x);
+		e2 = e2 + fabs(log(1.0 + x) - log1p(x)) / log1p(x);
+	}
+	printf("%.17g %.17g\n", e1, e2);
+	return 0;
+}
@@ -0,0 +1,26 @@
+// FPBench carbonGas: volume of carbon dioxide from the van der Waals equation
+#include <stdio.h>
+#include <math.h>
+
+double carbonGas(double v)
+{
+	double p = 3.5e7;
+	double a = 0.401;
+	double b = 42.7e-6;
+	double t = 300.0;
+	double n = 1000.0;
+	double k = 1.3806503e-23;
+	return (p + a * (n / v) * (n / v)) * (v - n * b) - k * n * t;
+}
+
+int main(int argc, char *argv[])
+{
+	double sum = 0.0;
+	for (int i = 0; i < 200000; i++)
+	{
+		double v = 0.1 + i * 2.0e-6;
+		sum = sum + carbonGas(v);
+	}
+	printf("%.17g\n", sum);
+	return 0;
+}
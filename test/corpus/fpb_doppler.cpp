@@ -0,0 +1,26 @@
+// FPBench doppler1: frequency shift of a moving source, over a grid of inputs
+#include <stdio.h>
+#include <math.h>
+
+double doppler(double u, double v, double T)
+{
+	double t1 = 331.4 + 0.6 * T;
+	return (-t1 * v) / ((t1 + u) * (t1 + u));
+}
+
+int main(int argc, char *argv[])
+{
+	double sum = 0.0;
+	for (int i = 0; i < 400; i++)
+	{
+		for (int j = 0; j < 400; j++)
+		{
+			double u = -100.0 + i * 0.5;
+			double v = 20.0 + j * 50.0;
+			double T = -30.0 + (i + j) * 0.125;
+			sum = sum + doppler(u, v, T);
+		}
+	}
+	printf("%.17g\n", sum);
+	return 0;
+}
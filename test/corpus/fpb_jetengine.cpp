@@ -0,0 +1,28 @@
+// FPBench jetEngine: a controller of a jet engine
+#include <stdio.h>
+#include <math.h>
+
+double jetEngine(double x1, double x2)
+{
+	double t = 3.0 * x1 * x1 + 2.0 * x2 - x1;
+	double t2 = x1 * x1 + 1.0;
+	double s = t / t2;
+	double s2 = s - 3.0;
+	return x1 + ((2.0 * x1 * s * s2 + x1 * x1 * (4.0 * s - 6.0)) * t2 + 3.0 * x1 * x1 * s + x1 * x1 * x1 + x1 + 3.0 * ((3.0 * x1 * x1 - 2.0 * x2 - x1) / t2));
+}
+
+int main(int argc, char *argv[])
+{
+	double sum = 0.0;
+	for (int i = 0; i < 400; i++)
+	{
+		for (int j = 0; j < 400; j++)
+		{
+			double x1 = -5.0 + i * 0.025;
+			double x2 = -20.0 + j * 0.1;
+			sum = sum + jetEngine(x1, x2);
+		}
+	}
+	printf("%.17g\n", sum);
+	return 0;
+}
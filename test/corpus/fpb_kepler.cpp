@@ -0,0 +1,37 @@
+// FPBench kepler0 and kepler1: polynomials from the Flyspeck project
+#include <stdio.h>
+#include <math.h>
+
+double kepler0(double x1, double x2, double x3, double x4, double x5, double x6)
+{
+	return x2 * x5 + x3 * x6 - x2 * x3 - x5 * x6 + x1 * (-x1 + x2 + x3 - x4 + x5 + x6);
+}
+
+double kepler1(double x1, double x2, double x3, double x4)
+{
+	return x1 * x4 * (-x1 + x2 + x3 - x4) + x2 * (x1 - x2 + x3 + x4) + x3 * (x1 + x2 - x3 + x4) - x2 * x3 * x4 - x1 * x3 - x1 * x2 - x4;
+}
+
+int main(int argc, char *argv[])
+{
+	double sum = 0.0;
+	for (int i = 0; i < 20; i++)
+	{
+		for (int j = 0; j < 20; j++)
+		{
+			for (int k = 0; k < 20; k++)
+			{
+				for (int l = 0; l < 20; l++)
+				{
+					double x1 = 4.0 + i * 0.1259;
+					double x2 = 4.0 + j * 0.1259;
+					double x3 = 4.0 + k * 0.1259;
+					double x4 = 4.0 + l * 0.1259;
+					sum = sum + kepler0(x1, x2, x3, x4, x2, x1) + kepler1(x1, x2, x3, x4);
+				}
+			}
+		}
+	}
+	printf("%.17g\n", sum);
+	return 0;
+}
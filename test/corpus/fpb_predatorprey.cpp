@@ -0,0 +1,22 @@
+// FPBench predatorPrey: a predator-prey population model
+#include <stdio.h>
+#include <math.h>
+
+double predatorPrey(double x)
+{
+	double r = 4.0;
+	double K = 1.11;
+	return (r * x * x) / (1.0 + (x / K) * (x / K));
+}
+
+int main(int argc, char *argv[])
+{
+	double sum = 0.0;
+	for (int i = 0; i < 200000; i++)
+	{
+		double x = 0.1 + i * 1.5e-6;
+		sum = sum + predatorPrey(x);
+	}
+	printf("%.17g\n", sum);
+	return 0;
+}
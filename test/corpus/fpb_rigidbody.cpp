@@ -0,0 +1,34 @@
+// FPBench rigidBody1 and rigidBody2: polynomials of a rigid body model
+#include <stdio.h>
+#include <math.h>
+
+double rigidBody1(double x1, double x2, double x3)
+{
+	return -x1 * x2 - 2.0 * x2 * x3 - x1 - x3;
+}
+
+double rigidBody2(double x1, double x2, double x3)
+{
+	return 2.0 * x1 * x2 * x3 + 3.0 * x3 * x3 - x2 * x1 * x2 * x3 + 3.0 * x3 * x3 - x2;
+}
+
+int main(int argc, char *argv[])
+{
+	double s1 = 0.0, s2 = 0.0;
+	for (int i = 0; i < 60; i++)
+	{
+		for (int j = 0; j < 60; j++)
+		{
+			for (int k = 0; k < 60; k++)
+			{
+				double x1 = -15.0 + i * 0.5;
+				double x2 = -15.0 + j * 0.5;
+				double x3 = -15.0 + k * 0.5;
+				s1 = s1 + rigidBody1(x1, x2, x3);
+				s2 = s2 + rigidBody2(x1, x2, x3);
+			}
+		}
+	}
+	printf("%.17g %.17g\n", s1, s2);
+	return 0;
+}
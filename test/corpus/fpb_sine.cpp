@@ -0,0 +1,25 @@
+// FPBench sine and sineOrder3: polynomial approximations of sin
+#include <stdio.h>
+#include <math.h>
+
+double sine(double x)
+{
+	return x - (x * x * x) / 6.0 + (x * x * x * x * x) / 120.0 - (x * x * x * x * x * x * x) / 5040.0;
+}
+
+double sineOrder3(double x)
+{
+	return 0.954929658551372 * x - 0.12900613773279798 * (x * x * x);
+}
+
+int main(int argc, char *argv[])
+{
+	double err = 0.0;
+	for (int i = 0; i < 100000; i++)
+	{
+		double x = -1.57079632679 + i * 3.14159265358e-5;
+		err = err + fabs(sine(x) - sin(x)) + fabs(sineOrder3(x) - sin(x));
+	}
+	printf("%.17g\n", err);
+	return 0;
+}
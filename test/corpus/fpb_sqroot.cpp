@@ -0,0 +1,20 @@
+// FPBench sqroot: a Taylor polynomial of sqrt(1 + x)
+#include <stdio.h>
+#include <math.h>
+
+double sqroot(double x)
+{
+	return 1.0 + 0.5 * x - 0.125 * x * x + 0.0625 * x * x * x - 0.0390625 * x * x * x * x;
+}
+
+int main(int argc, char *argv[])
+{
+	double err = 0.0;
+	for (int i = 0; i < 200000; i++)
+	{
+		double x = i * 5.0e-6;
+		err = err + fabs(sqroot(x) - sqrt(1.0 + x));
+	}
+	printf("%.17g\n", err);
+	return 0;
+}
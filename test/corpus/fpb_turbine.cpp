@@ -0,0 +1,38 @@
+// FPBench turbine1, turbine2 and turbine3: stresses of a rotating turbine blade
+#include <stdio.h>
+#include <math.h>
+
+double turbine1(double v, double w, double r)
+{
+	return 3.0 + 2.0 / (r * r) - 0.125 * (3.0 - 2.0 * v) * (w * w * r * r) / (1.0 - v) - 4.5;
+}
+
+double turbine2(double v, double w, double r)
+{
+	return 6.0 * v - 0.5 * v * (w * w * r * r) / (1.0 - v) - 2.5;
+}
+
+double turbine3(double v, double w, double r)
+{
+	return 3.0 - 2.0 / (r * r) - 0.125 * (1.0 + 2.0 * v) * (w * w * r * r) / (1.0 - v) - 0.5;
+}
+
+int main(int argc, char *argv[])
+{
+	double sum = 0.0;
+	for (int i = 0; i < 50; i++)
+	{
+		for (int j = 0; j < 50; j++)
+		{
+			for (int k = 0; k < 50; k++)
+			{
+				double v = -4.5 + i * 0.08;
+				double w = 0.4 + j * 0.01;
+				double r = 3.8 + k * 0.08;
+				sum = sum + turbine1(v, w, r) + turbine2(v, w, r) + turbine3(v, w, r);
+			}
+		}
+	}
+	printf("%.17g\n", sum);
+	return 0;
+}
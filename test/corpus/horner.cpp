@@ -0,0 +1,26 @@
+// Horner evaluation of the expanded (x - 2)^9 near its root, a classic ill-conditioned polynomial
+#include <stdio.h>
+#include <math.h>
+
+double horner(const double *c, int n, double x)
+{
+	double r = c[n];
+	for (int i = n - 1; i >= 0; i--)
+	{
+		r = r * x + c[i];
+	}
+	return r;
+}
+
+int main(int argc, char *argv[])
+{
+	double c[10] = {-512.0, 2304.0, -4608.0, 5376.0, -4032.0, 2016.0, -672.0, 144.0, -18.0, 1.0};
+	double sum = 0.0;
+	for (int i = 0; i < 100000; i++)
+	{
+		double x = 1.92 + i * 1.6e-6;
+		sum = sum + fabs(horner(c, 9, x));
+	}
+	printf("%.17g\n", sum);
+	return 0;
+}
@@ -0,0 +1,19 @@
+// iterations of the chaotic logistic map, a worst case for error accumulation
+#include <stdio.h>
+#include <math.h>
+
+int main(int argc, char *argv[])
+{
+	double sum = 0.0;
+	for (int s = 0; s < 100; s++)
+	{
+		double x = 0.1 + s * 0.007;
+		for (int i = 0; i < 2000; i++)
+		{
+			x = 3.9 * x * (1.0 - x);
+		}
+		sum = sum + x;
+	}
+	printf("%.17g\n", sum);
+	return 0;
+}
@@ -0,0 +1,93 @@
+// LU decomposition with partial pivoting of a Hilbert-like matrix, and the solution of Ax = b
+#include <stdio.h>
+#include <math.h>
+
+#define N 60
+
+double A[N][N];
+double b[N];
+double x[N];
+int p[N];
+
+void lu()
+{
+	for (int i = 0; i < N; i++)
+	{
+		p[i] = i;
+	}
+	for (int k = 0; k < N; k++)
+	{
+		int piv = k;
+		for (int i = k + 1; i < N; i++)
+		{
+			if (fabs(A[i][k]) > fabs(A[piv][k]))
+			{
+				piv = i;
+			}
+		}
+		if (piv != k)
+		{
+			for (int j = 0; j < N; j++)
+			{
+				double t = A[k][j];
+				A[k][j] = A[piv][j];
+				A[piv][j] = t;
+			}
+			int t = p[k];
+			p[k] = p[piv];
+			p[piv] = t;
+		}
+		for (int i = k + 1; i < N; i++)
+		{
+			A[i][k] = A[i][k] / A[k][k];
+			for (int j = k + 1; j < N; j++)
+			{
+				A[i][j] = A[i][j] - A[i][k] * A[k][j];
+			}
+		}
+	}
+}
+
+void solve()
+{
+	for (int i = 0; i < N; i++)
+	{
+		double s = b[p[i]];
+		for (int j = 0; j < i; j++)
+		{
+			s = s - A[i][j] * x[j];
+		}
+		x[i] = s;
+	}
+	for (int i = N - 1; i >= 0; i--)
+	{
+		double s = x[i];
+		for (int j = i + 1; j < N; j++)
+		{
+			s = s - A[i][j] * x[j];
+		}
+		x[i] = s / A[i][i];
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	double r = 0.0;
+	for (int rep = 0; rep < 10; rep++)
+	{
+		for (int i = 0; i < N; i++)
+		{
+			b[i] = 0.0;
+			for (int j = 0; j < N; j++)
+			{
+				A[i][j] = 1.0 / (i + j + 1.0) + (i == j ? 0.1 * (rep + 1) : 0.0);
+				b[i] = b[i] + A[i][j];
+			}
+		}
+		lu();
+		solve();
+		r = r + x[0] + x[N - 1];
+	}
+	printf("%.17g\n", r);
+	return 0;
+}
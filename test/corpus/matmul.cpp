@@ -0,0 +1,45 @@
+// dense matrix multiplication
+#include <stdio.h>
+#include <math.h>
+
+#define N 64
+
+double A[N][N];
+double B[N][N];
+double C[N][N];
+
+int main(int argc, char *argv[])
+{
+	for (int i = 0; i < N; i++)
+	{
+		for (int j = 0; j < N; j++)
+		{
+			A[i][j] = sin(i + 0.5 * j);
+			B[i][j] = cos(0.5 * i - j);
+		}
+	}
+	for (int rep = 0; rep < 2; rep++)
+	{
+		for (int i = 0; i < N; i++)
+		{
+			for (int j = 0; j < N; j++)
+			{
+				double s = 0.0;
+				for (int k = 0; k < N; k++)
+				{
+					s = s + A[i][k] * B[k][j];
+				}
+				C[i][j] = s;
+			}
+		}
+		for (int i = 0; i < N; i++)
+		{
+			for (int j = 0; j < N; j++)
+			{
+				A[i][j] = C[i][j] / N;
+			}
+		}
+	}
+	printf("%.17g\n", C[N / 2][N / 3]);
+	return 0;
+}
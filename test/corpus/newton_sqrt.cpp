@@ -0,0 +1,25 @@
+// Newton iterations for square roots, as in the commented example of test/test.cpp
+#include <stdio.h>
+#include <math.h>
+
+double newton(double a)
+{
+	double x = a > 1.0 ? a : 1.0;
+	for (int i = 0; i < 30; i++)
+	{
+		x = 0.5 * (x + a / x);
+	}
+	return x;
+}
+
+int main(int argc, char *argv[])
+{
+	double err = 0.0;
+	for (int i = 1; i <= 20000; i++)
+	{
+		double a = i * 0.37;
+		err = err + fabs(newton(a) * newton(a) - a);
+	}
+	printf("%.17g\n", err);
+	return 0;
+}
@@ -0,0 +1,19 @@
+// forward Euler integration of the logistic equation and of a stiff decay
+#include <stdio.h>
+#include <math.h>
+
+int main(int argc, char *argv[])
+{
+	double y = 0.01;
+	double z = 1.0;
+	double h = 1e-5;
+	double r = 3.0;
+	double k = -50.0;
+	for (int i = 0; i < 300000; i++)
+	{
+		y = y + h * r * y * (1.0 - y);
+		z = z + h * k * (z - cos(i * h));
+	}
+	printf("%.17g %.17g\n", y, z);
+	return 0;
+}
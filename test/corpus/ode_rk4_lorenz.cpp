@@ -0,0 +1,42 @@
+// classical Runge-Kutta integration of the chaotic Lorenz system
+#include <stdio.h>
+#include <math.h>
+
+void lorenz(const double *s, double *ds)
+{
+	ds[0] = 10.0 * (s[1] - s[0]);
+	ds[1] = s[0] * (28.0 - s[2]) - s[1];
+	ds[2] = s[0] * s[1] - 8.0 / 3.0 * s[2];
+}
+
+int main(int argc, char *argv[])
+{
+	double s[3] = {1.0, 1.0, 1.0};
+	double k1[3], k2[3], k3[3], k4[3], t[3];
+	double h = 1e-3;
+	for (int n = 0; n < 20000; n++)
+	{
+		lorenz(s, k1);
+		for (int i = 0; i < 3; i++)
+		{
+			t[i] = s[i] + 0.5 * h * k1[i];
+		}
+		lorenz(t, k2);
+		for (int i = 0; i < 3; i++)
+		{
+			t[i] = s[i] + 0.5 * h * k2[i];
+		}
+		lorenz(t, k3);
+		for (int i = 0; i < 3; i++)
+		{
+			t[i] = s[i] + h * k3[i];
+		}
+		lorenz(t, k4);
+		for (int i = 0; i < 3; i++)
+		{
+			s[i] = s[i] + h / 6.0 * (k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + k4[i]);
+		}
+	}
+	printf("%.17g %.17g %.17g\n", s[0], s[1], s[2]);
+	return 0;
+}
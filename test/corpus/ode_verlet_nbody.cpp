@@ -0,0 +1,75 @@
+// velocity Verlet integration of a small gravitational n-body system
+#include <stdio.h>
+#include <math.h>
+
+#define BODIES 5
+
+double x[BODIES][3];
+double v[BODIES][3];
+double f[BODIES][3];
+double m[BODIES];
+
+void forces()
+{
+	for (int i = 0; i < BODIES; i++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			f[i][k] = 0.0;
+		}
+	}
+	for (int i = 0; i < BODIES; i++)
+	{
+		for (int j = i + 1; j < BODIES; j++)
+		{
+			double dx = x[j][0] - x[i][0];
+			double dy = x[j][1] - x[i][1];
+			double dz = x[j][2] - x[i][2];
+			double r2 = dx * dx + dy * dy + dz * dz + 1e-6;
+			double inv = m[i] * m[j] / (r2 * sqrt(r2));
+			f[i][0] = f[i][0] + inv * dx;
+			f[i][1] = f[i][1] + inv * dy;
+			f[i][2] = f[i][2] + inv * dz;
+			f[j][0] = f[j][0] - inv * dx;
+			f[j][1] = f[j][1] - inv * dy;
+			f[j][2] = f[j][2] - inv * dz;
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	for (int i = 0; i < BODIES; i++)
+	{
+		m[i] = 1.0 / (i + 1);
+		x[i][0] = cos(i * 1.3);
+		x[i][1] = sin(i * 1.3);
+		x[i][2] = 0.1 * i;
+		v[i][0] = -0.3 * sin(i * 1.3);
+		v[i][1] = 0.3 * cos(i * 1.3);
+		v[i][2] = 0.0;
+	}
+	double h = 1e-3;
+	forces();
+	for (int n = 0; n < 5000; n++)
+	{
+		for (int i = 0; i < BODIES; i++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				v[i][k] = v[i][k] + 0.5 * h * f[i][k] / m[i];
+				x[i][k] = x[i][k] + h * v[i][k];
+			}
+		}
+		forces();
+		for (int i = 0; i < BODIES; i++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				v[i][k] = v[i][k] + 0.5 * h * f[i][k] / m[i];
+			}
+		}
+	}
+	printf("%.17g %.17g %.17g\n", x[0][0], x[0][1], x[0][2]);
+	return 0;
+}
@@ -0,0 +1,21 @@
+// roots of quadratics with the textbook formula and with the stable formula, as test/test.cpp
+#include <stdio.h>
+#include <math.h>
+
+int main(int argc, char *argv[])
+{
+	double naive = 0.0;
+	double stable = 0.0;
+	for (int i = 1; i <= 200000; i++)
+	{
+		double a = 1.0 / 3;
+		double b = (2.0 + i * 1e-6) / 3;
+		double c = 1.0 / 3 - i * 1e-12;
+		double sq = sqrt(b * b - 4 * a * c);
+		naive = naive + (-b + sq) / (2 * a);
+		double q = -0.5 * (b + sq);
+		stable = stable + c / q;
+	}
+	printf("%.17g %.17g\n", naive, stable);
+	return 0;
+}
@@ -0,0 +1,30 @@
+// composite Simpson integration of a smooth and of an oscillatory integrand
+#include <stdio.h>
+#include <math.h>
+
+double f(double x)
+{
+	return exp(-x * x) + sin(50.0 * x) / (1.0 + x);
+}
+
+double simpson(double a, double b, int n)
+{
+	double h = (b - a) / n;
+	double s = f(a) + f(b);
+	for (int i = 1; i < n; i++)
+	{
+		s = s + (i % 2 == 1 ? 4.0 : 2.0) * f(a + i * h);
+	}
+	return s * h / 3.0;
+}
+
+int main(int argc, char *argv[])
+{
+	double r = 0.0;
+	for (int n = 1000; n <= 16000; n = n * 2)
+	{
+		r = simpson(0.0, 3.0, n);
+	}
+	printf("%.17g\n", r);
+	return 0;
+}
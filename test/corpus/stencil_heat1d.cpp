@@ -0,0 +1,34 @@
+// explicit finite differences of the 1D heat equation with a reaction term
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define N 1000
+#define STEPS 400
+
+int main(int argc, char *argv[])
+{
+	double *u = (double *)malloc(N * sizeof(double));
+	double *v = (double *)malloc(N * sizeof(double));
+	for (int i = 0; i < N; i++)
+	{
+		u[i] = sin(M_PI * i / (N - 1));
+		v[i] = 0.0;
+	}
+	double c = 0.25;
+	double d = 0.5;
+	for (int s = 0; s < STEPS; s++)
+	{
+		for (int i = 1; i < N - 1; i++)
+		{
+			v[i] = u[i] + c * (u[i - 1] - 2.0 * u[i] + u[i + 1]) - d * 1e-3 * u[i] * u[i];
+		}
+		double *t = u;
+		u = v;
+		v = t;
+	}
+	printf("%.17g\n", u[N / 2]);
+	free(u);
+	free(v);
+	return 0;
+}
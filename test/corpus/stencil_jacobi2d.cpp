@@ -0,0 +1,40 @@
+// Jacobi iterations of the 2D Laplace equation with fixed boundary values
+#include <stdio.h>
+#include <math.h>
+
+#define N 64
+#define ITERS 100
+
+double a[N][N];
+double b[N][N];
+
+int main(int argc, char *argv[])
+{
+	for (int i = 0; i < N; i++)
+	{
+		for (int j = 0; j < N; j++)
+		{
+			a[i][j] = (i == 0) ? sin(M_PI * j / (N - 1)) : 0.0;
+			b[i][j] = a[i][j];
+		}
+	}
+	for (int t = 0; t < ITERS; t++)
+	{
+		for (int i = 1; i < N - 1; i++)
+		{
+			for (int j = 1; j < N - 1; j++)
+			{
+				b[i][j] = 0.25 * (a[i - 1][j] + a[i + 1][j] + a[i][j - 1] + a[i][j + 1]);
+			}
+		}
+		for (int i = 1; i < N - 1; i++)
+		{
+			for (int j = 1; j < N - 1; j++)
+			{
+				a[i][j] = b[i][j];
+			}
+		}
+	}
+	printf("%.17g\n", a[N / 2][N / 2]);
+	return 0;
+}
@@ -0,0 +1,20 @@
+// Kahan compensated summation of an alternating series
+#include <stdio.h>
+#include <math.h>
+
+int main(int argc, char *argv[])
+{
+	int n = 500000;
+	double sum = 0.0;
+	double c = 0.0;
+	for (int i = 0; i < n; i++)
+	{
+		double term = (i % 2 == 0 ? 1.0 : -1.0) / (2.0 * i + 1.0);
+		double y = term - c;
+		double t = sum + y;
+		c = (t - sum) - y;
+		sum = t;
+	}
+	printf("%.17g %.17g\n", 4.0 * sum, 4.0 * sum - M_PI);
+	return 0;
+}
@@ -0,0 +1,15 @@
+// recursive summation of a harmonic-like series in increasing order
+#include <stdio.h>
+#include <math.h>
+
+int main(int argc, char *argv[])
+{
+	int n = 1000000;
+	double sum = 0.0;
+	for (int i = 1; i <= n; i++)
+	{
+		sum = sum + 1.0 / ((double)i * (double)i);
+	}
+	printf("%.17g %.17g\n", sum, sum - M_PI * M_PI / 6.0);
+	return 0;
+}
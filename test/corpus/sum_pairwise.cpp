@@ -0,0 +1,37 @@
+// pairwise (cascade) summation of an array of mixed magnitudes
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+double pairwise(const double *x, int n)
+{
+	if (n <= 8)
+	{
+		double s = 0.0;
+		for (int i = 0; i < n; i++)
+		{
+			s = s + x[i];
+		}
+		return s;
+	}
+	int m = n / 2;
+	return pairwise(x, m) + pairwise(x + m, n - m);
+}
+
+int main(int argc, char *argv[])
+{
+	int n = 1 << 16;
+	double *x = (double *)malloc(n * sizeof(double));
+	for (int i = 0; i < n; i++)
+	{
+		x[i] = sin(i * 0.001) * pow(10.0, (i % 7) - 3);
+	}
+	double sum = 0.0;
+	for (int r = 0; r < 4; r++)
+	{
+		sum = sum + pairwise(x, n);
+	}
+	printf("%.17g\n", sum);
+	free(x);
+	return 0;
+}
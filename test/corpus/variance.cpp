@@ -0,0 +1,24 @@
+// one-pass (textbook) and Welford variance of data with a large mean
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+int main(int argc, char *argv[])
+{
+	int n = 200000;
+	double s = 0.0;
+	double s2 = 0.0;
+	double mean = 0.0;
+	double m2 = 0.0;
+	for (int i = 1; i <= n; i++)
+	{
+		double x = 1e8 + sin(i * 0.1);
+		s = s + x;
+		s2 = s2 + x * x;
+		double d = x - mean;
+		mean = mean + d / i;
+		m2 = m2 + d * (x - mean);
+	}
+	printf("%.17g %.17g\n", (s2 - s * s / n) / (n - 1), m2 / (n - 1));
+	return 0;
+}
@@ -0,0 +1,88 @@
+// embedded shadow slots of turnFpStruct -embedded-shadow in records that bypass constructors, see `make embeddedcheck`
+// the record and its accesses are written the way the tools emit them
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <real/EAST.h>
+
+#if !KEEP_ORIGINAL
+#error "native writes to fields are only detected with KEEP_ORIGINAL"
+#endif
+
+struct Particle
+{
+    double x;
+    double v[2];
+    EMBEDDED_SVAL(x);
+    EMBEDDED_ARR_SVAL(v, 2);
+    ~Particle() { // generated
+        FIELD_UNDEF(x);
+        FIELD_ARRUNDEF(v, 2);
+    }
+};
+
+static int failures = 0;
+
+static void expect(Particle &p, double x, const char *what)
+{
+    double sx = TO_DOUBLE(FIELD_SVAR(p, x).shadow->shadowValue);
+    double sv = TO_DOUBLE(FIELD_ARR_SVAR(p, v, 1).shadow->shadowValue);
+    if (sx != x || sv != x + 1)
+    {
+        failures++;
+        printf("FAILED %s: shadows %g %g of %g %g\n", what, sx, sv, x, x + 1);
+    }
+}
+
+static void write(Particle &p, double x)
+{
+    FIELD_SVAR(p, x) = x;
+    p.x = x;
+    FIELD_ARR_SVAR(p, v, 1) = x + 1;
+    p.v[1] = x + 1;
+}
+
+int main()
+{
+    Particle *p = (Particle *)malloc(sizeof(Particle));
+    p->x = 1, p->v[1] = 2;
+    expect(*p, 1, "malloc");
+    write(*p, 3);
+    expect(*p, 3, "write");
+
+    // freed without the destructor, reused by the next allocation of the same size
+    free(p);
+    Particle *q = (Particle *)malloc(sizeof(Particle));
+    q->x = 5, q->v[1] = 6;
+    expect(*q, 5, q == p ? "reuse" : "malloc after free");
+
+    Particle r = *q;
+    r.x = 7, r.v[1] = 8;
+    write(*q, 9);
+    expect(r, 7, "copy");
+    expect(*q, 9, "copied");
+
+    memcpy((void *)&r, q, sizeof(Particle)); // bitwise, the slots of r now claim the fields of q
+    expect(r, 9, "memcpy");
+    r.x = 11, r.v[1] = 12;
+    expect(r, 11, "memcpy and write");
+
+    // the record and the index of an access are evaluated once
+    Particle *ps[2] = {q, &r};
+    int i = 0, j = 0;
+    FIELD_SVAR(*ps[i++], x) = 13;
+    q->x = 13;
+    FIELD_ARR_SVAR(*ps[0], v, ++j) = 14;
+    q->v[1] = 14;
+    if (i != 1 || j != 1)
+    {
+        failures++;
+        printf("FAILED single evaluation: %d %d\n", i, j);
+    }
+    expect(*q, 13, "side effects");
+
+    q->~Particle();
+    free(q);
+    printf("%s: %d failures\n", failures == 0 ? "PASSED" : "FAILED", failures);
+    return failures != 0;
+}
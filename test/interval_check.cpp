@@ -0,0 +1,68 @@
+// outward rounding of the rigorous operations of IntervalMath.hpp, see `make intervalcheck`
+// the exact products of doubles fit in __float128, bounds are checked against them
+#include <stdio.h>
+#include <stdint.h>
+#include <random>
+#include <real/IntervalMath.hpp>
+
+using namespace real::interval;
+
+static int failures = 0;
+
+static void expect(bool ok, const char *op, double a, double b, double lo, double hi)
+{
+    if (!ok && failures++ < 20)
+        printf("FAILED %s(%a, %a) not in [%a, %a]\n", op, a, b, lo, hi);
+}
+
+static void check(double a, double b)
+{
+    if (std::isinf(a) || std::isinf(b))
+        return; // exact, and lo*b of the check is nan
+    __float128 p = (__float128)a * b;
+    double lo = mulDown(a, b), hi = mulUp(a, b);
+    expect(lo <= p && p <= hi, "mul", a, b, lo, hi);
+    if (b != 0)
+    {
+        // a/b in [lo, hi] is lo*b <= a <= hi*b for b > 0, reversed for b < 0
+        lo = divDown(a, b), hi = divUp(a, b);
+        __float128 l = (__float128)lo * b, h = (__float128)hi * b;
+        expect(b > 0 ? l <= a && a <= h : h <= a && a <= l, "div", a, b, lo, hi);
+    }
+    if (a >= 0)
+    {
+        lo = sqrtDown(a), hi = sqrtUp(a);
+        expect((__float128)lo * lo <= a && a <= (__float128)hi * hi, "sqrt", a, 0, lo, hi);
+    }
+}
+
+int main()
+{
+    // products, quotients and roots down to the subnormals and below
+    const double tiny[] = {0x1p-1074, 0x1.8p-1073, 0x1p-1022, 0x1.fffffffffffffp-1023, 0x1.3p-1000, 0x1p-969, 0x1.5p-537, 0x1p-53};
+    for (double a : tiny)
+    {
+        for (double b : tiny)
+        {
+            for (double s : {1.0, -1.0})
+            {
+                check(a, s * b);
+                check(a * 3, s * b * 0.7);
+                check(a, s / b);
+            }
+        }
+    }
+
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<int> exponent(-1074, 100);
+    std::uniform_real_distribution<double> mantissa(1, 2);
+    for (int i = 0; i < 1000000; i++)
+    {
+        double a = std::ldexp(mantissa(random), exponent(random) / 2);
+        double b = std::ldexp(mantissa(random), exponent(random) / 2 - 537);
+        check(i & 1 ? a : -a, i & 2 ? b : -b);
+    }
+
+    printf("%s: %d failures\n", failures == 0 ? "PASSED" : "FAILED", failures);
+    return failures != 0;
+}
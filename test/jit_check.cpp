@@ -0,0 +1,41 @@
+// shadow kernels of EAST_JIT sites compiled with SHADOW_JIT, see `make jitcheck`
+// a compiled site has to give the shadows and originals of the eager operators, bit for bit
+#include <stdio.h>
+#include <real/EAST.h>
+
+#if !SHADOW_JIT || PORT_TYPE != DD_PORT || !KEEP_ORIGINAL
+#error "build with SHADOW_JIT, DD_PORT and a mode that keeps originals"
+#endif
+
+static int failures = 0;
+
+static void expect(bool ok, const char *what, int i)
+{
+    if (!ok && failures++ < 20)
+        printf("FAILED %s at %d\n", what, i);
+}
+
+int main()
+{
+    // a*b + c*2 - (-a), as turnFpArith -jit emits it
+    std::vector<real::jit::Instruction> code = {{'l', 0}, {'l', 1}, {'*', 0}, {'l', 2}, {'d', 0}, {'*', 0},
+                                                {'+', 0}, {'l', 0}, {'n', 0}, {'-', 0}};
+    expect(real::jit::KernelCompiler::INSTANCE.compile(code) != nullptr, "compile", 0);
+
+    real::Real a = 0.1, b = 3.0, c = 1e-3, t, e;
+    for (int i = 0; i < 2 * SHADOW_JIT_THRESHOLD; i++)
+    {
+        PC(1);
+        EAST_JIT(t, "l0 l1 * l2 d0 * + l0 n -", JIT_LEAVES(a, b, c), JIT_DOUBLES(2.0));
+        PC(2);
+        e = a * b + c * 2.0 - (-a);
+        expect(t.shadow->shadowValue.x[0] == e.shadow->shadowValue.x[0] && t.shadow->shadowValue.x[1] == e.shadow->shadowValue.x[1], "shadow", i);
+        expect(t.shadow->originalValue == e.shadow->originalValue, "original", i);
+        // new operands every round, the first SHADOW_JIT_THRESHOLD rounds are interpreted
+        c = t * 1e-3;
+        a = a + 1e-17;
+    }
+
+    printf("%s: %d failures\n", failures == 0 ? "PASSED" : "FAILED", failures);
+    return failures != 0;
+}
@@ -0,0 +1,48 @@
+// sampled cycle profile of SHADOW_PROFILE in a loop whose body divides SHADOW_PROFILE_PERIOD, see `make profilecheck`
+// a fixed gap between timed statements times one of the two statements only, the other gets 0 ticks
+#include <stdio.h>
+#include <real/EAST.h>
+
+#if !SHADOW_PROFILE || SHADOW_PROFILE_PERIOD != 2
+#error "build with SHADOW_PROFILE and SHADOW_PROFILE_PERIOD=2"
+#endif
+
+static int failures = 0;
+
+static void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        failures++;
+        printf("FAILED %s\n", what);
+    }
+}
+
+int main()
+{
+    const int N = 100000;
+    real::Real x = 1.0, y = 0.5;
+    for (int i = 0; i < N; i++)
+    {
+        PC(1);
+        x = x * y + y; // 2 shadow operations
+        PC(2);
+        y = y * y - x / (y + 1.0); // 4 shadow operations
+    }
+    PC(0);
+
+    real::CycleProfile &p = real::CycleProfile::INSTANCE;
+    p.flush();
+    const real::CycleProfile::Record &a = p.records[1], &b = p.records[2];
+    printf("PC 1: %llu of %llu visits timed, %.0f ticks\n", (unsigned long long)a.timed, (unsigned long long)a.visits, p.estimate(a));
+    printf("PC 2: %llu of %llu visits timed, %.0f ticks\n", (unsigned long long)b.timed, (unsigned long long)b.visits, p.estimate(b));
+    expect(a.visits == N && b.visits == N, "visits");
+    expect(a.ops == 2 * N && b.ops == 4 * N, "ops");
+    // about N/2 timed visits each, a fixed gap times N visits of one and none of the other
+    expect(a.timed > N / 4 && a.timed < 3 * N / 4, "timed visits of PC 1");
+    expect(b.timed > N / 4 && b.timed < 3 * N / 4, "timed visits of PC 2");
+    expect(p.estimate(a) > 0 && p.estimate(b) > 0, "ticks of both statements");
+
+    printf("%s: %d failures\n", failures == 0 ? "PASSED" : "FAILED", failures);
+    return failures != 0;
+}
@@ -0,0 +1,84 @@
+// originals of a program computing in float and double with ORIGINAL_WIDTHS, see `make widthcheck`
+// the statements are written the way turnFpArith emits them, every original has to equal the program's value, bit for bit
+#include <stdio.h>
+#include <math.h>
+#include <real/EAST.h>
+
+#if !KEEP_ORIGINAL || !ORIGINAL_WIDTHS
+#error "build with ORIGINAL_WIDTHS and a mode that keeps originals"
+#endif
+
+static int failures = 0;
+
+template <typename T>
+static void expect(T &v, const char *what, int i = 0)
+{
+    const real::ShadowState &s = *SVAR(v).shadow;
+    bool single = std::is_same<T, float>::value;
+    if ((s.originalValue != (double)v || s.single != single) && failures++ < 20)
+        printf("FAILED %s at %d: original %.17g (%s) of %.17g (%s)\n", what, i, s.originalValue, s.single ? "float" : "double",
+               (double)v, single ? "float" : "double");
+}
+
+int main()
+{
+    float a = 0.1f, b = 3.3f, c;
+    double d = 0.1, e;
+
+    // float * float + float, rounded after every operation
+    c = a * b + a;
+    SVAR(c) = SVAR(a) * SVAR(b) + SVAR(a);
+    expect(c, "float expression");
+
+    // float * double is a double
+    e = a * d;
+    SVAR(e) = SVAR(a) * SVAR(d);
+    expect(e, "mixed expression");
+
+    // a double stored into a float
+    c = d / 3;
+    SVAR(c) = SVAR(d) / 3.0;
+    expect(c, "store into float");
+
+    // float accumulation with float constants
+    float s = 0;
+    SVAR(s) = 0.0;
+    for (int i = 0; i < 1000; i++)
+    {
+        s += a * i + 0.7f;
+        SVAR(s) += SVAR(a) * i + 0.7f;
+        expect(s, "float accumulation", i);
+    }
+
+    // float math functions call the float overloads
+    c = sinf(b) + sqrtf(a);
+    SVAR(c) = real::RealSin(SVAR(b)) + real::RealSqrt(SVAR(a));
+    expect(c, "float functions");
+
+    // the original of a fused shadow is unfused
+    float p = a * b;
+    c = p - s;
+    SVAR(c) = real::RealFms(SVAR(a), SVAR(b), SVAR(s));
+    expect(c, "fused");
+
+    // lazy trees
+    c = p + a;
+    real::lazy::assign(SVAR(c), real::lazy::view(SVAR(a)) * real::lazy::view(SVAR(b)) + real::lazy::view(SVAR(a)));
+    expect(c, "lazy tree");
+
+    // heap arrays of floats
+    const int N = 64;
+    float *x = DYNDEF<float>(N);
+    x[0] = 1;
+    SVAR(x[0]) = 1.0;
+    for (int i = 1; i < N; i++)
+    {
+        x[i] = x[i - 1] * 1.1f + a;
+        SVAR(x[i]) = SVAR(x[i - 1]) * 1.1f + SVAR(a);
+        expect(x[i], "float array", i);
+    }
+    DYNUNDEF(x);
+
+    printf("%s: %d failures\n", failures == 0 ? "PASSED" : "FAILED", failures);
+    return failures != 0;
+}